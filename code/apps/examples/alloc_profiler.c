@@ -0,0 +1,82 @@
+//
+// Runs a JSON and a CSV ingest through the allocation profiler, prints the per-site report
+// and writes folded stacks that can be rendered with e.g. `flamegraph.pl alloc.folded > alloc.svg`.
+//
+// Usage: alloc_profiler [output.folded]
+//
+#define ZPL_IMPLEMENTATION
+#define ZPL_NANO
+#define ZPL_ENABLE_PARSER
+#define ZPL_ENABLE_THREADING
+#define ZPL_PARSER_DISABLE_ANALYSIS
+#include <zpl.h>
+
+#define RECORDS 2000
+
+#if defined(ZPL_MODULE_THREADING)
+
+static void ingest_json(zpl_allocator a) {
+    zpl_alloc_profiler_push("ingest_json");
+
+    zpl_alloc_profiler_push("generate");
+    zpl_string text = zpl_string_make_reserve(a, 64);
+    text = zpl_string_appendc(text, "[\n");
+    for (int i = 0; i < RECORDS; ++i) {
+        text = zpl_string_append_fmt(text, "{\"id\": %d, \"name\": \"record %d\", \"tags\": [\"a\", \"b\", %d]}%s\n", i, i,
+                                     i % 7, i + 1 < RECORDS ? "," : "");
+    }
+    text = zpl_string_appendc(text, "]\n");
+    zpl_alloc_profiler_pop();
+
+    zpl_alloc_profiler_push_here();
+    zpl_json_object root = {0};
+    zpl_json_parse(&root, text, a);
+    zpl_json_free(&root);
+    zpl_alloc_profiler_pop();
+
+    zpl_string_free(text);
+    zpl_alloc_profiler_pop();
+}
+
+static void ingest_csv(zpl_allocator a) {
+    zpl_alloc_profiler_push("ingest_csv");
+
+    zpl_string text = zpl_string_make(a, "id,name,value\n");
+    for (int i = 0; i < RECORDS; ++i) {
+        text = zpl_string_append_fmt(text, "%d,row %d,%d.5\n", i, i, i * 3);
+    }
+
+    zpl_alloc_profiler_push_here();
+    zpl_csv_object root = {0};
+    zpl_csv_parse(&root, text, a, true);
+    zpl_csv_free(&root);
+    zpl_alloc_profiler_pop();
+
+    zpl_string_free(text);
+    zpl_alloc_profiler_pop();
+}
+
+int main(int argc, char **argv) {
+    zpl_alloc_profiler prof;
+    zpl_alloc_profiler_init(&prof, zpl_heap());
+
+    ingest_json(zpl_alloc_profiler_allocator(&prof));
+    ingest_csv(zpl_alloc_profiler_allocator(&prof));
+
+    zpl_alloc_profiler_report(&prof, ZPL_STDIO_OUT);
+
+    if (argc > 1) {
+        zpl_file out;
+        if (zpl_file_create(&out, argv[1]) == ZPL_FILE_ERROR_NONE) {
+            zpl_alloc_profiler_write_folded(&prof, &out, ZPL_ALLOC_PROFILER_BYTES);
+            zpl_file_close(&out);
+            zpl_printf("\nfolded stacks written to %s\n", argv[1]);
+        }
+    }
+
+    zpl_alloc_profiler_free(&prof);
+    return 0;
+}
+#else
+int main(){return 0;}
+#endif
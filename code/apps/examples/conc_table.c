@@ -0,0 +1,134 @@
+#define ZPL_IMPLEMENTATION
+#define ZPL_NANO
+#define ZPL_ENABLE_THREADING
+#include <zpl.h>
+
+// Usage: conc_table [max threads]
+// Read-scaling benchmark of ZPL_CONC_TABLE against a ZPL_TABLE guarded by one zpl_mutex.
+
+#define KEYS (1 << 16)
+#define OPS_PER_THREAD (1 << 18)
+
+#if defined(ZPL_MODULE_THREADING)
+
+ZPL_TABLE(static, locked_tbl, locked_tbl_, zpl_u64);
+ZPL_CONC_TABLE(static, conc_tbl, conc_tbl_, zpl_u64);
+
+typedef struct {
+    zpl_mutex lock;
+    locked_tbl table;
+} locked_map;
+
+typedef struct {
+    locked_map *locked;
+    conc_tbl *conc;
+    zpl_u32 write_every; // 0 means read-only
+    zpl_u64 seed;
+    zpl_u64 hits;
+} bench_info;
+
+zpl_global zpl_atomic32 start_flag;
+
+static zpl_u64 next_key(zpl_u64 *state) {
+    *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+    return (*state >> 33) & (KEYS - 1);
+}
+
+zpl_isize locked_entry(zpl_thread *thread) {
+    bench_info *info = (bench_info *)thread->user_data;
+    while (!zpl_atomic32_load(&start_flag)) zpl_yield_thread();
+
+    for (zpl_u32 i = 0; i < OPS_PER_THREAD; ++i) {
+        zpl_u64 key = next_key(&info->seed);
+        zpl_mutex_lock(&info->locked->lock);
+        if (info->write_every && i % info->write_every == 0) {
+            locked_tbl_set(&info->locked->table, key, i);
+        } else {
+            info->hits += locked_tbl_get(&info->locked->table, key) != NULL;
+        }
+        zpl_mutex_unlock(&info->locked->lock);
+    }
+    return 0;
+}
+
+zpl_isize conc_entry(zpl_thread *thread) {
+    bench_info *info = (bench_info *)thread->user_data;
+    zpl_u64 value;
+    while (!zpl_atomic32_load(&start_flag)) zpl_yield_thread();
+
+    for (zpl_u32 i = 0; i < OPS_PER_THREAD; ++i) {
+        zpl_u64 key = next_key(&info->seed);
+        if (info->write_every && i % info->write_every == 0) {
+            conc_tbl_set(info->conc, key, i);
+        } else {
+            info->hits += conc_tbl_get(info->conc, key, &value);
+        }
+    }
+    return 0;
+}
+
+static zpl_f64 run(zpl_thread_proc proc, zpl_u32 threads, locked_map *locked, conc_tbl *conc, zpl_u32 write_every) {
+    zpl_thread *workers = (zpl_thread *)zpl_alloc(zpl_heap(), threads * zpl_size_of(zpl_thread));
+    bench_info *infos = (bench_info *)zpl_alloc(zpl_heap(), threads * zpl_size_of(bench_info));
+    zpl_f64 start, elapsed;
+
+    zpl_atomic32_store(&start_flag, 0);
+    for (zpl_u32 i = 0; i < threads; ++i) {
+        infos[i].locked = locked;
+        infos[i].conc = conc;
+        infos[i].write_every = write_every;
+        infos[i].seed = i + 1;
+        infos[i].hits = 0;
+        zpl_thread_init(&workers[i]);
+        zpl_thread_start(&workers[i], proc, &infos[i]);
+    }
+
+    start = zpl_time_rel();
+    zpl_atomic32_store(&start_flag, 1);
+    for (zpl_u32 i = 0; i < threads; ++i) {
+        zpl_thread_destroy(&workers[i]);
+        ZPL_ASSERT(write_every || infos[i].hits == OPS_PER_THREAD);
+    }
+    elapsed = zpl_time_rel() - start;
+
+    zpl_free(zpl_heap(), workers);
+    zpl_free(zpl_heap(), infos);
+    return (zpl_f64)threads * OPS_PER_THREAD / elapsed / 1e6;
+}
+
+int main(int argc, char **argv) {
+    zpl_u32 max_threads = 64;
+    locked_map locked;
+    conc_tbl conc;
+
+    if (argc > 1) {
+        max_threads = (zpl_u32)zpl_str_to_u64(argv[1], NULL, 10);
+    }
+
+    zpl_mutex_init(&locked.lock);
+    locked_tbl_init(&locked.table, zpl_heap());
+    conc_tbl_init(&conc, zpl_heap());
+    for (zpl_u64 i = 0; i < KEYS; ++i) {
+        locked_tbl_set(&locked.table, i, i);
+        conc_tbl_set(&conc, i, i);
+    }
+
+    zpl_printf("%d keys, %d operations per thread, throughput in Mops/s.\n\n", KEYS, OPS_PER_THREAD);
+    zpl_printf("%-8s %14s %14s %14s %14s\n", "threads", "mutex read", "sharded read", "mutex 5% set", "sharded 5% set");
+
+    for (zpl_u32 threads = 1; threads <= max_threads; threads *= 2) {
+        zpl_f64 locked_read = run(locked_entry, threads, &locked, &conc, 0);
+        zpl_f64 conc_read = run(conc_entry, threads, &locked, &conc, 0);
+        zpl_f64 locked_mixed = run(locked_entry, threads, &locked, &conc, 20);
+        zpl_f64 conc_mixed = run(conc_entry, threads, &locked, &conc, 20);
+        zpl_printf("%-8d %14.2f %14.2f %14.2f %14.2f\n", threads, locked_read, conc_read, locked_mixed, conc_mixed);
+    }
+
+    locked_tbl_destroy(&locked.table);
+    zpl_mutex_destroy(&locked.lock);
+    conc_tbl_destroy(&conc);
+    return 0;
+}
+#else
+int main(){return 0;}
+#endif
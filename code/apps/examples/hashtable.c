@@ -31,6 +31,86 @@ void print_names(zpl_u64 key, user value) {
     zpl_printf("key: %lld val: %s\n", key, value.name);
 }
 
+// NOTE: Benchmark of the chained ZPL_TABLE against the open-addressing ZPL_FLAT_TABLE
+ZPL_TABLE(static, bench_tbl, bench_tbl_, zpl_u64);
+ZPL_FLAT_TABLE(static, bench_flat, bench_flat_, zpl_u64);
+
+#define BENCH_ITEMS (1 << 20)
+
+// NOTE: Visit keys in a scrambled order, otherwise ZPL_TABLE walks its entries array sequentially on hits
+#define BENCH_ORDER(i) (((i) * 0x9e3779b1ull) & (BENCH_ITEMS - 1))
+
+static zpl_u64 bench_key(zpl_u64 i) {
+    // NOTE: splitmix64, keys are random but reproducible
+    zpl_u64 z = (i + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static void bench_report(char const *name, zpl_isize ops, zpl_f64 chained, zpl_f64 flat) {
+    zpl_printf("%-16s ZPL_TABLE: %8.2f ns/op  ZPL_FLAT_TABLE: %8.2f ns/op  (%.2fx)\n", name,
+               chained * 1e9 / ops, flat * 1e9 / ops, chained / flat);
+}
+
+static void benchmark(void) {
+    bench_tbl chained;
+    bench_flat flat;
+    zpl_u64 sum = 0;
+    zpl_f64 t, chained_t, flat_t;
+
+    zpl_printf("\nBenchmark with %d random keys:\n", BENCH_ITEMS);
+    bench_tbl_init(&chained, zpl_heap());
+    bench_flat_init(&flat, zpl_heap());
+
+    t = zpl_time_rel();
+    for (zpl_u64 i = 0; i < BENCH_ITEMS; ++i) bench_tbl_set(&chained, bench_key(i), i);
+    chained_t = zpl_time_rel() - t;
+    t = zpl_time_rel();
+    for (zpl_u64 i = 0; i < BENCH_ITEMS; ++i) bench_flat_set(&flat, bench_key(i), i);
+    flat_t = zpl_time_rel() - t;
+    bench_report("insert", BENCH_ITEMS, chained_t, flat_t);
+
+    t = zpl_time_rel();
+    for (zpl_u64 i = 0; i < BENCH_ITEMS; ++i) sum += *bench_tbl_get(&chained, bench_key(BENCH_ORDER(i)));
+    chained_t = zpl_time_rel() - t;
+    t = zpl_time_rel();
+    for (zpl_u64 i = 0; i < BENCH_ITEMS; ++i) sum -= *bench_flat_get(&flat, bench_key(BENCH_ORDER(i)));
+    flat_t = zpl_time_rel() - t;
+    bench_report("lookup hit", BENCH_ITEMS, chained_t, flat_t);
+    ZPL_ASSERT(sum == 0);
+
+    t = zpl_time_rel();
+    for (zpl_u64 i = 0; i < BENCH_ITEMS; ++i) sum += bench_tbl_get(&chained, bench_key(i + BENCH_ITEMS)) != NULL;
+    chained_t = zpl_time_rel() - t;
+    t = zpl_time_rel();
+    for (zpl_u64 i = 0; i < BENCH_ITEMS; ++i) sum += bench_flat_get(&flat, bench_key(i + BENCH_ITEMS)) != NULL;
+    flat_t = zpl_time_rel() - t;
+    bench_report("lookup miss", BENCH_ITEMS, chained_t, flat_t);
+    ZPL_ASSERT(sum == 0);
+
+    t = zpl_time_rel();
+    for (zpl_u64 i = 0; i < BENCH_ITEMS; ++i) bench_tbl_remove(&chained, bench_key(BENCH_ORDER(i)));
+    chained_t = zpl_time_rel() - t;
+    t = zpl_time_rel();
+    for (zpl_u64 i = 0; i < BENCH_ITEMS; ++i) bench_flat_remove(&flat, bench_key(BENCH_ORDER(i)));
+    flat_t = zpl_time_rel() - t;
+    bench_report("remove", BENCH_ITEMS, chained_t, flat_t);
+
+    t = zpl_time_rel();
+    bench_tbl_reserve(&chained, BENCH_ITEMS);
+    for (zpl_u64 i = 0; i < BENCH_ITEMS; ++i) bench_tbl_set(&chained, bench_key(i), i);
+    chained_t = zpl_time_rel() - t;
+    t = zpl_time_rel();
+    bench_flat_reserve(&flat, BENCH_ITEMS);
+    for (zpl_u64 i = 0; i < BENCH_ITEMS; ++i) bench_flat_set(&flat, bench_key(i), i);
+    flat_t = zpl_time_rel() - t;
+    bench_report("reserved insert", BENCH_ITEMS, chained_t, flat_t);
+
+    bench_tbl_destroy(&chained);
+    bench_flat_destroy(&flat);
+}
+
 int
 main(void) {
 
@@ -71,5 +151,7 @@ main(void) {
 
     tbl_user_destroy(&users);
 
+    benchmark();
+
     return 0;
 }
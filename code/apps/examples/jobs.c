@@ -5,6 +5,8 @@
 // #define ZPL_ENFORCE_THREADING
 #include <zpl.h>
 
+// Usage: jobs [workers] [dispatch|steal|submit] [max producers]
+
 int rand(void);
 
 #define N (60 * 1000)
@@ -30,22 +32,107 @@ const char *levels[] = {
     "IDLE",
 };
 
+#define SUBMIT_JOBS (1000 * 1000)
+#define SUBMIT_BATCH 64
+
+typedef struct {
+    zpl_jobs_system *pool;
+    zpl_u32 jobs;
+    zpl_b32 batched;
+} producer_info;
+
+zpl_isize producer_entry(zpl_thread *thread) {
+    producer_info *info = (producer_info *)thread->user_data;
+    zpl_thread_job batch[SUBMIT_BATCH] = {0};
+    zpl_u32 submitted = 0;
+
+    for (int i = 0; i < SUBMIT_BATCH; ++i) {
+        batch[i].proc = do_work;
+        batch[i].data = NULL;
+    }
+
+    while (submitted < info->jobs) {
+        if (info->batched) {
+            zpl_u32 count = zpl_min(SUBMIT_BATCH, info->jobs - submitted);
+            zpl_u32 pushed = zpl_jobs_enqueue_batch(info->pool, batch, count, ZPL_JOBS_PRIORITY_NORMAL);
+            if (pushed == 0) zpl_yield();
+            submitted += pushed;
+        } else {
+            if (zpl_jobs_enqueue(info->pool, do_work, NULL)) ++submitted;
+            else zpl_yield();
+        }
+    }
+
+    return 0;
+}
+
+// NOTE: Measures how fast 1..max_producers threads can push jobs into a work-stealing pool.
+void submit_bench(zpl_u32 num_cores, zpl_u32 max_producers) {
+    zpl_printf("Submission benchmark, %d jobs per run, %d workers.\n\n", SUBMIT_JOBS, num_cores);
+    zpl_printf("%-10s %-8s %16s %16s\n", "producers", "mode", "submit (jobs/s)", "total (jobs/s)");
+
+    for (zpl_u32 producers = 1; producers <= max_producers; ++producers) {
+        for (int batched = 0; batched < 2; ++batched) {
+            zpl_jobs_system p = {0};
+            zpl_thread *threads = (zpl_thread *)zpl_alloc(zpl_heap(), producers * zpl_size_of(zpl_thread));
+            producer_info *infos = (producer_info *)zpl_alloc(zpl_heap(), producers * zpl_size_of(producer_info));
+
+            zpl_jobs_init_with_flags(&p, zpl_heap(), num_cores, NL, ZPL_JOBS_FLAG_WORK_STEALING);
+            zpl_atomic32_store(&total_jobs, 0);
+
+            zpl_f64 start = zpl_time_rel();
+            for (zpl_u32 i = 0; i < producers; ++i) {
+                infos[i].pool = &p;
+                infos[i].jobs = SUBMIT_JOBS / producers + (i == 0 ? SUBMIT_JOBS % producers : 0);
+                infos[i].batched = batched;
+                zpl_thread_init(&threads[i]);
+                zpl_thread_start(&threads[i], producer_entry, &infos[i]);
+            }
+            for (zpl_u32 i = 0; i < producers; ++i) {
+                zpl_thread_destroy(&threads[i]);
+            }
+            zpl_f64 submitted = zpl_time_rel();
+
+            while (!zpl_jobs_done(&p)) zpl_yield();
+            zpl_f64 finished = zpl_time_rel();
+
+            ZPL_ASSERT(zpl_atomic32_load(&total_jobs) == SUBMIT_JOBS);
+            zpl_printf("%-10d %-8s %16.0f %16.0f\n", producers, batched ? "batch" : "single",
+                       SUBMIT_JOBS / (submitted - start), SUBMIT_JOBS / (finished - start));
+
+            zpl_jobs_free(&p);
+            zpl_free(zpl_heap(), threads);
+            zpl_free(zpl_heap(), infos);
+        }
+    }
+}
+
 int main(int argc, char **argv) {
     zpl_affinity af;
     zpl_affinity_init(&af);
     zpl_u32 num_cores = af.thread_count;
+    zpl_u32 flags = 0;
     if (argc > 1) {
         num_cores = zpl_str_to_u64(argv[1], NULL, 10);
     }
+    if (argc > 2 && !zpl_strcmp(argv[2], "steal")) {
+        flags |= ZPL_JOBS_FLAG_WORK_STEALING;
+    }
+    if (argc > 2 && !zpl_strcmp(argv[2], "submit")) {
+        submit_bench(num_cores, argc > 3 ? (zpl_u32)zpl_str_to_u64(argv[3], NULL, 10) : af.thread_count);
+        zpl_affinity_destroy(&af);
+        return 0;
+    }
     zpl_affinity_destroy(&af);
     zpl_jobs_system p={0};
-    zpl_jobs_init_with_limit(&p, zpl_heap(), num_cores, NL);
+    zpl_jobs_init_with_flags(&p, zpl_heap(), num_cores, NL, flags);
     zpl_u64 process_time = 0;
     zpl_f64 avg_delta_time = 0;
     zpl_atomic32_store(&total_jobs, 0);
     counter = N;
 
-    zpl_printf("Jobs test, run duration: %d ms. Ran on %d cores.\nWe spawn %d jobs per cycle.\n", N, num_cores, NL);
+    zpl_printf("Jobs test, run duration: %d ms. Ran on %d cores (%s).\nWe spawn %d jobs per cycle.\n", N, num_cores,
+               (flags & ZPL_JOBS_FLAG_WORK_STEALING) ? "work-stealing" : "dispatch", NL);
 
     while (counter > 0) {
         zpl_u64 last_time = zpl_time_rel_ms();
@@ -80,7 +167,8 @@ int main(int argc, char **argv) {
     zpl_printf("\nPer thread worker stats:\n");
     for (zpl_usize i = 0; i < p.max_threads; ++i) {
         zpl_thread_worker *tw = p.workers + i;
-        zpl_printf("* worker %-2u hits: %-8d idle: %lld cy.\n", (unsigned int)i, tw->hits, tw->idle);
+        zpl_printf("* worker %-2u hits: %-8d idle: %-8d cy. steals: %-8d parks: %-6d unparks: %d.\n", (unsigned int)i,
+                   tw->hits, tw->idle, tw->steals, tw->parks, zpl_atomic32_load(&tw->unparks));
     }
     zpl_jobs_free(&p);
     return 0;
@@ -0,0 +1,139 @@
+#define ZPL_IMPLEMENTATION
+#define ZPL_NANO
+#define ZPL_ENABLE_JOBS
+#include <zpl.h>
+
+// Usage: jobs_parallel [workers] [pin]
+// Compares zpl_jobs_parallel_for/reduce against a serial loop for a memory-bound and a compute-bound kernel.
+
+#define MEM_ITEMS (16 * 1024 * 1024)
+#define CPU_ITEMS (256 * 1024)
+#define CPU_ROUNDS 256
+#define RUNS 5
+
+#if defined(ZPL_MODULE_THREADING)
+
+typedef struct {
+    zpl_f32 *a, *b, *c;
+} mem_data;
+
+void mem_kernel(void *data, zpl_isize begin, zpl_isize end) {
+    mem_data *d = (mem_data *)data;
+    for (zpl_isize i = begin; i < end; ++i) {
+        d->c[i] = d->a[i] + 0.5f * d->b[i];
+    }
+}
+
+void mem_sum(void *data, zpl_isize begin, zpl_isize end, void *partial) {
+    mem_data *d = (mem_data *)data;
+    zpl_f64 sum = 0.0;
+    for (zpl_isize i = begin; i < end; ++i) {
+        sum += d->c[i];
+    }
+    *(zpl_f64 *)partial += sum;
+}
+
+void cpu_kernel(void *data, zpl_isize begin, zpl_isize end) {
+    zpl_f32 *out = (zpl_f32 *)data;
+    for (zpl_isize i = begin; i < end; ++i) {
+        zpl_f32 x = (zpl_f32)i * 0.0001f;
+        for (int r = 0; r < CPU_ROUNDS; ++r) {
+            x = x * 0.999f + 0.001f * (x * x - x * x * x * 0.1f);
+        }
+        out[i] = x;
+    }
+}
+
+void cpu_sum(void *data, zpl_isize begin, zpl_isize end, void *partial) {
+    zpl_f32 *out = (zpl_f32 *)data;
+    cpu_kernel(data, begin, end);
+    zpl_f64 sum = 0.0;
+    for (zpl_isize i = begin; i < end; ++i) {
+        sum += out[i];
+    }
+    *(zpl_f64 *)partial += sum;
+}
+
+void sum_combine(void *data, void *result, void const *partial) {
+    zpl_unused(data);
+    *(zpl_f64 *)result += *(zpl_f64 const *)partial;
+}
+
+void report(char const *name, zpl_f64 serial, zpl_f64 parallel) {
+    zpl_printf("%-24s serial: %8.3f ms  parallel: %8.3f ms  speedup: %5.2fx\n", name, serial * 1000.0, parallel * 1000.0, serial / parallel);
+}
+
+int main(int argc, char **argv) {
+    zpl_affinity af;
+    zpl_affinity_init(&af);
+    zpl_u32 num_workers = (zpl_u32)af.thread_count - 1;
+    zpl_u32 flags = ZPL_JOBS_FLAG_WORK_STEALING;
+    if (argc > 1) {
+        num_workers = (zpl_u32)zpl_str_to_u64(argv[1], NULL, 10);
+    }
+    if (argc > 2 && !zpl_strcmp(argv[2], "pin")) {
+        flags |= ZPL_JOBS_FLAG_PIN_WORKERS;
+    }
+    zpl_printf("%td physical cores, %td hardware threads%s\n", af.core_count, af.thread_count, af.is_accurate ? "" : " (estimated)");
+    zpl_affinity_destroy(&af);
+
+    zpl_jobs_system pool = {0};
+    zpl_jobs_init_with_flags(&pool, zpl_heap(), num_workers, 256, flags);
+
+    mem_data md;
+    md.a = (zpl_f32 *)zpl_alloc(zpl_heap(), MEM_ITEMS * zpl_size_of(zpl_f32));
+    md.b = (zpl_f32 *)zpl_alloc(zpl_heap(), MEM_ITEMS * zpl_size_of(zpl_f32));
+    md.c = (zpl_f32 *)zpl_alloc(zpl_heap(), MEM_ITEMS * zpl_size_of(zpl_f32));
+    zpl_f32 *cpu_out = (zpl_f32 *)zpl_alloc(zpl_heap(), CPU_ITEMS * zpl_size_of(zpl_f32));
+
+    for (zpl_isize i = 0; i < MEM_ITEMS; ++i) {
+        md.a[i] = (zpl_f32)(i & 1023);
+        md.b[i] = (zpl_f32)(i & 511);
+    }
+
+    zpl_printf("Parallel loop benchmark, %d %sworkers + calling thread, best of %d runs.\n\n", num_workers, (flags & ZPL_JOBS_FLAG_PIN_WORKERS) ? "pinned " : "", RUNS);
+
+    zpl_f64 serial = 1e9, parallel = 1e9, t;
+    zpl_f64 serial_sum = 0.0, parallel_sum = 0.0;
+
+    for (int run = 0; run < RUNS; ++run) {
+        t = zpl_time_rel(); mem_kernel(&md, 0, MEM_ITEMS); serial = zpl_min(serial, zpl_time_rel() - t);
+        t = zpl_time_rel(); zpl_jobs_parallel_for(&pool, 0, MEM_ITEMS, 0, mem_kernel, &md); parallel = zpl_min(parallel, zpl_time_rel() - t);
+    }
+    report("memory-bound for", serial, parallel);
+
+    serial = parallel = 1e9;
+    for (int run = 0; run < RUNS; ++run) {
+        serial_sum = parallel_sum = 0.0;
+        t = zpl_time_rel(); mem_sum(&md, 0, MEM_ITEMS, &serial_sum); serial = zpl_min(serial, zpl_time_rel() - t);
+        t = zpl_time_rel(); zpl_jobs_parallel_reduce(&pool, 0, MEM_ITEMS, 0, mem_sum, sum_combine, &md, &parallel_sum, zpl_size_of(zpl_f64)); parallel = zpl_min(parallel, zpl_time_rel() - t);
+    }
+    report("memory-bound reduce", serial, parallel);
+    zpl_printf("%-24s serial: %.1f parallel: %.1f\n", "", serial_sum, parallel_sum);
+
+    serial = parallel = 1e9;
+    for (int run = 0; run < RUNS; ++run) {
+        t = zpl_time_rel(); cpu_kernel(cpu_out, 0, CPU_ITEMS); serial = zpl_min(serial, zpl_time_rel() - t);
+        t = zpl_time_rel(); zpl_jobs_parallel_for(&pool, 0, CPU_ITEMS, 0, cpu_kernel, cpu_out); parallel = zpl_min(parallel, zpl_time_rel() - t);
+    }
+    report("compute-bound for", serial, parallel);
+
+    serial = parallel = 1e9;
+    for (int run = 0; run < RUNS; ++run) {
+        serial_sum = parallel_sum = 0.0;
+        t = zpl_time_rel(); cpu_sum(cpu_out, 0, CPU_ITEMS, &serial_sum); serial = zpl_min(serial, zpl_time_rel() - t);
+        t = zpl_time_rel(); zpl_jobs_parallel_reduce(&pool, 0, CPU_ITEMS, 0, cpu_sum, sum_combine, cpu_out, &parallel_sum, zpl_size_of(zpl_f64)); parallel = zpl_min(parallel, zpl_time_rel() - t);
+    }
+    report("compute-bound reduce", serial, parallel);
+    zpl_printf("%-24s serial: %.3f parallel: %.3f\n", "", serial_sum, parallel_sum);
+
+    zpl_jobs_free(&pool);
+    zpl_free(zpl_heap(), md.a);
+    zpl_free(zpl_heap(), md.b);
+    zpl_free(zpl_heap(), md.c);
+    zpl_free(zpl_heap(), cpu_out);
+    return 0;
+}
+#else
+int main(){return 0;}
+#endif
@@ -45,6 +45,7 @@ int main(int argc, char **argv) {
     err = zpl_json_parse(&root, (char *)fc.data, zpl_heap());
     zpl_f64 delta = zpl_time_rel() - time;
     zpl_printf("Delta: %fms\nNo. of nodes: %td\nError code: %d\nFile size: %td bytes\n", delta*1000, zpl_array_count(root.nodes), err, fc.size);
+    if (delta > 0) zpl_printf("Throughput: %.1f MB/s\n", fc.size / delta / 1e6);
 
     zpl_json_free(&root);
     zpl_file_free_contents(&fc);
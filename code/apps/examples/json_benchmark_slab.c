@@ -0,0 +1,130 @@
+//
+// Compares zpl_heap() and the slab allocator on the ADT/JSON allocation pattern: lots of small nodes and arrays
+// allocated while parsing and freed all at once afterwards.
+//
+// Usage: json_benchmark_slab [max threads] [file]
+// Without a file a jeopardy.json-like document is generated in memory.
+//
+#define ZPL_IMPLEMENTATION
+#define ZPL_NANO
+#define ZPL_ENABLE_PARSER
+#define ZPL_ENABLE_THREADING
+#define ZPL_PARSER_DISABLE_ANALYSIS
+#include <zpl.h>
+
+#define RECORDS 20000
+#define ITERATIONS 8
+
+#if defined(ZPL_MODULE_THREADING)
+
+typedef struct {
+    zpl_allocator allocator;
+    zpl_slab *slab;
+    char const *text;
+    zpl_isize size;
+    zpl_isize nodes;
+} bench_info;
+
+zpl_global zpl_atomic32 start_flag;
+
+zpl_isize parse_entry(zpl_thread *thread) {
+    bench_info *info = (bench_info *)thread->user_data;
+    char *copy = (char *)zpl_malloc(info->size + 1);
+    while (!zpl_atomic32_load(&start_flag)) zpl_yield_thread();
+
+    for (int i = 0; i < ITERATIONS; ++i) {
+        zpl_json_object root = {0};
+        zpl_memcopy(copy, info->text, info->size + 1);
+        zpl_json_parse(&root, copy, info->allocator);
+        info->nodes = zpl_array_count(root.nodes);
+        zpl_json_free(&root);
+    }
+
+    // NOTE: Let the next round of threads adopt this thread's cache
+    if (info->slab) zpl_slab_thread_detach(info->slab);
+    zpl_mfree(copy);
+    return 0;
+}
+
+static zpl_f64 run(zpl_allocator allocator, zpl_slab *slab, zpl_u32 threads, char const *text, zpl_isize size) {
+    zpl_thread *workers = (zpl_thread *)zpl_malloc(threads * zpl_size_of(zpl_thread));
+    bench_info *infos = (bench_info *)zpl_malloc(threads * zpl_size_of(bench_info));
+    zpl_f64 start, elapsed;
+
+    zpl_atomic32_store(&start_flag, 0);
+    for (zpl_u32 i = 0; i < threads; ++i) {
+        infos[i].allocator = allocator;
+        infos[i].slab = slab;
+        infos[i].text = text;
+        infos[i].size = size;
+        infos[i].nodes = 0;
+        zpl_thread_init(&workers[i]);
+        zpl_thread_start(&workers[i], parse_entry, &infos[i]);
+    }
+
+    start = zpl_time_rel();
+    zpl_atomic32_store(&start_flag, 1);
+    for (zpl_u32 i = 0; i < threads; ++i) {
+        zpl_thread_destroy(&workers[i]);
+        ZPL_ASSERT(infos[i].nodes > 0);
+    }
+    elapsed = zpl_time_rel() - start;
+
+    zpl_mfree(workers);
+    zpl_mfree(infos);
+    return (zpl_f64)threads * ITERATIONS * size / elapsed / (1024.0 * 1024.0);
+}
+
+static char *generate(zpl_isize *size) {
+    zpl_string text = zpl_string_make_reserve(zpl_heap(), RECORDS * 200);
+    text = zpl_string_appendc(text, "[\n");
+    for (int i = 0; i < RECORDS; ++i) {
+        text = zpl_string_append_fmt(text,
+            "{\"category\": \"HISTORY %d\", \"air_date\": \"2004-12-31\", \"question\": \"'For the last %d years of his life, "
+            "Galileo was under house arrest for espousing this man's theory'\", \"value\": \"$%d\", \"answer\": \"Copernicus\", "
+            "\"round\": \"Jeopardy!\", \"show_number\": \"%d\"}%s\n", i % 97, i % 13, (i % 5 + 1) * 200, 4680 + i % 300,
+            i + 1 < RECORDS ? "," : "");
+    }
+    text = zpl_string_appendc(text, "]\n");
+    *size = zpl_string_length(text);
+    return text;
+}
+
+int main(int argc, char **argv) {
+    zpl_u32 max_threads = 4;
+    zpl_file_contents fc = {0};
+    char *text;
+    zpl_isize size;
+    zpl_slab slab;
+
+    if (argc > 1) {
+        max_threads = (zpl_u32)zpl_str_to_u64(argv[1], NULL, 10);
+    }
+
+    if (argc > 2) {
+        fc = zpl_file_read_contents(zpl_heap(), true, argv[2]);
+        text = (char *)fc.data;
+        size = fc.size;
+    } else {
+        text = generate(&size);
+    }
+
+    zpl_slab_init(&slab, zpl_heap());
+
+    zpl_printf("%td bytes parsed %d times per thread, throughput in MiB/s.\n\n", size, ITERATIONS);
+    zpl_printf("%-8s %12s %12s\n", "threads", "heap", "slab");
+
+    for (zpl_u32 threads = 1; threads <= max_threads; threads *= 2) {
+        zpl_f64 heap = run(zpl_heap(), NULL, threads, text, size);
+        zpl_f64 slabs = run(zpl_slab_allocator(&slab), &slab, threads, text, size);
+        zpl_printf("%-8d %12.2f %12.2f\n", threads, heap, slabs);
+    }
+
+    zpl_slab_free(&slab);
+    if (fc.data) zpl_file_free_contents(&fc);
+    else zpl_string_free(text);
+    return 0;
+}
+#else
+int main(){return 0;}
+#endif
@@ -0,0 +1,62 @@
+//
+// Reads a few fields through the lazy cursor, without building the ADT tree.
+// Pass a JSON file and a path (e.g. `json_cursor jeopardy.json 1000/question`) to compare against a full parse.
+//
+#define ZPL_IMPLEMENTATION
+#define ZPL_NANO
+#define ZPL_ENABLE_PARSER
+#include <zpl.h>
+
+int main(int argc, char **argv) {
+    zpl_file_contents fc;
+
+    if (argc > 2) {
+        fc = zpl_file_read_contents(zpl_heap(), true, argv[1]);
+
+        zpl_f64 time = zpl_time_rel();
+        zpl_json_cursor root = zpl_json_cursor_make(cast(char const *)fc.data, fc.size);
+        zpl_json_cursor node = zpl_json_cursor_query(&root, argv[2]);
+        zpl_isize len;
+        char const *raw = zpl_json_cursor_raw(&node, &len);
+        zpl_f64 cursor_delta = zpl_time_rel() - time;
+
+        zpl_printf("%.*s\n", cast(int)zpl_min(len, 256), raw ? raw : "(not found)");
+
+        time = zpl_time_rel();
+        zpl_json_object doc = {0};
+        zpl_json_parse(&doc, cast(char *)fc.data, zpl_heap());
+        zpl_adt_query(&doc, argv[2]);
+        zpl_f64 parse_delta = zpl_time_rel() - time;
+        zpl_json_free(&doc);
+
+        zpl_printf("Cursor: %fms\nFull parse: %fms\n", cursor_delta * 1000, parse_delta * 1000);
+        zpl_file_free_contents(&fc);
+        return 0;
+    }
+
+    fc = zpl_file_read_contents(zpl_heap(), false, "misc/data/glsl_diffuse.json5");
+    zpl_json_cursor root = zpl_json_cursor_make(cast(char const *)fc.data, fc.size);
+
+    zpl_json_cursor layer3 = zpl_json_cursor_query(&root, "layer1/layer2/layer3");
+    ZPL_ASSERT(zpl_json_cursor_integer(&layer3, 0) == 42);
+
+    zpl_json_cursor def_value = zpl_json_cursor_query(&root, "uniforms/2/layout/1/default_value");
+    ZPL_ASSERT(zpl_json_cursor_integer(&def_value, 0) == 42);
+
+    zpl_json_cursor array = zpl_json_cursor_find(&root, "array"), it;
+    ZPL_ASSERT(zpl_json_cursor_count(&array) == 10);
+
+    zpl_i64 sum = 0;
+    if (zpl_json_cursor_first(&array, &it)) {
+        do { sum += zpl_json_cursor_integer(&it, 0); } while (zpl_json_cursor_next(&it));
+    }
+    ZPL_ASSERT(sum == 55);
+
+    zpl_json_cursor name = zpl_json_cursor_find(&root, "name");
+    zpl_isize len;
+    char const *str = zpl_json_cursor_str(&name, &len);
+    zpl_printf("name: %.*s\n", cast(int)len, str);
+
+    zpl_file_free_contents(&fc);
+    return 0;
+}
@@ -0,0 +1,93 @@
+//
+// Parses a newline-delimited JSON file on the job system and reports records/sec for an increasing number of threads.
+// Rows with more threads than the machine has hardware threads cannot show any scaling.
+// Without a file, a synthetic set of records is generated in memory.
+//
+#define ZPL_IMPLEMENTATION
+#define ZPL_NANO
+#define ZPL_ENABLE_PARSER
+#define ZPL_ENABLE_OPTS
+#define ZPL_ENABLE_JOBS
+#define ZPL_PARSER_DISABLE_ANALYSIS
+#include <zpl.h>
+
+void exit_with_help(zpl_opts *opts) {
+    zpl_opts_print_errors(opts);
+    zpl_opts_print_help(opts);
+    zpl_exit(1);
+}
+
+zpl_string generate_records(zpl_isize count) {
+    zpl_string text = zpl_string_make_reserve(zpl_heap(), count * 96);
+    for (zpl_isize i = 0; i < count; ++i) {
+        text = zpl_string_append_fmt(text, "{\"id\": %td, \"user\": \"user_%td\", \"score\": %d.5, \"tags\": [\"a\", \"b\"], \"ok\": true}\n",
+                                     i, i % 1000, cast(int)(i % 97));
+    }
+    return text;
+}
+
+int main(int argc, char **argv) {
+    zpl_opts opts={0};
+
+    zpl_opts_init(&opts, zpl_heap(), argv[0]);
+    zpl_opts_add(&opts, "f", "file", "input file name.", ZPL_OPTS_STRING);
+    zpl_opts_add(&opts, "t", "threads", "max. number of worker threads.", ZPL_OPTS_INT);
+    zpl_opts_add(&opts, "n", "records", "number of generated records when no file is given.", ZPL_OPTS_INT);
+    zpl_b32 ok = zpl_opts_compile(&opts, argc, argv);
+
+    if (!ok)
+        exit_with_help(&opts);
+
+    char *filename = zpl_opts_string(&opts, "file", NULL);
+    zpl_isize max_threads = cast(zpl_isize)zpl_opts_integer(&opts, "threads", 8);
+    zpl_isize size;
+    char *source;
+    zpl_file_contents fc = {0};
+    zpl_string generated = NULL;
+
+    if (filename) {
+        zpl_printf("Filename: %s\n", filename);
+        fc = zpl_file_read_contents(zpl_heap(), true, filename);
+        source = cast(char *)fc.data;
+        size = fc.size;
+    } else {
+        generated = generate_records(cast(zpl_isize)zpl_opts_integer(&opts, "records", 200000));
+        source = generated;
+        size = zpl_string_length(generated);
+    }
+
+    zpl_affinity affinity;
+    zpl_affinity_init(&affinity);
+    zpl_printf("Input size: %td bytes | Hardware threads: %td\n", size, affinity.thread_count);
+    zpl_affinity_destroy(&affinity);
+
+    // NOTE: the parser works in place, every run gets a fresh copy
+    char *text = cast(char *)zpl_malloc(size + 1);
+
+    for (zpl_isize threads = 0; threads <= max_threads; threads = threads ? threads * 2 : 1) {
+        zpl_jobs_system pool;
+        zpl_json_lines lines;
+        zpl_memcopy(text, source, size);
+        text[size] = '\0';
+
+        if (threads > 0) zpl_jobs_init(&pool, zpl_heap(), cast(zpl_u32)threads);
+
+        zpl_f64 time = zpl_time_rel();
+        zpl_u8 err = zpl_json_lines_parse(&lines, text, size, threads > 0 ? &pool : NULL, zpl_heap());
+        zpl_f64 delta = zpl_time_rel() - time;
+
+        zpl_printf("Threads: %2td | Records: %td | Error code: %d | Delta: %9.3fms", threads, lines.count, err, delta * 1000);
+        if (delta > 0) zpl_printf(" | %.0f records/s | %.1f MB/s", lines.count / delta, size / delta / 1e6);
+        zpl_printf("\n");
+
+        zpl_json_lines_free(&lines);
+        if (threads > 0) zpl_jobs_free(&pool);
+    }
+
+    zpl_mfree(text);
+    if (generated) zpl_string_free(generated);
+    if (fc.data) zpl_file_free_contents(&fc);
+    zpl_opts_free(&opts);
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+//
+// Streams a JSON file in chunks and counts the events, memory use stays flat regardless of the file size.
+// Pass a JSON file (e.g. `json_stream jeopardy.json`) to compare against a full parse.
+//
+#define ZPL_IMPLEMENTATION
+#define ZPL_NANO
+#define ZPL_ENABLE_PARSER
+#include <zpl.h>
+
+typedef struct {
+    zpl_isize containers;
+    zpl_isize values;
+    zpl_isize max_depth;
+} stats;
+
+zpl_b32 count_events(void *user_data, zpl_json_event const *ev) {
+    stats *st = cast(stats *)user_data;
+    if (ev->type == ZPL_JSON_EVENT_VALUE) ++st->values;
+    else if (ev->type == ZPL_JSON_EVENT_OBJECT_BEGIN || ev->type == ZPL_JSON_EVENT_ARRAY_BEGIN) ++st->containers;
+    st->max_depth = zpl_max(st->max_depth, ev->depth);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    char const *path = argc > 1 ? argv[1] : "misc/data/glsl_diffuse.json5";
+    zpl_file f;
+    stats st = {0};
+
+    if (zpl_file_open(&f, path) != ZPL_FILE_ERROR_NONE) {
+        zpl_printf("Could not open %s\n", path);
+        return 1;
+    }
+
+    zpl_json_stream s;
+    zpl_u8 err;
+    zpl_isize runs = 0, bytes = 0, line = 0;
+    zpl_f64 time = zpl_time_rel(), delta;
+
+    // NOTE: Small files stream in well under a timer tick, repeat until the measurement means something
+    do {
+        zpl_zero_item(&st);
+        zpl_file_seek(&f, 0);
+        zpl_json_stream_init(&s, zpl_heap(), count_events, &st);
+        err = zpl_json_stream_file(&s, &f);
+        bytes += s.offset;
+        line = s.line;
+        zpl_json_stream_free(&s);
+        delta = zpl_time_rel() - time;
+        ++runs;
+    } while (err == ZPL_JSON_ERROR_NONE && delta < 0.25);
+
+    zpl_printf("Error code: %d (line %td)\n", err, line);
+    zpl_printf("Containers: %td\nValues: %td\nMax depth: %td\n", st.containers, st.values, st.max_depth);
+    zpl_printf("Stream: %fms (%.1f MB/s over %td runs)\n", delta * 1000 / runs, (bytes / (1024.0 * 1024.0)) / delta, runs);
+
+    zpl_file_close(&f);
+
+    if (argc > 1) {
+        zpl_file_contents fc = zpl_file_read_contents(zpl_heap(), true, path);
+        time = zpl_time_rel();
+        zpl_json_object doc = {0};
+        zpl_json_parse(&doc, cast(char *)fc.data, zpl_heap());
+        delta = zpl_time_rel() - time;
+        zpl_printf("Full parse: %fms\n", delta * 1000);
+        zpl_json_free(&doc);
+        zpl_file_free_contents(&fc);
+    }
+
+    return err;
+}
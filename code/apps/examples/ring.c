@@ -18,6 +18,17 @@ int main()
         zpl_printf("Result is %d\n", *zpl_ring_get(&pad));
     }
     
+    // NOTE: drain in place, without copying values out of the ring
+    for (u32 i = 4; i <= 6; ++i) zpl_ring_append(&pad, i);
+    {
+        u32 *first, *second;
+        zpl_usize first_count, second_count;
+        zpl_usize count = zpl_ring_get_span(&pad, 8, &first, &first_count, &second, &second_count);
+        for (zpl_usize i = 0; i < first_count; ++i) zpl_printf("Span result is %d\n", first[i]);
+        for (zpl_usize i = 0; i < second_count; ++i) zpl_printf("Span result is %d\n", second[i]);
+        zpl_ring_commit_span(&pad, count);
+    }
+    
     zpl_ring_free(&pad);
     
     return 0;
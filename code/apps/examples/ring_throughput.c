@@ -0,0 +1,166 @@
+#define ZPL_IMPLEMENTATION
+#define ZPL_NANO
+#define ZPL_ENABLE_THREADING
+#include <zpl.h>
+
+// Usage: ring_throughput [max producer/consumer pairs]
+// Producer/consumer throughput of ZPL_SPSC_RING and ZPL_MPMC_RING against a ZPL_RING guarded by one zpl_mutex.
+
+#define CAPACITY 1024
+#define ITEMS_PER_PRODUCER (1 << 20)
+#define BATCH 32
+
+#if defined(ZPL_MODULE_THREADING)
+
+ZPL_RING(static, locked_ring_, zpl_u64);
+ZPL_SPSC_RING(static, spsc_ring, spsc_ring_, zpl_u64);
+ZPL_MPMC_RING(static, mpmc_ring, mpmc_ring_, zpl_u64);
+
+typedef enum { MODE_MUTEX, MODE_SPSC, MODE_MPMC } bench_mode;
+
+typedef struct {
+    bench_mode mode;
+    zpl_isize batch;
+    zpl_u32 producers;
+    zpl_mutex lock;
+    locked_ring_zpl_u64 locked;
+    spsc_ring spsc;
+    mpmc_ring mpmc;
+    zpl_atomic64 popped;
+    zpl_atomic64 sum;
+} bench_info;
+
+zpl_global zpl_atomic32 start_flag;
+
+static zpl_isize push_some(bench_info *info, zpl_u64 *values, zpl_isize count) {
+    zpl_isize n = 0;
+    switch (info->mode) {
+        case MODE_MUTEX: {
+            zpl_mutex_lock(&info->lock);
+            while (n < count && !locked_ring_full(&info->locked)) locked_ring_append(&info->locked, values[n++]);
+            zpl_mutex_unlock(&info->lock);
+        } break;
+        case MODE_SPSC: n = count == 1 ? spsc_ring_push(&info->spsc, *values) : spsc_ring_push_batch(&info->spsc, values, count); break;
+        case MODE_MPMC: n = count == 1 ? mpmc_ring_push(&info->mpmc, *values) : mpmc_ring_push_batch(&info->mpmc, values, count); break;
+    }
+    return n;
+}
+
+static zpl_isize pop_some(bench_info *info, zpl_u64 *values, zpl_isize count) {
+    zpl_isize n = 0;
+    switch (info->mode) {
+        case MODE_MUTEX: {
+            zpl_mutex_lock(&info->lock);
+            while (n < count && !locked_ring_empty(&info->locked)) values[n++] = *locked_ring_get(&info->locked);
+            zpl_mutex_unlock(&info->lock);
+        } break;
+        case MODE_SPSC: n = count == 1 ? spsc_ring_pop(&info->spsc, values) : spsc_ring_pop_batch(&info->spsc, values, count); break;
+        case MODE_MPMC: n = count == 1 ? mpmc_ring_pop(&info->mpmc, values) : mpmc_ring_pop_batch(&info->mpmc, values, count); break;
+    }
+    return n;
+}
+
+zpl_isize producer_entry(zpl_thread *thread) {
+    bench_info *info = (bench_info *)thread->user_data;
+    zpl_u64 values[BATCH];
+    while (!zpl_atomic32_load(&start_flag)) zpl_yield_thread();
+
+    for (zpl_u64 i = 0; i < ITEMS_PER_PRODUCER; i += info->batch) {
+        zpl_isize pushed = 0;
+        for (zpl_isize j = 0; j < info->batch; ++j) values[j] = i + j;
+        while (pushed < info->batch) {
+            zpl_isize n = push_some(info, values + pushed, info->batch - pushed);
+            if (!n) zpl_yield();
+            pushed += n;
+        }
+    }
+    return 0;
+}
+
+zpl_isize consumer_entry(zpl_thread *thread) {
+    bench_info *info = (bench_info *)thread->user_data;
+    zpl_i64 total = (zpl_i64)info->producers * ITEMS_PER_PRODUCER;
+    zpl_u64 values[BATCH], sum = 0;
+    while (!zpl_atomic32_load(&start_flag)) zpl_yield_thread();
+
+    while (zpl_atomic64_load(&info->popped) < total) {
+        zpl_isize n = pop_some(info, values, info->batch);
+        if (!n) { zpl_yield(); continue; }
+        for (zpl_isize j = 0; j < n; ++j) sum += values[j];
+        zpl_atomic64_fetch_add(&info->popped, n);
+    }
+    zpl_atomic64_fetch_add(&info->sum, (zpl_i64)sum);
+    return 0;
+}
+
+static zpl_f64 run(bench_mode mode, zpl_isize batch, zpl_u32 pairs) {
+    zpl_thread *workers = (zpl_thread *)zpl_alloc(zpl_heap(), 2 * pairs * zpl_size_of(zpl_thread));
+    bench_info *info = (bench_info *)zpl_alloc(zpl_heap(), zpl_size_of(bench_info));
+    zpl_u64 expected = (zpl_u64)ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER - 1) / 2 * pairs;
+    zpl_f64 start, elapsed;
+
+    zpl_zero_item(info);
+    info->mode = mode;
+    info->batch = batch;
+    info->producers = pairs;
+    zpl_mutex_init(&info->lock);
+    locked_ring_init(&info->locked, zpl_heap(), CAPACITY - 1);
+    spsc_ring_init(&info->spsc, zpl_heap(), CAPACITY);
+    mpmc_ring_init(&info->mpmc, zpl_heap(), CAPACITY);
+    zpl_atomic64_store(&info->popped, 0);
+    zpl_atomic64_store(&info->sum, 0);
+
+    zpl_atomic32_store(&start_flag, 0);
+    for (zpl_u32 i = 0; i < 2 * pairs; ++i) {
+        zpl_thread_init(&workers[i]);
+        zpl_thread_start(&workers[i], i % 2 ? consumer_entry : producer_entry, info);
+    }
+
+    start = zpl_time_rel();
+    zpl_atomic32_store(&start_flag, 1);
+    for (zpl_u32 i = 0; i < 2 * pairs; ++i) {
+        zpl_thread_destroy(&workers[i]);
+    }
+    elapsed = zpl_time_rel() - start;
+    ZPL_ASSERT((zpl_u64)zpl_atomic64_load(&info->sum) == expected);
+    zpl_unused(expected);
+
+    locked_ring_free(&info->locked);
+    spsc_ring_free(&info->spsc);
+    mpmc_ring_free(&info->mpmc);
+    zpl_mutex_destroy(&info->lock);
+    zpl_free(zpl_heap(), workers);
+    zpl_free(zpl_heap(), info);
+    return (zpl_f64)pairs * ITEMS_PER_PRODUCER / elapsed / 1e6;
+}
+
+int main(int argc, char **argv) {
+    zpl_u32 max_pairs = 4;
+
+    if (argc > 1) {
+        max_pairs = (zpl_u32)zpl_str_to_u64(argv[1], NULL, 10);
+    }
+
+    zpl_printf("%d slots, %d items per producer, batches of %d, throughput in Mitems/s.\n\n", CAPACITY, ITEMS_PER_PRODUCER, BATCH);
+    zpl_printf("%-6s %12s %12s %12s %12s %12s %12s\n", "pairs", "mutex", "mutex batch", "spsc", "spsc batch", "mpmc", "mpmc batch");
+
+    for (zpl_u32 pairs = 1; pairs <= max_pairs; pairs *= 2) {
+        zpl_f64 mutex_one = run(MODE_MUTEX, 1, pairs);
+        zpl_f64 mutex_batch = run(MODE_MUTEX, BATCH, pairs);
+        zpl_f64 mpmc_one = run(MODE_MPMC, 1, pairs);
+        zpl_f64 mpmc_batch = run(MODE_MPMC, BATCH, pairs);
+
+        if (pairs == 1) {
+            zpl_f64 spsc_one = run(MODE_SPSC, 1, pairs);
+            zpl_f64 spsc_batch = run(MODE_SPSC, BATCH, pairs);
+            zpl_printf("%-6d %12.2f %12.2f %12.2f %12.2f %12.2f %12.2f\n", pairs, mutex_one, mutex_batch, spsc_one, spsc_batch, mpmc_one, mpmc_batch);
+        } else {
+            zpl_printf("%-6d %12.2f %12.2f %12s %12s %12.2f %12.2f\n", pairs, mutex_one, mutex_batch, "-", "-", mpmc_one, mpmc_batch);
+        }
+    }
+
+    return 0;
+}
+#else
+int main(){return 0;}
+#endif
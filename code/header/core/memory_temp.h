@@ -0,0 +1,59 @@
+// file: header/core/memory_temp.h
+
+
+////////////////////////////////////////////////////////////////
+//
+// Temporary Memory
+//
+// Per-thread scratch allocator for memory that only has to live until the current frame or request is done.
+// Every thread owns two virtual memory arenas and allocates from one of them, zpl_temp_reset swaps them and rewinds
+// the one becoming current. Memory allocated during a frame therefore stays valid throughout the next frame too,
+// which lets results be handed over a single boundary without copying.
+//
+// Once a thread calls zpl_temp_reset at a boundary that suits it (e.g. once per frame, request or processed file),
+// zpl_bprintf returns memory from here as well. Threads that never do keep its single reused buffer.
+//
+
+ZPL_BEGIN_C_DECLS
+
+#ifndef ZPL_TEMP_RESERVE_SIZE
+#    if defined(ZPL_ARCH_64_BIT)
+#        define ZPL_TEMP_RESERVE_SIZE zpl_megabytes(64)
+#    else
+#        define ZPL_TEMP_RESERVE_SIZE zpl_megabytes(4)
+#    endif
+#endif
+
+//! Mark a frame boundary on the calling thread, memory allocated before the previous boundary becomes invalid.
+ZPL_DEF void zpl_temp_reset(void);
+
+//! Whether the calling thread has marked a frame boundary since it started or last called zpl_temp_release.
+ZPL_DEF zpl_b32 zpl_temp_framed(void);
+
+//! Capture the calling thread's temporary memory usage, end it with zpl_temp_snapshot_end.
+//! Snapshots have to be closed before the next zpl_temp_reset. The snapshot's arena is NULL
+//! if the temporary memory could not be reserved, allocations then fail as well.
+ZPL_DEF zpl_arena_snapshot zpl_temp_snapshot_begin(void);
+
+//! Give back everything allocated since the snapshot was taken.
+ZPL_DEF void zpl_temp_snapshot_end(zpl_arena_snapshot snapshot);
+
+//! Release the calling thread's temporary memory, zpl_thread does this when its procedure returns.
+ZPL_DEF void zpl_temp_release(void);
+
+//! Allocation Types: alloc, free_all (rewinds the current frame), resize. Allocations return NULL if the
+//! temporary memory could not be reserved.
+ZPL_DEF_INLINE zpl_allocator zpl_temp_allocator(void);
+ZPL_DEF ZPL_ALLOCATOR_PROC(zpl_temp_allocator_proc);
+
+//! Alias to temporary allocator.
+#define zpl_temp zpl_temp_allocator
+
+ZPL_IMPL_INLINE zpl_allocator zpl_temp_allocator(void) {
+    zpl_allocator a;
+    a.proc = zpl_temp_allocator_proc;
+    a.data = NULL;
+    return a;
+}
+
+ZPL_END_C_DECLS
@@ -23,6 +23,15 @@ ZPL_DEF zpl_virtual_memory zpl_vm(void *data, zpl_isize size);
 //! @param size The size to serve.
 ZPL_DEF zpl_virtual_memory zpl_vm_alloc(void *addr, zpl_isize size);
 
+//! Reserve an address range without committing any memory to it.
+
+//! @param addr The starting address of the region to reserve. If NULL, it lets operating system to decide where to allocate it.
+//! @param size The size to reserve.
+ZPL_DEF zpl_virtual_memory zpl_vm_reserve(void *addr, zpl_isize size);
+
+//! Commit memory to a page-aligned part of a reserved range, making it accessible.
+ZPL_DEF zpl_b32 zpl_vm_commit(zpl_virtual_memory vm);
+
 //! Release the virtual memory.
 ZPL_DEF zpl_b32 zpl_vm_free(zpl_virtual_memory vm);
 
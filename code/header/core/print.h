@@ -21,10 +21,12 @@ ZPL_DEF zpl_isize zpl_printf_err_va(char const *fmt, va_list va);
 ZPL_DEF zpl_isize zpl_fprintf(zpl_file *f, char const *fmt, ...);
 ZPL_DEF zpl_isize zpl_fprintf_va(zpl_file *f, char const *fmt, va_list va);
 
-// NOTE: A locally persisting buffer is used internally
+// NOTE: Never returns NULL. After zpl_temp_reset was called on this thread the result lives in temporary memory
+// and survives one more zpl_temp_reset, otherwise (or if that memory is unavailable) it is a thread-local buffer
+// overwritten by the next call.
 ZPL_DEF char *zpl_bprintf(char const *fmt, ...);
 
-// NOTE: A locally persisting buffer is used internally
+// NOTE: See zpl_bprintf
 ZPL_DEF char *zpl_bprintf_va(char const *fmt, va_list va);
 
 ZPL_DEF zpl_isize zpl_asprintf(zpl_allocator allocator, char **buffer, char const *fmt, ...);
@@ -116,15 +116,12 @@ ZPL_IMPL_INLINE zpl_b8 zpl__array_set_capacity(void **array, zpl_isize capacity)
     zpl_array_header *h = ZPL_ARRAY_HEADER(*array);
     if (capacity == h->capacity) return true;
     if (capacity < h->count) h->count = capacity;
+    zpl_isize old_size = zpl_size_of(zpl_array_header) + h->elem_size * h->capacity;
     zpl_isize size = zpl_size_of(zpl_array_header) + h->elem_size * capacity;
-    zpl_array_header *nh = cast(zpl_array_header *) zpl_alloc(h->allocator, size);
+    // NOTE: Resizing lets the allocator extend the block in place instead of copying it
+    zpl_array_header *nh = cast(zpl_array_header *) zpl_resize(h->allocator, h, old_size, size);
     if (!nh) return false;
-    zpl_memmove(nh, h, zpl_size_of(zpl_array_header) + h->elem_size * h->count);
-    nh->allocator = h->allocator;
-    nh->elem_size = h->elem_size;
-    nh->count = h->count;
     nh->capacity = capacity;
-    zpl_free(h->allocator, h);
     *array = nh + 1;
     return true;
 }
@@ -0,0 +1,311 @@
+// file: header/essentials/collections/flat_table.h
+
+/** @file flat_table.c
+@brief Instantiated open-addressing hash table
+@defgroup flat_table Instantiated open-addressing hash table
+
+
+ Open-addressing counterpart of ZPL_TABLE. Entries live in a single power-of-two sized slot array next to
+ an array of control bytes, one per slot: 0x80 marks an empty slot, otherwise the byte holds 7 bits of the key's hash.
+ Lookups compare a whole group of control bytes at once (16 with SSE2/NEON, 8 with the portable SWAR fallback),
+ so most probes touch one control group and one slot. Collisions are resolved by linear probing and removal
+ shifts the following entries back, so there are no tombstones and the table never needs a cleanup rehash.
+
+ NOTE: The key is always a zpl_u64 like in ZPL_TABLE. Pointers to values are invalidated by set and remove.
+ Define ZPL_FLAT_TABLE_NO_SIMD to force the portable group matching.
+
+ Hash table type and function declaration, call: ZPL_FLAT_TABLE_DECLARE(PREFIX, NAME, FUNC, VALUE)
+ Hash table function definitions, call: ZPL_FLAT_TABLE_DEFINE(NAME, FUNC, VALUE)
+
+     PREFIX  - a prefix for function prototypes e.g. extern, static, etc.
+     NAME    - Name of the Hash Table
+     FUNC    - the name will prefix function names
+     VALUE   - the type of the value to be stored
+
+    tablename_init(NAME * h, zpl_allocator a);
+    tablename_destroy(NAME * h);
+    tablename_clear(NAME * h);
+    tablename_get(NAME * h, zpl_u64 key);
+    tablename_slot(NAME * h, zpl_u64 key);
+    tablename_set(NAME * h, zpl_u64 key, VALUE value);
+    tablename_reserve(NAME * h, zpl_isize count);
+    tablename_rehash(NAME * h, zpl_isize new_capacity);
+    tablename_map(NAME * h, void (*map_proc)(zpl_u64 key, VALUE value))
+    tablename_map_mut(NAME * h, void (*map_proc)(zpl_u64 key, VALUE * value))
+    tablename_remove(NAME * h, zpl_u64 key);
+
+ @{
+*/
+
+#if !defined(ZPL_FLAT_TABLE_NO_SIMD)
+#    if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define ZPL_FLAT_TABLE_SSE2
+#        include <emmintrin.h>
+#    elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#        define ZPL_FLAT_TABLE_NEON
+#        include <arm_neon.h>
+#    endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#endif
+
+ZPL_BEGIN_C_DECLS
+
+#define ZPL_FLAT_TABLE_EMPTY 0x80
+
+#if defined(ZPL_FLAT_TABLE_SSE2)
+#    define ZPL_FLAT_TABLE_GROUP 16
+#    define ZPL__FLAT_TABLE_SHIFT 0
+#elif defined(ZPL_FLAT_TABLE_NEON)
+#    define ZPL_FLAT_TABLE_GROUP 16
+#    define ZPL__FLAT_TABLE_SHIFT 2
+#else
+#    define ZPL_FLAT_TABLE_GROUP 8
+#    define ZPL__FLAT_TABLE_SHIFT 3
+#endif
+
+//! Mixes a key into the hash used by ZPL_FLAT_TABLE. Low 7 bits go into the control byte, the rest picks the slot.
+ZPL_DEF_INLINE zpl_u64 zpl_flat_table_hash(zpl_u64 key);
+
+ZPL_DEF_INLINE zpl_u64 zpl__flat_table_match(zpl_u8 const *ctrl, zpl_u8 h2);
+ZPL_DEF_INLINE zpl_u64 zpl__flat_table_empty(zpl_u8 const *ctrl);
+ZPL_DEF_INLINE zpl_isize zpl__flat_table_bit(zpl_u64 mask);
+
+/**
+ * Combined macro for a quick delcaration + definition
+ */
+
+#define ZPL_FLAT_TABLE(PREFIX, NAME, FUNC, VALUE)                                                                   \
+    ZPL_FLAT_TABLE_DECLARE(PREFIX, NAME, FUNC, VALUE);                                                              \
+    ZPL_FLAT_TABLE_DEFINE(NAME, FUNC, VALUE);
+
+/**
+ * Table delcaration macro that generates the interface
+ */
+
+#define ZPL_FLAT_TABLE_DECLARE(PREFIX, NAME, FUNC, VALUE)                                                           \
+    typedef struct ZPL_JOIN2(NAME, Entry) {                                                                         \
+        zpl_u64 key;                                                                                                \
+        VALUE value;                                                                                                \
+    } ZPL_JOIN2(NAME, Entry);                                                                                       \
+                                                                                                                    \
+    typedef struct NAME {                                                                                           \
+        zpl_allocator allocator;                                                                                    \
+        zpl_u8 *ctrl;                                                                                               \
+        ZPL_JOIN2(NAME, Entry) *entries;                                                                            \
+        zpl_isize capacity;                                                                                         \
+        zpl_isize count;                                                                                            \
+    } NAME;                                                                                                         \
+                                                                                                                    \
+    PREFIX void      ZPL_JOIN2(FUNC, init)          (NAME *h, zpl_allocator a);                                     \
+    PREFIX void      ZPL_JOIN2(FUNC, destroy)       (NAME *h);                                                      \
+    PREFIX void      ZPL_JOIN2(FUNC, clear)         (NAME *h);                                                      \
+    PREFIX VALUE    *ZPL_JOIN2(FUNC, get)           (NAME *h, zpl_u64 key);                                         \
+    PREFIX zpl_isize ZPL_JOIN2(FUNC, slot)          (NAME *h, zpl_u64 key);                                         \
+    PREFIX void      ZPL_JOIN2(FUNC, set)           (NAME *h, zpl_u64 key, VALUE value);                            \
+    PREFIX void      ZPL_JOIN2(FUNC, reserve)       (NAME *h, zpl_isize count);                                     \
+    PREFIX void      ZPL_JOIN2(FUNC, rehash)        (NAME *h, zpl_isize new_capacity);                              \
+    PREFIX void      ZPL_JOIN2(FUNC, map)           (NAME *h, void (*map_proc) (zpl_u64 key, VALUE value));         \
+    PREFIX void      ZPL_JOIN2(FUNC, map_mut)       (NAME *h, void (*map_proc) (zpl_u64 key, VALUE * value));       \
+    PREFIX void      ZPL_JOIN2(FUNC, remove)        (NAME *h, zpl_u64 key);
+
+/**
+ * Table definition interfaces that generates the implementation
+ */
+
+#define ZPL_FLAT_TABLE_DEFINE(NAME, FUNC, VALUE)                                                                    \
+    void ZPL_JOIN2(FUNC, init)(NAME * h, zpl_allocator a) {                                                         \
+        NAME h_ = { 0 };                                                                                            \
+        *h = h_;                                                                                                    \
+        h->allocator = a;                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, destroy)(NAME * h) {                                                                       \
+        if (h->entries) zpl_free(h->allocator, h->entries);                                                         \
+        h->entries = NULL;                                                                                          \
+        h->ctrl = NULL;                                                                                             \
+        h->capacity = h->count = 0;                                                                                 \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, clear)(NAME * h) {                                                                         \
+        if (h->ctrl) zpl_memset(h->ctrl, ZPL_FLAT_TABLE_EMPTY, h->capacity + ZPL_FLAT_TABLE_GROUP);                 \
+        h->count = 0;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal void ZPL_JOIN2(FUNC, _set_ctrl)(NAME * h, zpl_isize index, zpl_u8 value) {                         \
+        h->ctrl[index] = value;                                                                                     \
+        if (index < ZPL_FLAT_TABLE_GROUP) h->ctrl[h->capacity + index] = value;                                     \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal zpl_isize ZPL_JOIN2(FUNC, _find)(NAME * h, zpl_u64 key, zpl_u64 hash) {                            \
+        zpl_isize mask, pos;                                                                                        \
+        if (h->count == 0) return -1;                                                                               \
+        mask = h->capacity - 1;                                                                                     \
+        pos = cast(zpl_isize)(hash >> 7) & mask;                                                                    \
+        for (;;) {                                                                                                  \
+            zpl_u8 const *group = h->ctrl + pos;                                                                    \
+            zpl_u64 m = zpl__flat_table_match(group, cast(zpl_u8)(hash & 0x7f));                                    \
+            while (m) {                                                                                             \
+                zpl_isize index = (pos + zpl__flat_table_bit(m)) & mask;                                            \
+                if (h->entries[index].key == key) return index;                                                     \
+                m &= m - 1;                                                                                         \
+            }                                                                                                       \
+            if (zpl__flat_table_empty(group)) return -1;                                                            \
+            pos = (pos + ZPL_FLAT_TABLE_GROUP) & mask;                                                              \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal zpl_isize ZPL_JOIN2(FUNC, _find_empty)(NAME * h, zpl_u64 hash) {                                   \
+        zpl_isize mask = h->capacity - 1;                                                                           \
+        zpl_isize pos = cast(zpl_isize)(hash >> 7) & mask;                                                          \
+        for (;;) {                                                                                                  \
+            zpl_u64 m = zpl__flat_table_empty(h->ctrl + pos);                                                       \
+            if (m) return (pos + zpl__flat_table_bit(m)) & mask;                                                    \
+            pos = (pos + ZPL_FLAT_TABLE_GROUP) & mask;                                                              \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, rehash)(NAME * h, zpl_isize new_capacity) {                                                \
+        NAME nh = { 0 };                                                                                            \
+        zpl_isize capacity = ZPL_FLAT_TABLE_GROUP;                                                                  \
+        while (capacity < new_capacity || capacity * 3 < h->count * 4) capacity <<= 1;                              \
+        nh.allocator = h->allocator;                                                                                \
+        nh.capacity = capacity;                                                                                     \
+        nh.count = h->count;                                                                                        \
+        nh.entries = cast(ZPL_JOIN2(NAME, Entry) *)zpl_alloc(h->allocator, capacity * zpl_size_of(ZPL_JOIN2(NAME, Entry)) \
+                                                             + capacity + ZPL_FLAT_TABLE_GROUP);                    \
+        nh.ctrl = cast(zpl_u8 *)(nh.entries + capacity);                                                            \
+        zpl_memset(nh.ctrl, ZPL_FLAT_TABLE_EMPTY, capacity + ZPL_FLAT_TABLE_GROUP);                                 \
+        for (zpl_isize i = 0; i < h->capacity; ++i) {                                                               \
+            zpl_u64 hash;                                                                                           \
+            zpl_isize index;                                                                                        \
+            if (h->ctrl[i] & ZPL_FLAT_TABLE_EMPTY) continue;                                                        \
+            hash = zpl_flat_table_hash(h->entries[i].key);                                                          \
+            index = ZPL_JOIN2(FUNC, _find_empty)(&nh, hash);                                                        \
+            ZPL_JOIN2(FUNC, _set_ctrl)(&nh, index, cast(zpl_u8)(hash & 0x7f));                                      \
+            nh.entries[index] = h->entries[i];                                                                      \
+        }                                                                                                           \
+        if (h->entries) zpl_free(h->allocator, h->entries);                                                         \
+        *h = nh;                                                                                                    \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, reserve)(NAME * h, zpl_isize count) {                                                      \
+        if (count * 4 > h->capacity * 3) ZPL_JOIN2(FUNC, rehash)(h, (count * 4 + 2) / 3);                           \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_isize ZPL_JOIN2(FUNC, slot)(NAME * h, zpl_u64 key) {                                                        \
+        return ZPL_JOIN2(FUNC, _find)(h, key, zpl_flat_table_hash(key));                                            \
+    }                                                                                                               \
+                                                                                                                    \
+    VALUE *ZPL_JOIN2(FUNC, get)(NAME * h, zpl_u64 key) {                                                            \
+        zpl_isize index = ZPL_JOIN2(FUNC, _find)(h, key, zpl_flat_table_hash(key));                                 \
+        if (index >= 0) return &h->entries[index].value;                                                            \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, set)(NAME * h, zpl_u64 key, VALUE value) {                                                 \
+        zpl_u64 hash = zpl_flat_table_hash(key);                                                                    \
+        zpl_isize index = ZPL_JOIN2(FUNC, _find)(h, key, hash);                                                     \
+        if (index < 0) {                                                                                            \
+            if ((h->count + 1) * 4 > h->capacity * 3) ZPL_JOIN2(FUNC, rehash)(h, h->capacity * 2);                  \
+            index = ZPL_JOIN2(FUNC, _find_empty)(h, hash);                                                          \
+            ZPL_JOIN2(FUNC, _set_ctrl)(h, index, cast(zpl_u8)(hash & 0x7f));                                        \
+            h->entries[index].key = key;                                                                            \
+            h->count++;                                                                                             \
+        }                                                                                                           \
+        h->entries[index].value = value;                                                                            \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, remove)(NAME * h, zpl_u64 key) {                                                           \
+        zpl_isize mask, hole, next;                                                                                 \
+        zpl_isize index = ZPL_JOIN2(FUNC, _find)(h, key, zpl_flat_table_hash(key));                                 \
+        if (index < 0) return;                                                                                      \
+        /* NOTE: Backward shift deletion, pull later members of the probe run into the hole */                     \
+        mask = h->capacity - 1;                                                                                     \
+        hole = index;                                                                                               \
+        for (next = (hole + 1) & mask; !(h->ctrl[next] & ZPL_FLAT_TABLE_EMPTY); next = (next + 1) & mask) {         \
+            zpl_isize home = cast(zpl_isize)(zpl_flat_table_hash(h->entries[next].key) >> 7) & mask;                \
+            if (((next - home) & mask) >= ((next - hole) & mask)) {                                                 \
+                h->entries[hole] = h->entries[next];                                                                \
+                ZPL_JOIN2(FUNC, _set_ctrl)(h, hole, h->ctrl[next]);                                                 \
+                hole = next;                                                                                        \
+            }                                                                                                       \
+        }                                                                                                           \
+        ZPL_JOIN2(FUNC, _set_ctrl)(h, hole, ZPL_FLAT_TABLE_EMPTY);                                                  \
+        h->count--;                                                                                                 \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, map)(NAME * h, void (*map_proc)(zpl_u64 key, VALUE value)) {                               \
+        ZPL_ASSERT_NOT_NULL(h);                                                                                     \
+        ZPL_ASSERT_NOT_NULL(map_proc);                                                                              \
+        for (zpl_isize i = 0; i < h->capacity; ++i) {                                                               \
+            if (!(h->ctrl[i] & ZPL_FLAT_TABLE_EMPTY)) map_proc(h->entries[i].key, h->entries[i].value);             \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, map_mut)(NAME * h, void (*map_proc)(zpl_u64 key, VALUE * value)) {                         \
+        ZPL_ASSERT_NOT_NULL(h);                                                                                     \
+        ZPL_ASSERT_NOT_NULL(map_proc);                                                                              \
+        for (zpl_isize i = 0; i < h->capacity; ++i) {                                                               \
+            if (!(h->ctrl[i] & ZPL_FLAT_TABLE_EMPTY)) map_proc(h->entries[i].key, &h->entries[i].value);            \
+        }                                                                                                           \
+    }
+
+ZPL_IMPL_INLINE zpl_u64 zpl_flat_table_hash(zpl_u64 key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33;
+    return key;
+}
+
+// NOTE: Match masks carry one set bit per matching control byte, zpl__flat_table_bit turns the lowest into a group offset
+ZPL_IMPL_INLINE zpl_u64 zpl__flat_table_match(zpl_u8 const *ctrl, zpl_u8 h2) {
+#if defined(ZPL_FLAT_TABLE_SSE2)
+    __m128i group = _mm_loadu_si128(cast(__m128i const *)ctrl);
+    return cast(zpl_u64)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(cast(char)h2)));
+#elif defined(ZPL_FLAT_TABLE_NEON)
+    uint8x16_t eq = vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(h2));
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0) & 0x8888888888888888ull;
+#else
+    zpl_u64 group, x;
+    zpl_memcopy(&group, ctrl, 8);
+    x = group ^ (0x0101010101010101ull * h2);
+    // NOTE: May report false positives above a real match, callers compare keys anyway
+    return (x - 0x0101010101010101ull) & ~x & 0x8080808080808080ull;
+#endif
+}
+
+ZPL_IMPL_INLINE zpl_u64 zpl__flat_table_empty(zpl_u8 const *ctrl) {
+#if defined(ZPL_FLAT_TABLE_SSE2)
+    return cast(zpl_u64)_mm_movemask_epi8(_mm_loadu_si128(cast(__m128i const *)ctrl));
+#elif defined(ZPL_FLAT_TABLE_NEON)
+    uint8x16_t empty = vtstq_u8(vld1q_u8(ctrl), vdupq_n_u8(ZPL_FLAT_TABLE_EMPTY));
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(empty), 4)), 0) & 0x8888888888888888ull;
+#else
+    zpl_u64 group;
+    zpl_memcopy(&group, ctrl, 8);
+    return group & 0x8080808080808080ull;
+#endif
+}
+
+ZPL_IMPL_INLINE zpl_isize zpl__flat_table_bit(zpl_u64 mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return cast(zpl_isize)(__builtin_ctzll(mask) >> ZPL__FLAT_TABLE_SHIFT);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return cast(zpl_isize)(index >> ZPL__FLAT_TABLE_SHIFT);
+#else
+    zpl_isize index = 0;
+    while (!(mask & 1)) { mask >>= 1; ++index; }
+    return index >> ZPL__FLAT_TABLE_SHIFT;
+#endif
+}
+
+//! @}
+
+ZPL_END_C_DECLS
@@ -24,7 +24,12 @@
     tablename_map(NAME * h, void (*map_proc)(zpl_u64 key, VALUE value))
     tablename_map_mut(NAME * h, void (*map_proc)(zpl_u64 key, VALUE * value))
     tablename_rehash(NAME * h, zpl_isize new_count);
+    tablename_reserve(NAME * h, zpl_isize count);
     tablename_remove(NAME * h, zpl_u64 key);
+    tablename_remove_entry(NAME * h, zpl_isize idx);
+
+ Removal moves the last entry into the freed slot and patches only the two affected chains,
+ so it is O(1) on average but does not preserve the order of the entries array.
 
  @{
 */
@@ -71,6 +76,7 @@ typedef struct zpl_hash_table_find_result {
     PREFIX void      ZPL_JOIN2(FUNC, grow)          (NAME *h);                                                      \
     PREFIX void      ZPL_JOIN2(FUNC, rehash)        (NAME *h, zpl_isize new_count);                                 \
     PREFIX void      ZPL_JOIN2(FUNC, rehash_fast)   (NAME *h);                                                      \
+    PREFIX void      ZPL_JOIN2(FUNC, reserve)       (NAME *h, zpl_isize count);                                     \
     PREFIX void      ZPL_JOIN2(FUNC, map)           (NAME *h, void (*map_proc) (zpl_u64 key, VALUE value));         \
     PREFIX void      ZPL_JOIN2(FUNC, map_mut)       (NAME *h, void (*map_proc) (zpl_u64 key, VALUE * value));       \
     PREFIX void      ZPL_JOIN2(FUNC, remove)        (NAME *h, zpl_u64 key);                                         \
@@ -186,16 +192,38 @@ typedef struct zpl_hash_table_find_result {
         return NULL;                                                                                                \
     }                                                                                                               \
                                                                                                                     \
+    void ZPL_JOIN2(FUNC, reserve)(NAME * h, zpl_isize count) {                                                      \
+        zpl_isize hash_count = (count * 4 + 2) / 3;                                                                 \
+        if (zpl_array_count(h->hashes) < hash_count) ZPL_JOIN2(FUNC, rehash)(h, hash_count);                        \
+        if (zpl_array_capacity(h->entries) < count) zpl_array_reserve(h->entries, count);                           \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal void ZPL_JOIN2(FUNC, _erase)(NAME * h, zpl_hash_table_find_result fr) {                            \
+        zpl_isize last = zpl_array_count(h->entries) - 1;                                                           \
+        if (fr.entry_prev < 0)                                                                                      \
+            h->hashes[fr.hash_index] = h->entries[fr.entry_index].next;                                             \
+        else                                                                                                        \
+            h->entries[fr.entry_prev].next = h->entries[fr.entry_index].next;                                       \
+        if (fr.entry_index != last) {                                                                               \
+            /* NOTE: Move the last entry into the hole and repoint whoever linked to it */                          \
+            zpl_hash_table_find_result lr = ZPL_JOIN2(FUNC, _find)(h, h->entries[last].key);                        \
+            if (lr.entry_prev < 0)                                                                                  \
+                h->hashes[lr.hash_index] = fr.entry_index;                                                         \
+            else                                                                                                    \
+                h->entries[lr.entry_prev].next = fr.entry_index;                                                    \
+            h->entries[fr.entry_index] = h->entries[last];                                                          \
+        }                                                                                                           \
+        zpl_array_pop(h->entries);                                                                                  \
+    }                                                                                                               \
+                                                                                                                    \
     void ZPL_JOIN2(FUNC, remove)(NAME * h, zpl_u64 key) {                                                           \
         zpl_hash_table_find_result fr = ZPL_JOIN2(FUNC, _find)(h, key);                                             \
-        if (fr.entry_index >= 0) {                                                                                  \
-            zpl_array_remove_at(h->entries, fr.entry_index);                                                        \
-            ZPL_JOIN2(FUNC, rehash_fast)(h);                                                                        \
-        }                                                                                                           \
+        if (fr.entry_index >= 0) ZPL_JOIN2(FUNC, _erase)(h, fr);                                                    \
     }                                                                                                               \
                                                                                                                     \
     void ZPL_JOIN2(FUNC, remove_entry)(NAME * h, zpl_isize idx) {                                                   \
-        zpl_array_remove_at(h->entries, idx);                                                                       \
+        ZPL_ASSERT(idx >= 0 && idx < zpl_array_count(h->entries));                                                  \
+        ZPL_JOIN2(FUNC, _erase)(h, ZPL_JOIN2(FUNC, _find)(h, h->entries[idx].key));                                 \
     }                                                                                                               \
                                                                                                                     \
     void ZPL_JOIN2(FUNC, map)(NAME * h, void (*map_proc)(zpl_u64 key, VALUE value)) {                               \
@@ -21,6 +21,13 @@ funcname_init(VALUE * pad, zpl_allocator a, zpl_isize max_size)
  funcname_append_array(VALUE * pad, zpl_array(type) data)    
  funcname_get(VALUE * pad)                                  
 funcname_get_array(VALUE * pad, zpl_usize max_size, zpl_allocator a)
+funcname_get_span(VALUE * pad, zpl_usize max_size, type **first, zpl_usize *first_count, type **second, zpl_usize *second_count)
+ funcname_commit_span(VALUE * pad, zpl_usize count)
+
+get_span exposes up to max_size queued values in place as at most two slices of the ring's buffer (the part up to the
+end of the buffer and the wrapped part) and returns their total count. Nothing is consumed until commit_span is called,
+so a consumer can process a batch without copying or allocating and then release it. commit_span must not release
+more values than are queued.
 */
 ZPL_BEGIN_C_DECLS
 
@@ -44,7 +51,10 @@ prefix void ZPL_JOIN2(func, append)(ZPL_JOIN2(func, type) * pad, type data);
 prefix void ZPL_JOIN2(func, append_array)(ZPL_JOIN2(func, type) * pad, zpl_array(type) data);    \
 prefix type *ZPL_JOIN2(func, get)(ZPL_JOIN2(func, type) * pad);                                  \
 prefix zpl_array(type)                                                                                            \
-ZPL_JOIN2(func, get_array)(ZPL_JOIN2(func, type) * pad, zpl_usize max_size, zpl_allocator a);
+ZPL_JOIN2(func, get_array)(ZPL_JOIN2(func, type) * pad, zpl_usize max_size, zpl_allocator a);                \
+prefix zpl_usize ZPL_JOIN2(func, get_span)(ZPL_JOIN2(func, type) * pad, zpl_usize max_size,                  \
+type **first, zpl_usize *first_count, type **second, zpl_usize *second_count);                               \
+prefix void ZPL_JOIN2(func, commit_span)(ZPL_JOIN2(func, type) * pad, zpl_usize count);
 
 #define ZPL_RING_DEFINE(func,type)                                                                                          \
 void ZPL_JOIN2(func, init)(ZPL_JOIN2(func, type) * pad, zpl_allocator a, zpl_isize max_size) {        \
@@ -91,10 +101,32 @@ zpl_array(type)
 ZPL_JOIN2(func, get_array)(ZPL_JOIN2(func, type) * pad, zpl_usize max_size, zpl_allocator a) {    \
 zpl_array(type) vals = 0;                                                                                          \
 zpl_array_init(vals, a);                                                                                       \
-while (--max_size && !ZPL_JOIN2(func, empty)(pad)) {                                               \
+while (max_size-- && !ZPL_JOIN2(func, empty)(pad)) {                                               \
 zpl_array_append(vals, *ZPL_JOIN2(func, get)(pad));                                            \
 }                                                                                                              \
 return vals;                                                                                                   \
+}                                                                                                                  \
+\
+zpl_usize ZPL_JOIN2(func, get_span)(ZPL_JOIN2(func, type) * pad, zpl_usize max_size,                 \
+type **first, zpl_usize *first_count, type **second, zpl_usize *second_count) {                               \
+zpl_usize head = pad->head, tail = pad->tail;                                                                  \
+zpl_usize avail = head >= tail ? head - tail : pad->capacity - tail + head;                                    \
+zpl_usize n1, n2;                                                                                              \
+if (avail > max_size) avail = max_size;                                                                        \
+n1 = zpl_min(avail, pad->capacity - tail);                                                                     \
+n2 = avail - n1;                                                                                               \
+*first = n1 ? &pad->buf[tail] : NULL;                                                                          \
+*first_count = n1;                                                                                             \
+*second = n2 ? &pad->buf[0] : NULL;                                                                            \
+*second_count = n2;                                                                                            \
+return avail;                                                                                                  \
+}                                                                                                                  \
+\
+void ZPL_JOIN2(func, commit_span)(ZPL_JOIN2(func, type) * pad, zpl_usize count) {                     \
+zpl_usize head = pad->head, tail = pad->tail;                                                                  \
+ZPL_ASSERT_MSG(count <= (head >= tail ? head - tail : pad->capacity - tail + head),                            \
+               "Committing more values than are queued");                                                      \
+pad->tail = (tail + count) % pad->capacity;                                                                    \
 }
 
 ZPL_END_C_DECLS
@@ -0,0 +1,216 @@
+// file: header/essentials/collections/slot_map.h
+
+/** @file slot_map.c
+@brief Instantiated generational slot map
+@defgroup slot_map Instantiated generational slot map
+
+
+ Stores values densely packed in an array and hands out stable handles to them. A handle packs a slot index
+ (low 32 bits) and the slot's generation (high 32 bits). Slots map handles to positions in the dense array,
+ removal moves the last value into the hole and bumps the slot's generation, so stale handles are detected
+ instead of silently resolving to another value. Freed slots are queued and reused oldest first, which keeps
+ generations of busy slots from wrapping around quickly.
+
+ Insert, remove and lookup are O(1), iteration walks the dense array:
+
+     for (zpl_isize i = 0; i < zpl_array_count(m.values); ++i) use(m.values[i], slotmap_handle_of(&m, i));
+
+ NOTE: Pointers to values are invalidated by insert and remove. Handle 0 is never valid and can be used as "none".
+
+ Slot map type and function declaration, call: ZPL_SLOT_MAP_DECLARE(PREFIX, NAME, FUNC, VALUE)
+ Slot map function definitions, call: ZPL_SLOT_MAP_DEFINE(NAME, FUNC, VALUE)
+
+     PREFIX  - a prefix for function prototypes e.g. extern, static, etc.
+     NAME    - Name of the Slot Map
+     FUNC    - the name will prefix function names
+     VALUE   - the type of the value to be stored
+
+    slotmap_init(NAME * m, zpl_allocator a);
+    slotmap_destroy(NAME * m);
+    slotmap_clear(NAME * m);
+    slotmap_reserve(NAME * m, zpl_isize count);
+    slotmap_insert(NAME * m, VALUE value);
+    slotmap_get(NAME * m, zpl_u64 handle);
+    slotmap_contains(NAME * m, zpl_u64 handle);
+    slotmap_remove(NAME * m, zpl_u64 handle);
+    slotmap_count(NAME * m);
+    slotmap_handle_of(NAME * m, zpl_isize index);
+    slotmap_map(NAME * m, void (*map_proc)(zpl_u64 handle, VALUE value))
+    slotmap_map_mut(NAME * m, void (*map_proc)(zpl_u64 handle, VALUE * value))
+
+ @{
+*/
+
+ZPL_BEGIN_C_DECLS
+
+#define ZPL_SLOT_MAP_NONE 0xffffffffu
+
+#define zpl_slot_handle(index, generation) ((cast(zpl_u64)(generation) << 32) | cast(zpl_u32)(index))
+#define zpl_slot_handle_index(handle) cast(zpl_u32)((handle) & 0xffffffffu)
+#define zpl_slot_handle_generation(handle) cast(zpl_u32)((handle) >> 32)
+
+typedef struct zpl_slot {
+    zpl_u32 index; // NOTE: position in the dense array while in use, next free slot otherwise
+    zpl_u32 generation;
+} zpl_slot;
+
+/**
+ * Combined macro for a quick delcaration + definition
+ */
+
+#define ZPL_SLOT_MAP(PREFIX, NAME, FUNC, VALUE)                                                                     \
+    ZPL_SLOT_MAP_DECLARE(PREFIX, NAME, FUNC, VALUE);                                                                \
+    ZPL_SLOT_MAP_DEFINE(NAME, FUNC, VALUE);
+
+/**
+ * Slot map delcaration macro that generates the interface
+ */
+
+#define ZPL_SLOT_MAP_DECLARE(PREFIX, NAME, FUNC, VALUE)                                                             \
+    typedef struct NAME {                                                                                           \
+        zpl_array(VALUE) values;                                                                                    \
+        zpl_array(zpl_u32) dense_slots;                                                                             \
+        zpl_array(zpl_slot) slots;                                                                                  \
+        zpl_u32 free_head;                                                                                          \
+        zpl_u32 free_tail;                                                                                          \
+    } NAME;                                                                                                         \
+                                                                                                                    \
+    PREFIX void      ZPL_JOIN2(FUNC, init)          (NAME *m, zpl_allocator a);                                     \
+    PREFIX void      ZPL_JOIN2(FUNC, destroy)       (NAME *m);                                                      \
+    PREFIX void      ZPL_JOIN2(FUNC, clear)         (NAME *m);                                                      \
+    PREFIX void      ZPL_JOIN2(FUNC, reserve)       (NAME *m, zpl_isize count);                                     \
+    PREFIX zpl_u64   ZPL_JOIN2(FUNC, insert)        (NAME *m, VALUE value);                                         \
+    PREFIX VALUE    *ZPL_JOIN2(FUNC, get)           (NAME *m, zpl_u64 handle);                                      \
+    PREFIX zpl_b32   ZPL_JOIN2(FUNC, contains)      (NAME *m, zpl_u64 handle);                                      \
+    PREFIX zpl_b32   ZPL_JOIN2(FUNC, remove)        (NAME *m, zpl_u64 handle);                                      \
+    PREFIX zpl_isize ZPL_JOIN2(FUNC, count)         (NAME *m);                                                      \
+    PREFIX zpl_u64   ZPL_JOIN2(FUNC, handle_of)     (NAME *m, zpl_isize index);                                     \
+    PREFIX void      ZPL_JOIN2(FUNC, map)           (NAME *m, void (*map_proc) (zpl_u64 handle, VALUE value));      \
+    PREFIX void      ZPL_JOIN2(FUNC, map_mut)       (NAME *m, void (*map_proc) (zpl_u64 handle, VALUE * value));
+
+/**
+ * Slot map definition interfaces that generates the implementation
+ */
+
+#define ZPL_SLOT_MAP_DEFINE(NAME, FUNC, VALUE)                                                                      \
+    void ZPL_JOIN2(FUNC, init)(NAME * m, zpl_allocator a) {                                                         \
+        zpl_array_init(m->values, a);                                                                               \
+        zpl_array_init(m->dense_slots, a);                                                                          \
+        zpl_array_init(m->slots, a);                                                                                \
+        m->free_head = m->free_tail = ZPL_SLOT_MAP_NONE;                                                            \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, destroy)(NAME * m) {                                                                       \
+        zpl_array_free(m->values);                                                                                  \
+        zpl_array_free(m->dense_slots);                                                                             \
+        zpl_array_free(m->slots);                                                                                   \
+        m->values = NULL;                                                                                           \
+        m->dense_slots = NULL;                                                                                      \
+        m->slots = NULL;                                                                                            \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal void ZPL_JOIN2(FUNC, _release)(NAME * m, zpl_u32 slot) {                                           \
+        /* NOTE: Skip generation 0 on wrap around, slot 0 would hand out handle 0 otherwise */                      \
+        if (++m->slots[slot].generation == 0) m->slots[slot].generation = 1;                                        \
+        m->slots[slot].index = ZPL_SLOT_MAP_NONE;                                                                   \
+        if (m->free_tail == ZPL_SLOT_MAP_NONE) m->free_head = slot;                                                 \
+        else m->slots[m->free_tail].index = slot;                                                                   \
+        m->free_tail = slot;                                                                                        \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, clear)(NAME * m) {                                                                         \
+        for (zpl_isize i = 0; i < zpl_array_count(m->dense_slots); ++i) {                                           \
+            ZPL_JOIN2(FUNC, _release)(m, m->dense_slots[i]);                                                        \
+        }                                                                                                           \
+        zpl_array_clear(m->values);                                                                                 \
+        zpl_array_clear(m->dense_slots);                                                                            \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, reserve)(NAME * m, zpl_isize count) {                                                      \
+        zpl_array_reserve(m->values, count);                                                                        \
+        zpl_array_reserve(m->dense_slots, count);                                                                   \
+        zpl_array_reserve(m->slots, count);                                                                         \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_u64 ZPL_JOIN2(FUNC, insert)(NAME * m, VALUE value) {                                                        \
+        zpl_u32 slot;                                                                                               \
+        if (m->free_head != ZPL_SLOT_MAP_NONE) {                                                                    \
+            slot = m->free_head;                                                                                    \
+            m->free_head = m->slots[slot].index;                                                                    \
+            if (m->free_head == ZPL_SLOT_MAP_NONE) m->free_tail = ZPL_SLOT_MAP_NONE;                                \
+        } else {                                                                                                    \
+            /* NOTE: Generations start at 1 so that handle 0 never resolves */                                      \
+            zpl_slot fresh;                                                                                         \
+            fresh.generation = 1;                                                                                   \
+            ZPL_ASSERT_MSG(zpl_array_count(m->slots) < ZPL_SLOT_MAP_NONE, "Slot map is full");                      \
+            slot = cast(zpl_u32)zpl_array_count(m->slots);                                                          \
+            zpl_array_append(m->slots, fresh);                                                                      \
+        }                                                                                                           \
+        m->slots[slot].index = cast(zpl_u32)zpl_array_count(m->values);                                             \
+        zpl_array_append(m->values, value);                                                                         \
+        zpl_array_append(m->dense_slots, slot);                                                                     \
+        return zpl_slot_handle(slot, m->slots[slot].generation);                                                    \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal zpl_isize ZPL_JOIN2(FUNC, _find)(NAME * m, zpl_u64 handle) {                                       \
+        zpl_u32 slot = zpl_slot_handle_index(handle);                                                               \
+        if (slot >= cast(zpl_u32)zpl_array_count(m->slots)) return -1;                                              \
+        if (m->slots[slot].generation != zpl_slot_handle_generation(handle)) return -1;                             \
+        return m->slots[slot].index;                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    VALUE *ZPL_JOIN2(FUNC, get)(NAME * m, zpl_u64 handle) {                                                         \
+        zpl_isize index = ZPL_JOIN2(FUNC, _find)(m, handle);                                                        \
+        if (index >= 0) return &m->values[index];                                                                   \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_b32 ZPL_JOIN2(FUNC, contains)(NAME * m, zpl_u64 handle) {                                                   \
+        return ZPL_JOIN2(FUNC, _find)(m, handle) >= 0;                                                              \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_b32 ZPL_JOIN2(FUNC, remove)(NAME * m, zpl_u64 handle) {                                                     \
+        zpl_isize index = ZPL_JOIN2(FUNC, _find)(m, handle);                                                        \
+        zpl_isize last;                                                                                             \
+        if (index < 0) return false;                                                                                \
+        /* NOTE: Move the last value into the hole and point its slot at the new position */                        \
+        last = zpl_array_count(m->values) - 1;                                                                      \
+        if (index != last) {                                                                                        \
+            m->values[index] = m->values[last];                                                                     \
+            m->dense_slots[index] = m->dense_slots[last];                                                           \
+            m->slots[m->dense_slots[index]].index = cast(zpl_u32)index;                                             \
+        }                                                                                                           \
+        zpl_array_pop(m->values);                                                                                   \
+        zpl_array_pop(m->dense_slots);                                                                              \
+        ZPL_JOIN2(FUNC, _release)(m, zpl_slot_handle_index(handle));                                                \
+        return true;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_isize ZPL_JOIN2(FUNC, count)(NAME * m) {                                                                    \
+        return zpl_array_count(m->values);                                                                          \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_u64 ZPL_JOIN2(FUNC, handle_of)(NAME * m, zpl_isize index) {                                                 \
+        zpl_u32 slot = m->dense_slots[index];                                                                       \
+        return zpl_slot_handle(slot, m->slots[slot].generation);                                                    \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, map)(NAME * m, void (*map_proc)(zpl_u64 handle, VALUE value)) {                            \
+        ZPL_ASSERT_NOT_NULL(m);                                                                                     \
+        ZPL_ASSERT_NOT_NULL(map_proc);                                                                              \
+        for (zpl_isize i = 0; i < zpl_array_count(m->values); ++i) {                                                \
+            map_proc(ZPL_JOIN2(FUNC, handle_of)(m, i), m->values[i]);                                               \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, map_mut)(NAME * m, void (*map_proc)(zpl_u64 handle, VALUE * value)) {                      \
+        ZPL_ASSERT_NOT_NULL(m);                                                                                     \
+        ZPL_ASSERT_NOT_NULL(map_proc);                                                                              \
+        for (zpl_isize i = 0; i < zpl_array_count(m->values); ++i) {                                                \
+            map_proc(ZPL_JOIN2(FUNC, handle_of)(m, i), &m->values[i]);                                              \
+        }                                                                                                           \
+    }
+
+//! @}
+
+ZPL_END_C_DECLS
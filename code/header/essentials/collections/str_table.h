@@ -0,0 +1,325 @@
+// file: header/essentials/collections/str_table.h
+
+/** @file str_table.c
+@brief Instantiated string-keyed hash table and string interner
+@defgroup str_table Instantiated string-keyed hash table
+
+
+ String-keyed counterpart of ZPL_FLAT_TABLE. The table copies key bytes into its own block storage,
+ so callers may pass temporary buffers, and every entry caches the full 64-bit hash of its key:
+ probes reject mismatches by control byte and hash before touching the key bytes, and growing never rehashes strings.
+
+ Keys are passed as pointer + length; pass a negative length for NUL-terminated keys.
+ Stored keys are NUL-terminated and stay valid until the table is cleared or destroyed,
+ removing an entry does not reclaim its key bytes.
+
+ Hash table type and function declaration, call: ZPL_STR_TABLE_DECLARE(PREFIX, NAME, FUNC, VALUE)
+ Hash table function definitions, call: ZPL_STR_TABLE_DEFINE(NAME, FUNC, VALUE)
+
+     PREFIX  - a prefix for function prototypes e.g. extern, static, etc.
+     NAME    - Name of the Hash Table
+     FUNC    - the name will prefix function names
+     VALUE   - the type of the value to be stored
+
+    tablename_init(NAME * h, zpl_allocator a);
+    tablename_destroy(NAME * h);
+    tablename_clear(NAME * h);
+    tablename_get(NAME * h, char const *key, zpl_isize len);
+    tablename_slot(NAME * h, char const *key, zpl_isize len);
+    tablename_set(NAME * h, char const *key, zpl_isize len, VALUE value); // returns the stored key, NULL if it could not be copied
+    tablename_reserve(NAME * h, zpl_isize count);
+    tablename_rehash(NAME * h, zpl_isize new_capacity);
+    tablename_map(NAME * h, void (*map_proc)(char const *key, VALUE value))
+    tablename_map_mut(NAME * h, void (*map_proc)(char const *key, VALUE * value))
+    tablename_remove(NAME * h, char const *key, zpl_isize len);
+
+ zpl_strintern is a ready-made instance that maps each distinct string to one canonical copy,
+ interned strings can then be compared by pointer. Its entry values hold the order in which strings were interned.
+
+ @{
+*/
+
+ZPL_BEGIN_C_DECLS
+
+#ifndef ZPL_STR_TABLE_KEY_BLOCK
+#define ZPL_STR_TABLE_KEY_BLOCK 4096
+#endif
+
+//! Chained blocks holding the key bytes of a string table.
+typedef struct zpl_str_table_keys {
+    zpl_u8 *block;
+    zpl_isize used;
+    zpl_isize size;
+} zpl_str_table_keys;
+
+//! Hash used by ZPL_STR_TABLE.
+ZPL_DEF zpl_u64 zpl_str_table_hash(void const *key, zpl_isize len);
+
+ZPL_DEF_INLINE char const *zpl__str_table_store(zpl_str_table_keys *keys, zpl_allocator a, char const *key, zpl_isize len);
+ZPL_DEF_INLINE void        zpl__str_table_release(zpl_str_table_keys *keys, zpl_allocator a);
+
+// NOTE: Expanded where a table is defined, by then the string module has been declared
+#if defined(ZPL_MODULE_CORE)
+#    define zpl__str_table_len zpl_strlen
+#else
+ZPL_DEF_INLINE zpl_isize   zpl__str_table_len(char const *key);
+#endif
+
+/**
+ * Combined macro for a quick delcaration + definition
+ */
+
+#define ZPL_STR_TABLE(PREFIX, NAME, FUNC, VALUE)                                                                    \
+    ZPL_STR_TABLE_DECLARE(PREFIX, NAME, FUNC, VALUE);                                                               \
+    ZPL_STR_TABLE_DEFINE(NAME, FUNC, VALUE);
+
+/**
+ * Table delcaration macro that generates the interface
+ */
+
+#define ZPL_STR_TABLE_DECLARE(PREFIX, NAME, FUNC, VALUE)                                                            \
+    typedef struct ZPL_JOIN2(NAME, Entry) {                                                                         \
+        char const *key;                                                                                            \
+        zpl_isize len;                                                                                              \
+        zpl_u64 hash;                                                                                               \
+        VALUE value;                                                                                                \
+    } ZPL_JOIN2(NAME, Entry);                                                                                       \
+                                                                                                                    \
+    typedef struct NAME {                                                                                           \
+        zpl_allocator allocator;                                                                                    \
+        zpl_u8 *ctrl;                                                                                               \
+        ZPL_JOIN2(NAME, Entry) *entries;                                                                            \
+        zpl_isize capacity;                                                                                         \
+        zpl_isize count;                                                                                            \
+        zpl_str_table_keys keys;                                                                                    \
+    } NAME;                                                                                                         \
+                                                                                                                    \
+    PREFIX void        ZPL_JOIN2(FUNC, init)        (NAME *h, zpl_allocator a);                                     \
+    PREFIX void        ZPL_JOIN2(FUNC, destroy)     (NAME *h);                                                      \
+    PREFIX void        ZPL_JOIN2(FUNC, clear)       (NAME *h);                                                      \
+    PREFIX VALUE      *ZPL_JOIN2(FUNC, get)         (NAME *h, char const *key, zpl_isize len);                      \
+    PREFIX zpl_isize   ZPL_JOIN2(FUNC, slot)        (NAME *h, char const *key, zpl_isize len);                      \
+    PREFIX char const *ZPL_JOIN2(FUNC, set)         (NAME *h, char const *key, zpl_isize len, VALUE value);         \
+    PREFIX void        ZPL_JOIN2(FUNC, reserve)     (NAME *h, zpl_isize count);                                     \
+    PREFIX void        ZPL_JOIN2(FUNC, rehash)      (NAME *h, zpl_isize new_capacity);                              \
+    PREFIX void        ZPL_JOIN2(FUNC, map)         (NAME *h, void (*map_proc) (char const *key, VALUE value));     \
+    PREFIX void        ZPL_JOIN2(FUNC, map_mut)     (NAME *h, void (*map_proc) (char const *key, VALUE * value));   \
+    PREFIX void        ZPL_JOIN2(FUNC, remove)      (NAME *h, char const *key, zpl_isize len);
+
+/**
+ * Table definition interfaces that generates the implementation
+ */
+
+#define ZPL_STR_TABLE_DEFINE(NAME, FUNC, VALUE)                                                                     \
+    void ZPL_JOIN2(FUNC, init)(NAME * h, zpl_allocator a) {                                                         \
+        NAME h_ = { 0 };                                                                                            \
+        *h = h_;                                                                                                    \
+        h->allocator = a;                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, destroy)(NAME * h) {                                                                       \
+        if (h->entries) zpl_free(h->allocator, h->entries);                                                         \
+        zpl__str_table_release(&h->keys, h->allocator);                                                             \
+        h->entries = NULL;                                                                                          \
+        h->ctrl = NULL;                                                                                             \
+        h->capacity = h->count = 0;                                                                                 \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, clear)(NAME * h) {                                                                         \
+        if (h->ctrl) zpl_memset(h->ctrl, ZPL_FLAT_TABLE_EMPTY, h->capacity + ZPL_FLAT_TABLE_GROUP);                 \
+        zpl__str_table_release(&h->keys, h->allocator);                                                             \
+        h->count = 0;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal void ZPL_JOIN2(FUNC, _set_ctrl)(NAME * h, zpl_isize index, zpl_u8 value) {                         \
+        h->ctrl[index] = value;                                                                                     \
+        if (index < ZPL_FLAT_TABLE_GROUP) h->ctrl[h->capacity + index] = value;                                     \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal zpl_isize ZPL_JOIN2(FUNC, _find)(NAME * h, char const *key, zpl_isize len, zpl_u64 hash) {         \
+        zpl_isize mask, pos;                                                                                        \
+        if (h->count == 0) return -1;                                                                               \
+        mask = h->capacity - 1;                                                                                     \
+        pos = cast(zpl_isize)(hash >> 7) & mask;                                                                    \
+        for (;;) {                                                                                                  \
+            zpl_u8 const *group = h->ctrl + pos;                                                                    \
+            zpl_u64 m = zpl__flat_table_match(group, cast(zpl_u8)(hash & 0x7f));                                    \
+            while (m) {                                                                                             \
+                zpl_isize index = (pos + zpl__flat_table_bit(m)) & mask;                                            \
+                ZPL_JOIN2(NAME, Entry) *e = &h->entries[index];                                                     \
+                if (e->hash == hash && e->len == len && !zpl_memcompare(e->key, key, len)) return index;            \
+                m &= m - 1;                                                                                         \
+            }                                                                                                       \
+            if (zpl__flat_table_empty(group)) return -1;                                                            \
+            pos = (pos + ZPL_FLAT_TABLE_GROUP) & mask;                                                              \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal zpl_isize ZPL_JOIN2(FUNC, _find_empty)(NAME * h, zpl_u64 hash) {                                   \
+        zpl_isize mask = h->capacity - 1;                                                                           \
+        zpl_isize pos = cast(zpl_isize)(hash >> 7) & mask;                                                          \
+        for (;;) {                                                                                                  \
+            zpl_u64 m = zpl__flat_table_empty(h->ctrl + pos);                                                       \
+            if (m) return (pos + zpl__flat_table_bit(m)) & mask;                                                    \
+            pos = (pos + ZPL_FLAT_TABLE_GROUP) & mask;                                                              \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, rehash)(NAME * h, zpl_isize new_capacity) {                                                \
+        NAME nh = *h;                                                                                               \
+        zpl_isize capacity = ZPL_FLAT_TABLE_GROUP;                                                                  \
+        while (capacity < new_capacity || capacity * 3 < h->count * 4) capacity <<= 1;                              \
+        nh.capacity = capacity;                                                                                     \
+        nh.entries = cast(ZPL_JOIN2(NAME, Entry) *)zpl_alloc(h->allocator, capacity * zpl_size_of(ZPL_JOIN2(NAME, Entry)) \
+                                                             + capacity + ZPL_FLAT_TABLE_GROUP);                    \
+        nh.ctrl = cast(zpl_u8 *)(nh.entries + capacity);                                                            \
+        zpl_memset(nh.ctrl, ZPL_FLAT_TABLE_EMPTY, capacity + ZPL_FLAT_TABLE_GROUP);                                 \
+        for (zpl_isize i = 0; i < h->capacity; ++i) {                                                               \
+            zpl_isize index;                                                                                        \
+            if (h->ctrl[i] & ZPL_FLAT_TABLE_EMPTY) continue;                                                        \
+            index = ZPL_JOIN2(FUNC, _find_empty)(&nh, h->entries[i].hash);                                          \
+            ZPL_JOIN2(FUNC, _set_ctrl)(&nh, index, h->ctrl[i]);                                                     \
+            nh.entries[index] = h->entries[i];                                                                      \
+        }                                                                                                           \
+        if (h->entries) zpl_free(h->allocator, h->entries);                                                         \
+        *h = nh;                                                                                                    \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, reserve)(NAME * h, zpl_isize count) {                                                      \
+        if (count * 4 > h->capacity * 3) ZPL_JOIN2(FUNC, rehash)(h, (count * 4 + 2) / 3);                           \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_isize ZPL_JOIN2(FUNC, slot)(NAME * h, char const *key, zpl_isize len) {                                     \
+        if (len < 0) len = zpl__str_table_len(key);                                                                 \
+        return ZPL_JOIN2(FUNC, _find)(h, key, len, zpl_str_table_hash(key, len));                                   \
+    }                                                                                                               \
+                                                                                                                    \
+    VALUE *ZPL_JOIN2(FUNC, get)(NAME * h, char const *key, zpl_isize len) {                                         \
+        zpl_isize index = ZPL_JOIN2(FUNC, slot)(h, key, len);                                                       \
+        if (index >= 0) return &h->entries[index].value;                                                            \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal zpl_isize ZPL_JOIN2(FUNC, _insert)(NAME * h, char const *key, zpl_isize len, zpl_u64 hash) {       \
+        ZPL_JOIN2(NAME, Entry) *e;                                                                                  \
+        zpl_isize index;                                                                                            \
+        /* NOTE: Copy the key first, so a failed allocation leaves the table untouched */                           \
+        char const *stored = zpl__str_table_store(&h->keys, h->allocator, key, len);                                \
+        if (!stored) return -1;                                                                                     \
+        if ((h->count + 1) * 4 > h->capacity * 3) ZPL_JOIN2(FUNC, rehash)(h, h->capacity * 2);                      \
+        index = ZPL_JOIN2(FUNC, _find_empty)(h, hash);                                                              \
+        ZPL_JOIN2(FUNC, _set_ctrl)(h, index, cast(zpl_u8)(hash & 0x7f));                                            \
+        e = &h->entries[index];                                                                                     \
+        e->key = stored;                                                                                            \
+        e->len = len;                                                                                               \
+        e->hash = hash;                                                                                             \
+        h->count++;                                                                                                 \
+        return index;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    char const *ZPL_JOIN2(FUNC, set)(NAME * h, char const *key, zpl_isize len, VALUE value) {                       \
+        zpl_u64 hash;                                                                                               \
+        zpl_isize index;                                                                                            \
+        if (len < 0) len = zpl__str_table_len(key);                                                                 \
+        hash = zpl_str_table_hash(key, len);                                                                        \
+        index = ZPL_JOIN2(FUNC, _find)(h, key, len, hash);                                                          \
+        if (index < 0) index = ZPL_JOIN2(FUNC, _insert)(h, key, len, hash);                                         \
+        if (index < 0) return NULL;                                                                                 \
+        h->entries[index].value = value;                                                                            \
+        return h->entries[index].key;                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, remove)(NAME * h, char const *key, zpl_isize len) {                                        \
+        zpl_isize mask, hole, next;                                                                                 \
+        zpl_isize index = ZPL_JOIN2(FUNC, slot)(h, key, len);                                                       \
+        if (index < 0) return;                                                                                      \
+        /* NOTE: Backward shift deletion, same as ZPL_FLAT_TABLE */                                                 \
+        mask = h->capacity - 1;                                                                                     \
+        hole = index;                                                                                               \
+        for (next = (hole + 1) & mask; !(h->ctrl[next] & ZPL_FLAT_TABLE_EMPTY); next = (next + 1) & mask) {         \
+            zpl_isize home = cast(zpl_isize)(h->entries[next].hash >> 7) & mask;                                    \
+            if (((next - home) & mask) >= ((next - hole) & mask)) {                                                 \
+                h->entries[hole] = h->entries[next];                                                                \
+                ZPL_JOIN2(FUNC, _set_ctrl)(h, hole, h->ctrl[next]);                                                 \
+                hole = next;                                                                                        \
+            }                                                                                                       \
+        }                                                                                                           \
+        ZPL_JOIN2(FUNC, _set_ctrl)(h, hole, ZPL_FLAT_TABLE_EMPTY);                                                  \
+        h->count--;                                                                                                 \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, map)(NAME * h, void (*map_proc)(char const *key, VALUE value)) {                           \
+        ZPL_ASSERT_NOT_NULL(h);                                                                                     \
+        ZPL_ASSERT_NOT_NULL(map_proc);                                                                              \
+        for (zpl_isize i = 0; i < h->capacity; ++i) {                                                               \
+            if (!(h->ctrl[i] & ZPL_FLAT_TABLE_EMPTY)) map_proc(h->entries[i].key, h->entries[i].value);             \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, map_mut)(NAME * h, void (*map_proc)(char const *key, VALUE * value)) {                     \
+        ZPL_ASSERT_NOT_NULL(h);                                                                                     \
+        ZPL_ASSERT_NOT_NULL(map_proc);                                                                              \
+        for (zpl_isize i = 0; i < h->capacity; ++i) {                                                               \
+            if (!(h->ctrl[i] & ZPL_FLAT_TABLE_EMPTY)) map_proc(h->entries[i].key, &h->entries[i].value);            \
+        }                                                                                                           \
+    }
+
+ZPL_STR_TABLE_DECLARE(ZPL_DEF, zpl_strintern, zpl__strintern_, zpl_u32);
+
+//! Initialize a string interner.
+ZPL_DEF void zpl_strintern_init(zpl_strintern *s, zpl_allocator a);
+
+//! Release the interner and every string it owns.
+ZPL_DEF void zpl_strintern_destroy(zpl_strintern *s);
+
+//! Return the canonical copy of a string, adding it if it is new. Negative len means NUL-terminated.
+ZPL_DEF char const *zpl_strintern_add(zpl_strintern *s, char const *str, zpl_isize len);
+
+//! Return the canonical copy of a string or NULL if it was never interned.
+ZPL_DEF char const *zpl_strintern_get(zpl_strintern *s, char const *str, zpl_isize len);
+
+ZPL_IMPL_INLINE char const *zpl__str_table_store(zpl_str_table_keys *keys, zpl_allocator a, char const *key, zpl_isize len) {
+    char *dest;
+
+    if (!keys->block || keys->used + len + 1 > keys->size) {
+        zpl_isize size = zpl_max(ZPL_STR_TABLE_KEY_BLOCK, zpl_size_of(zpl_u8 *) + len + 1);
+        zpl_u8 *block = cast(zpl_u8 *)zpl_alloc_uninit(a, size);
+        if (!block) return NULL;
+
+        // NOTE: Every block starts with a link to the previous one
+        *cast(zpl_u8 **)block = keys->block;
+        keys->block = block;
+        keys->used = zpl_size_of(zpl_u8 *);
+        keys->size = size;
+    }
+
+    dest = cast(char *)(keys->block + keys->used);
+    zpl_memcopy(dest, key, len);
+    dest[len] = 0;
+    keys->used += len + 1;
+    return dest;
+}
+
+ZPL_IMPL_INLINE void zpl__str_table_release(zpl_str_table_keys *keys, zpl_allocator a) {
+    zpl_u8 *block = keys->block;
+
+    while (block) {
+        zpl_u8 *prev = *cast(zpl_u8 **)block;
+        zpl_free(a, block);
+        block = prev;
+    }
+
+    zpl_zero_item(keys);
+}
+
+#if !defined(ZPL_MODULE_CORE)
+ZPL_IMPL_INLINE zpl_isize zpl__str_table_len(char const *key) {
+    char const *end = key;
+    while (*end) ++end;
+    return end - key;
+}
+#endif
+
+//! @}
+
+ZPL_END_C_DECLS
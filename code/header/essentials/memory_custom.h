@@ -39,12 +39,21 @@ typedef enum zpl_alloc_flag {
 #define ZPL_DEFAULT_ALLOCATOR_FLAGS (ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO)
 #endif
 
+//! Flags used by the *_uninit helpers, the contents of the new memory are left undefined.
+#define ZPL_UNINIT_ALLOCATOR_FLAGS (ZPL_DEFAULT_ALLOCATOR_FLAGS & ~ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO)
+
 //! Allocate memory with specified alignment.
 ZPL_DEF_INLINE void *zpl_alloc_align(zpl_allocator a, zpl_isize size, zpl_isize alignment);
 
 //! Allocate memory with default alignment.
 ZPL_DEF_INLINE void *zpl_alloc(zpl_allocator a, zpl_isize size);
 
+//! Allocate memory with specified alignment without clearing it.
+ZPL_DEF_INLINE void *zpl_alloc_align_uninit(zpl_allocator a, zpl_isize size, zpl_isize alignment);
+
+//! Allocate memory with default alignment without clearing it.
+ZPL_DEF_INLINE void *zpl_alloc_uninit(zpl_allocator a, zpl_isize size);
+
 //! Free allocated memory.
 ZPL_DEF_INLINE void zpl_free(zpl_allocator a, void *ptr);
 
@@ -57,6 +66,12 @@ ZPL_DEF_INLINE void *zpl_resize(zpl_allocator a, void *ptr, zpl_isize old_size,
 //! Resize an allocated memory with specified alignment.
 ZPL_DEF_INLINE void *zpl_resize_align(zpl_allocator a, void *ptr, zpl_isize old_size, zpl_isize new_size, zpl_isize alignment);
 
+//! Resize an allocated memory, the grown part is left uncleared.
+ZPL_DEF_INLINE void *zpl_resize_uninit(zpl_allocator a, void *ptr, zpl_isize old_size, zpl_isize new_size);
+
+//! Resize an allocated memory with specified alignment, the grown part is left uncleared.
+ZPL_DEF_INLINE void *zpl_resize_align_uninit(zpl_allocator a, void *ptr, zpl_isize old_size, zpl_isize new_size, zpl_isize alignment);
+
 //! Allocate memory and copy data into it.
 ZPL_DEF_INLINE void *zpl_alloc_copy(zpl_allocator a, void const *src, zpl_isize size);
 
@@ -76,6 +91,9 @@ ZPL_DEF_INLINE char *zpl_alloc_str_len(zpl_allocator a, char const *str, zpl_isi
 
 //! Allocate memory for an array of items.
 #define zpl_alloc_array(allocator_, Type, count) (Type *)zpl_alloc(allocator_, zpl_size_of(Type) * (count))
+
+//! Allocate memory for an array of items without clearing it.
+#define zpl_alloc_array_uninit(allocator_, Type, count) (Type *)zpl_alloc_uninit(allocator_, zpl_size_of(Type) * (count))
 #endif
 
 /* heap memory analysis tools */
@@ -92,6 +110,9 @@ ZPL_DEF void zpl_heap_stats_check(void);
 //! Use this if you don't need a "fancy" resize allocation
 ZPL_DEF_INLINE void *zpl_default_resize_align(zpl_allocator a, void *ptr, zpl_isize old_size, zpl_isize new_size, zpl_isize alignment);
 
+//! Same as zpl_default_resize_align, but only clears the grown part when flags contain ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO.
+ZPL_DEF_INLINE void *zpl_default_resize_align_with_flags(zpl_allocator a, void *ptr, zpl_isize old_size, zpl_isize new_size, zpl_isize alignment, zpl_u64 flags);
+
 //! The heap allocator backed by operating system's memory manager.
 ZPL_DEF_INLINE zpl_allocator zpl_heap_allocator(void);
 ZPL_DEF ZPL_ALLOCATOR_PROC(zpl_heap_allocator_proc);
@@ -118,6 +139,8 @@ typedef struct zpl_arena {
     zpl_isize total_size;
     zpl_isize total_allocated;
     zpl_isize temp_count;
+    zpl_isize temp_mark; //!< usage when the newest open snapshot was taken, resizes don't shrink below it
+    void *vm_block;      //!< current block of a virtual memory arena, NULL otherwise
 } zpl_arena;
 
 //! Initialize memory arena from existing memory region.
@@ -129,8 +152,21 @@ ZPL_DEF_INLINE void zpl_arena_init_from_allocator(zpl_arena *arena, zpl_allocato
 //! Initialize memory arena within an existing parent memory arena.
 ZPL_DEF_INLINE void zpl_arena_init_sub(zpl_arena *arena, zpl_arena *parent_arena, zpl_isize size);
 
+#if defined(ZPL_MODULE_CORE)
+#ifndef ZPL_ARENA_VM_COMMIT_SIZE
+#define ZPL_ARENA_VM_COMMIT_SIZE zpl_kilobytes(64)
+#endif
+
+//! Initialize memory arena backed by reserved virtual memory.
+//! Only the address range is reserved up front, pages are committed in ZPL_ARENA_VM_COMMIT_SIZE steps as the
+//! arena grows. Once the range is used up, another block of at least the same size is chained, so the arena
+//! never runs out before the system does. Resetting the arena releases the chained blocks and purges the pages.
+//! @param reserve_size Size of the address range to reserve per block.
+ZPL_DEF void zpl_arena_init_from_vm(zpl_arena *arena, zpl_isize reserve_size);
+#endif
+
 //! Release the memory used by memory arena.
-ZPL_DEF_INLINE void zpl_arena_free(zpl_arena *arena);
+ZPL_DEF void zpl_arena_free(zpl_arena *arena);
 
 
 //! Retrieve memory arena's aligned allocation address.
@@ -150,13 +186,15 @@ ZPL_DEF ZPL_ALLOCATOR_PROC(zpl_arena_allocator_proc);
 typedef struct zpl_arena_snapshot {
     zpl_arena *arena;
     zpl_isize original_count;
+    zpl_isize temp_mark;
+    void *vm_block;
 } zpl_arena_snapshot;
 
 //! Capture a snapshot of used memory in a memory arena.
 ZPL_DEF_INLINE zpl_arena_snapshot zpl_arena_snapshot_begin(zpl_arena *arena);
 
 //! Reset memory arena's usage by a captured snapshot.
-ZPL_DEF_INLINE void zpl_arena_snapshot_end(zpl_arena_snapshot tmp_mem);
+ZPL_DEF void zpl_arena_snapshot_end(zpl_arena_snapshot tmp_mem);
 
 //
 // Pool Allocator
@@ -182,9 +220,10 @@ ZPL_DEF void zpl_pool_init_align(zpl_pool *pool, zpl_allocator backing, zpl_isiz
                                  zpl_isize block_align);
 
 //! Release the resources used by pool allocator.
-ZPL_DEF_INLINE void zpl_pool_free(zpl_pool *pool);
+ZPL_DEF void zpl_pool_free(zpl_pool *pool);
 
-//! Allocation Types: alloc, free
+//! Allocation Types: alloc, free, free_all
+//! Once all blocks are taken, another slab of num_blocks blocks is chained from the backing allocator.
 ZPL_DEF_INLINE zpl_allocator zpl_pool_allocator(zpl_pool *pool);
 ZPL_DEF ZPL_ALLOCATOR_PROC(zpl_pool_allocator_proc);
 
@@ -261,6 +300,12 @@ ZPL_IMPL_INLINE void *zpl_alloc_align(zpl_allocator a, zpl_isize size, zpl_isize
 ZPL_IMPL_INLINE void *zpl_alloc(zpl_allocator a, zpl_isize size) {
     return zpl_alloc_align(a, size, ZPL_DEFAULT_MEMORY_ALIGNMENT);
 }
+ZPL_IMPL_INLINE void *zpl_alloc_align_uninit(zpl_allocator a, zpl_isize size, zpl_isize alignment) {
+    return a.proc(a.data, ZPL_ALLOCATION_ALLOC, size, alignment, NULL, 0, ZPL_UNINIT_ALLOCATOR_FLAGS);
+}
+ZPL_IMPL_INLINE void *zpl_alloc_uninit(zpl_allocator a, zpl_isize size) {
+    return zpl_alloc_align_uninit(a, size, ZPL_DEFAULT_MEMORY_ALIGNMENT);
+}
 ZPL_IMPL_INLINE void zpl_free(zpl_allocator a, void *ptr) {
     if (ptr != NULL) a.proc(a.data, ZPL_ALLOCATION_FREE, 0, 0, ptr, 0, ZPL_DEFAULT_ALLOCATOR_FLAGS);
 }
@@ -273,17 +318,23 @@ ZPL_IMPL_INLINE void *zpl_resize(zpl_allocator a, void *ptr, zpl_isize old_size,
 ZPL_IMPL_INLINE void *zpl_resize_align(zpl_allocator a, void *ptr, zpl_isize old_size, zpl_isize new_size, zpl_isize alignment) {
     return a.proc(a.data, ZPL_ALLOCATION_RESIZE, new_size, alignment, ptr, old_size, ZPL_DEFAULT_ALLOCATOR_FLAGS);
 }
+ZPL_IMPL_INLINE void *zpl_resize_uninit(zpl_allocator a, void *ptr, zpl_isize old_size, zpl_isize new_size) {
+    return zpl_resize_align_uninit(a, ptr, old_size, new_size, ZPL_DEFAULT_MEMORY_ALIGNMENT);
+}
+ZPL_IMPL_INLINE void *zpl_resize_align_uninit(zpl_allocator a, void *ptr, zpl_isize old_size, zpl_isize new_size, zpl_isize alignment) {
+    return a.proc(a.data, ZPL_ALLOCATION_RESIZE, new_size, alignment, ptr, old_size, ZPL_UNINIT_ALLOCATOR_FLAGS);
+}
 
 ZPL_IMPL_INLINE void *zpl_alloc_copy(zpl_allocator a, void const *src, zpl_isize size) {
-    return zpl_memcopy(zpl_alloc(a, size), src, size);
+    return zpl_memcopy(zpl_alloc_uninit(a, size), src, size);
 }
 ZPL_IMPL_INLINE void *zpl_alloc_copy_align(zpl_allocator a, void const *src, zpl_isize size, zpl_isize alignment) {
-    return zpl_memcopy(zpl_alloc_align(a, size, alignment), src, size);
+    return zpl_memcopy(zpl_alloc_align_uninit(a, size, alignment), src, size);
 }
 
 ZPL_IMPL_INLINE char *zpl_alloc_str_len(zpl_allocator a, char const *str, zpl_isize len) {
     char *result;
-    result = cast(char *) zpl_alloc(a, len + 1);
+    result = cast(char *) zpl_alloc_uninit(a, len + 1);
     zpl_memmove(result, str, len);
     result[len] = '\0';
     return result;
@@ -291,7 +342,14 @@ ZPL_IMPL_INLINE char *zpl_alloc_str_len(zpl_allocator a, char const *str, zpl_is
 
 ZPL_IMPL_INLINE void *zpl_default_resize_align(zpl_allocator a, void *old_memory, zpl_isize old_size, zpl_isize new_size,
                                                zpl_isize alignment) {
-    if (!old_memory) return zpl_alloc_align(a, new_size, alignment);
+    return zpl_default_resize_align_with_flags(a, old_memory, old_size, new_size, alignment, ZPL_DEFAULT_ALLOCATOR_FLAGS);
+}
+
+ZPL_IMPL_INLINE void *zpl_default_resize_align_with_flags(zpl_allocator a, void *old_memory, zpl_isize old_size, zpl_isize new_size,
+                                                          zpl_isize alignment, zpl_u64 flags) {
+    if (!old_memory) {
+        return a.proc(a.data, ZPL_ALLOCATION_ALLOC, new_size, alignment, NULL, 0, flags);
+    }
     
     if (new_size == 0) {
         zpl_free(a, old_memory);
@@ -303,9 +361,13 @@ ZPL_IMPL_INLINE void *zpl_default_resize_align(zpl_allocator a, void *old_memory
     if (old_size == new_size) {
         return old_memory;
     } else {
-        void *new_memory = zpl_alloc_align(a, new_size, alignment);
+        // NOTE: Only the grown part may need clearing, the rest is overwritten by the copy
+        void *new_memory = zpl_alloc_align_uninit(a, new_size, alignment);
         if (!new_memory) return NULL;
-        zpl_memmove(new_memory, old_memory, zpl_min(new_size, old_size));
+        zpl_memmove(new_memory, old_memory, old_size);
+        if (flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO) {
+            zpl_zero_size(zpl_pointer_add(new_memory, old_size), new_size - old_size);
+        }
         zpl_free(a, old_memory);
         return new_memory;
     }
@@ -333,6 +395,8 @@ ZPL_IMPL_INLINE void zpl_arena_init_from_memory(zpl_arena *arena, void *start, z
     arena->total_size = size;
     arena->total_allocated = 0;
     arena->temp_count = 0;
+    arena->temp_mark = 0;
+    arena->vm_block = NULL;
 }
 
 ZPL_IMPL_INLINE void zpl_arena_init_from_allocator(zpl_arena *arena, zpl_allocator backing, zpl_isize size) {
@@ -341,19 +405,14 @@ ZPL_IMPL_INLINE void zpl_arena_init_from_allocator(zpl_arena *arena, zpl_allocat
     arena->total_size = size;
     arena->total_allocated = 0;
     arena->temp_count = 0;
+    arena->temp_mark = 0;
+    arena->vm_block = NULL;
 }
 
 ZPL_IMPL_INLINE void zpl_arena_init_sub(zpl_arena *arena, zpl_arena *parent_arena, zpl_isize size) {
     zpl_arena_init_from_allocator(arena, zpl_arena_allocator(parent_arena), size);
 }
 
-ZPL_IMPL_INLINE void zpl_arena_free(zpl_arena *arena) {
-    if (arena->backing.proc) {
-        zpl_free(arena->backing, arena->physical_start);
-        arena->physical_start = NULL;
-    }
-}
-
 ZPL_IMPL_INLINE zpl_isize zpl_arena_alignment_of(zpl_arena *arena, zpl_isize alignment) {
     zpl_isize alignment_offset, result_pointer, mask;
     ZPL_ASSERT(zpl_is_power_of_two(alignment));
@@ -384,17 +443,13 @@ ZPL_IMPL_INLINE zpl_arena_snapshot zpl_arena_snapshot_begin(zpl_arena *arena) {
     zpl_arena_snapshot tmp;
     tmp.arena = arena;
     tmp.original_count = arena->total_allocated;
+    tmp.temp_mark = arena->temp_mark;
+    tmp.vm_block = arena->vm_block;
+    arena->temp_mark = arena->total_allocated;
     arena->temp_count++;
     return tmp;
 }
 
-ZPL_IMPL_INLINE void zpl_arena_snapshot_end(zpl_arena_snapshot tmp) {
-    ZPL_ASSERT(tmp.arena->total_allocated >= tmp.original_count);
-    ZPL_ASSERT(tmp.arena->temp_count > 0);
-    tmp.arena->total_allocated = tmp.original_count;
-    tmp.arena->temp_count--;
-}
-
 //
 // Pool Allocator
 //
@@ -403,10 +458,6 @@ ZPL_IMPL_INLINE void zpl_pool_init(zpl_pool *pool, zpl_allocator backing, zpl_is
     zpl_pool_init_align(pool, backing, num_blocks, block_size, ZPL_DEFAULT_MEMORY_ALIGNMENT);
 }
 
-ZPL_IMPL_INLINE void zpl_pool_free(zpl_pool *pool) {
-    if (pool->backing.proc) { zpl_free(pool->backing, pool->physical_start); }
-}
-
 ZPL_IMPL_INLINE zpl_allocator zpl_pool_allocator(zpl_pool *pool) {
     zpl_allocator allocator;
     allocator.proc = zpl_pool_allocator_proc;
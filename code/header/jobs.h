@@ -7,6 +7,17 @@
  This job system follows thread pool pattern to minimize the costs of thread initialization.
  It reuses fixed number of threads to process variable number of jobs.
 
+ Jobs can be enqueued from any thread, every priority has its own bounded lock-free queue.
+ Queue capacity is rounded up to the next power of two.
+
+ By default, jobs are handed out to idle workers by zpl_jobs_process, which has to be called by the main thread.
+ With ZPL_JOBS_FLAG_WORK_STEALING, every worker owns a Chase-Lev deque and drives itself instead: it pops its own
+ deque, then the shared priority queues and finally steals from a random victim, so no thread needs to pump the pool.
+
+ ZPL_JOBS_FLAG_PIN_WORKERS pins worker i to hardware thread i + 1, counting the first thread of every physical core
+ before any SMT sibling. That leaves the first core to the thread that submits work, keeps siblings free while there
+ are fewer workers than cores, and workers beyond the available hardware threads stay unpinned.
+
  @{
  */
 
@@ -14,12 +25,37 @@ ZPL_BEGIN_C_DECLS
 
 typedef void (*zpl_jobs_proc)(void *data);
 
+//! Processes the [begin, end) sub-range of a parallel loop.
+typedef void (*zpl_jobs_range_proc)(void *data, zpl_isize begin, zpl_isize end);
+
+//! Accumulates the [begin, end) sub-range of a parallel reduction into `partial`.
+typedef void (*zpl_jobs_reduce_proc)(void *data, zpl_isize begin, zpl_isize end, void *partial);
+
+//! Merges `partial` into `result`.
+typedef void (*zpl_jobs_combine_proc)(void *data, void *result, void const *partial);
+
 #define ZPL_INVALID_JOB ZPL_U32_MAX
 
 #ifndef ZPL_JOBS_MAX_QUEUE
 #define ZPL_JOBS_MAX_QUEUE 100
 #endif
 
+//! Number of spins an idle worker does before it parks itself, see zpl_jobs_set_spin_budget.
+#ifndef ZPL_JOBS_SPIN_BUDGET
+#define ZPL_JOBS_SPIN_BUDGET 4096
+#endif
+
+//! Number of continuations a single zpl_jobs_counter can hold.
+#ifndef ZPL_JOBS_MAX_CONTINUATIONS
+#define ZPL_JOBS_MAX_CONTINUATIONS 8
+#endif
+
+//! Number of chunks each participant of a parallel loop gets when the grain size is picked automatically,
+//! participants beyond the physical core count are not counted.
+#ifndef ZPL_JOBS_PARALLEL_SPLIT
+#define ZPL_JOBS_PARALLEL_SPLIT 8
+#endif
+
 #ifdef ZPL_JOBS_ENABLE_DEBUG
 #define ZPL_JOBS_DEBUG
 #endif
@@ -31,6 +67,11 @@ typedef enum {
     ZPL_JOBS_STATUS_TERM,
 } zpl_jobs_status;
 
+typedef enum {
+    ZPL_JOBS_FLAG_WORK_STEALING = ZPL_BIT(0), ///< workers schedule themselves using per-worker deques
+    ZPL_JOBS_FLAG_PIN_WORKERS   = ZPL_BIT(1), ///< pin worker i to hardware thread i + 1, physical cores first, then SMT siblings
+} zpl_jobs_flags;
+
 typedef enum {
     ZPL_JOBS_PRIORITY_REALTIME,
     ZPL_JOBS_PRIORITY_HIGH,
@@ -40,35 +81,96 @@ typedef enum {
     ZPL_JOBS_MAX_PRIORITIES,
 } zpl_jobs_priority;
 
+struct zpl_jobs_counter;
+
 typedef struct {
     zpl_jobs_proc proc;
     void *data;
+    struct zpl_jobs_counter *counter; ///< signalled once the job finishes, can be NULL
 } zpl_thread_job;
 
-ZPL_RING_DECLARE(extern, zpl__jobs_ring_, zpl_thread_job);
+typedef struct {
+    zpl_thread_job job;
+    zpl_jobs_priority priority;
+} zpl__jobs_continuation;
+
+//! Completion counter shared by a group of jobs. It holds the number of jobs that still have to finish
+//! and the continuations that get enqueued once it drops to zero.
+typedef struct zpl_jobs_counter {
+    zpl_atomic32 value;
+    zpl_atomic32 lock;
+    zpl_u32 continuation_count;
+    zpl__jobs_continuation continuations[ZPL_JOBS_MAX_CONTINUATIONS];
+} zpl_jobs_counter;
+
+typedef struct {
+    zpl_atomic64 sequence;
+    zpl_thread_job job;
+} zpl__jobs_cell;
+
+//! Bounded lock-free multi-producer/multi-consumer queue (Dmitry Vyukov's design).
+typedef struct {
+    zpl_atomic64 head;
+    zpl_u8 head_pad[ZPL_CACHE_LINE_SIZE - zpl_size_of(zpl_atomic64)];
+    zpl_atomic64 tail;
+    zpl_u8 tail_pad[ZPL_CACHE_LINE_SIZE - zpl_size_of(zpl_atomic64)];
+    zpl__jobs_cell *cells;
+    zpl_i64 mask;
+} zpl__jobs_queue;
+
+//! Chase-Lev work-stealing deque, the owner pushes and pops at the bottom, thieves steal from the top.
+typedef struct {
+    zpl_atomic64 top;
+    zpl_u8 top_pad[ZPL_CACHE_LINE_SIZE - zpl_size_of(zpl_atomic64)];
+    zpl_atomic64 bottom;
+    zpl_u8 bottom_pad[ZPL_CACHE_LINE_SIZE - zpl_size_of(zpl_atomic64)];
+    zpl_thread_job *jobs;
+    zpl_i64 mask;
+} zpl__jobs_deque;
+
+struct zpl_jobs_system;
 
 typedef struct {
     zpl_thread thread;
     zpl_atomic32 status;
     zpl_thread_job job;
+    struct zpl_jobs_system *pool;
+    zpl_u32 index;
+    zpl_u32 seed;
+    zpl_u32 counter; ///< rotates the priorities, only touched by whoever holds the worker
+    zpl_isize core;  ///< physical core the worker is pinned to, -1 if unpinned
+    zpl_isize smt;   ///< hardware thread of that core the worker is pinned to
+    zpl__jobs_deque deque;
+
+    zpl_semaphore wake;
+    zpl_atomic32 parked;
+    zpl_u32 parks;        ///< times the worker went to sleep
+    zpl_atomic32 unparks; ///< times the worker was woken up by a producer
 #ifdef ZPL_JOBS_DEBUG
     zpl_u32 hits;
     zpl_u32 idle;
+    zpl_u32 steals;
 #endif
 } zpl_thread_worker;
 
 typedef struct {
-    zpl__jobs_ring_zpl_thread_job jobs; ///< zpl_ring
+    zpl__jobs_queue jobs;
     zpl_u32 chance;
 #ifdef ZPL_JOBS_DEBUG
     zpl_u32 hits;
 #endif
 } zpl_thread_queue;
 
-typedef struct {
+typedef struct zpl_jobs_system {
     zpl_allocator alloc;
-    zpl_u32 max_threads, max_jobs, counter;
+    zpl_u32 max_threads, max_jobs;
+    zpl_u32 flags;
+    zpl_atomic32 pending; ///< jobs enqueued but not finished yet (work-stealing only)
+    zpl_atomic32 spin_budget;
+    zpl_atomic32 sleepers;
     zpl_thread_worker *workers; ///< zpl_buffer
+    zpl_affinity *affinity;     ///< topology used to pin workers, NULL unless ZPL_JOBS_FLAG_PIN_WORKERS is set
+    zpl_isize core_count;       ///< physical cores, parallel loops size their chunks for the participants that fit
     zpl_thread_queue queues[ZPL_JOBS_MAX_PRIORITIES];
 } zpl_jobs_system;
 
@@ -78,12 +180,51 @@ ZPL_DEF void    zpl_jobs_init(zpl_jobs_system *pool, zpl_allocator a, zpl_u32 ma
 //! Initialize thread pool with specified amount of fixed threads and custom job limit.
 ZPL_DEF void    zpl_jobs_init_with_limit(zpl_jobs_system *pool, zpl_allocator a, zpl_u32 max_threads, zpl_u32 max_jobs);
 
+//! Initialize thread pool with specified amount of fixed threads, custom job limit and scheduling flags.
+//! @see zpl_jobs_flags
+ZPL_DEF void    zpl_jobs_init_with_flags(zpl_jobs_system *pool, zpl_allocator a, zpl_u32 max_threads, zpl_u32 max_jobs, zpl_u32 flags);
+
 //! Release the resources use by thread pool.
 ZPL_DEF void    zpl_jobs_free(zpl_jobs_system *pool);
 
+//! Set how many times an idle worker spins before it parks on its semaphore, 0 parks immediately.
+//! Higher budgets lower the wake-up latency at the cost of burning CPU while the pool is idle.
+ZPL_DEF void    zpl_jobs_set_spin_budget(zpl_jobs_system *pool, zpl_u32 spins);
+
 //! Enqueue a job with specified data and custom priority.
+//! In work-stealing mode, jobs enqueued from within a worker go to its own deque and ignore the priority.
 ZPL_DEF zpl_b32 zpl_jobs_enqueue_with_priority(zpl_jobs_system *pool, zpl_jobs_proc proc, void *data, zpl_jobs_priority priority);
 
+//! Enqueue multiple jobs with the same priority at once, zero the counter of jobs that are not tracked.
+//! Returns the number of jobs that fit into the queue.
+ZPL_DEF zpl_u32 zpl_jobs_enqueue_batch(zpl_jobs_system *pool, zpl_thread_job const *jobs, zpl_u32 count, zpl_jobs_priority priority);
+
+//! Initialize a completion counter, see zpl_jobs_enqueue_counted.
+ZPL_DEF void    zpl_jobs_counter_init(zpl_jobs_counter *counter);
+
+//! Check whether all jobs tracked by the counter have finished.
+ZPL_DEF zpl_b32 zpl_jobs_counter_done(zpl_jobs_counter *counter);
+
+//! Enqueue a job and track its completion with a counter.
+ZPL_DEF zpl_b32 zpl_jobs_enqueue_counted(zpl_jobs_system *pool, zpl_jobs_proc proc, void *data, zpl_jobs_priority priority, zpl_jobs_counter *counter);
+
+//! Enqueue a job once all jobs tracked by the `dependency` counter finish, `counter` (can be NULL) tracks the new job.
+//! Jobs counted afterwards on `dependency` delay the continuation as well. Returns false when the counter is out of continuation slots.
+ZPL_DEF zpl_b32 zpl_jobs_enqueue_after(zpl_jobs_system *pool, zpl_jobs_counter *dependency, zpl_jobs_proc proc, void *data, zpl_jobs_priority priority, zpl_jobs_counter *counter);
+
+//! Wait until all jobs tracked by the counter finish. The calling thread helps by running pending jobs meanwhile.
+ZPL_DEF void    zpl_jobs_wait(zpl_jobs_system *pool, zpl_jobs_counter *counter);
+
+//! Run `proc` over [begin, end) split into chunks of `grain` items, pass 0 to derive the grain from the worker count.
+//! Chunks are handed out dynamically, the calling thread takes part and returns once the whole range is processed.
+ZPL_DEF void    zpl_jobs_parallel_for(zpl_jobs_system *pool, zpl_isize begin, zpl_isize end, zpl_isize grain, zpl_jobs_range_proc proc, void *data);
+
+//! Reduce [begin, end) in parallel. `result` holds the identity value of `result_size` bytes on input, every participant
+//! starts from a copy of it, and the partial results are combined into `result` in a fixed order on the calling thread.
+ZPL_DEF void    zpl_jobs_parallel_reduce(zpl_jobs_system *pool, zpl_isize begin, zpl_isize end, zpl_isize grain,
+                                         zpl_jobs_reduce_proc proc, zpl_jobs_combine_proc combine, void *data,
+                                         void *result, zpl_isize result_size);
+
 //! Enqueue a job with specified data.
 ZPL_DEF zpl_b32 zpl_jobs_enqueue(zpl_jobs_system *pool, zpl_jobs_proc proc, void *data);
 
@@ -100,6 +241,7 @@ ZPL_DEF zpl_b32 zpl_jobs_full(zpl_jobs_system *pool, zpl_jobs_priority priority)
 ZPL_DEF zpl_b32 zpl_jobs_done(zpl_jobs_system *pool);
 
 //! Process all jobs and check all threads. Should be called by Main Thread in a tight loop.
+//! In work-stealing mode workers feed themselves, so this only reports whether any work is left.
 ZPL_DEF zpl_b32 zpl_jobs_process(zpl_jobs_system *pool);
 
 ZPL_END_C_DECLS
@@ -13,6 +13,8 @@ typedef enum zpl_json_error {
     ZPL_JSON_ERROR_ARRAY_LEFT_OPEN,
     ZPL_JSON_ERROR_OBJECT_END_PAIR_MISMATCHED,
     ZPL_JSON_ERROR_OUT_OF_MEMORY,
+    ZPL_JSON_ERROR_UNEXPECTED_END_OF_INPUT,
+    ZPL_JSON_ERROR_ABORTED,
 } zpl_json_error;
 
 typedef enum zpl_json_indent_style {
@@ -0,0 +1,76 @@
+// file: header/parsers/json_cursor.h
+
+
+////////////////////////////////////////////////////////////////
+//
+// JSON5 Cursor
+//
+// Read-only, on-demand access to a JSON5 document without building the ADT tree.
+// A cursor is a small value that points at one value in the raw text. Descending into a field or element only walks
+// the siblings in front of it, and whole subtrees are skipped by bracket matching. Numbers and keywords are decoded
+// when asked for, strings are handed out as slices of the input.
+//
+// The input is never modified and does not have to be NUL-terminated, it has to outlive every cursor made from it.
+// Cursors that point at nothing (missing keys, out of range indices, malformed input) are invalid, every accessor
+// accepts them and returns its fallback, so lookups can be chained without checking each step.
+//
+// NOTE: String slices are returned raw, escape sequences are kept just like zpl_json_parse keeps them.
+//
+
+ZPL_BEGIN_C_DECLS
+
+typedef struct zpl_json_cursor {
+    char const *value; // NOTE: NULL for invalid cursors
+    char const *end;
+    char const *name;
+    zpl_isize name_len;
+    zpl_b8 in_object;
+    zpl_b8 cfg_mode; // NOTE: document root without enclosing braces
+} zpl_json_cursor;
+
+//! Make a cursor pointing at the root value of the document.
+ZPL_DEF zpl_json_cursor zpl_json_cursor_make(char const *text, zpl_isize len);
+
+//! Check whether the cursor points at a value.
+ZPL_DEF_INLINE zpl_b32 zpl_json_cursor_valid(zpl_json_cursor const *c);
+
+//! Type of the value, booleans, null and the non-finite constants report ZPL_ADT_TYPE_REAL as in zpl_json_parse.
+ZPL_DEF zpl_u8 zpl_json_cursor_type(zpl_json_cursor const *c);
+
+//! Field of an object by name.
+ZPL_DEF zpl_json_cursor zpl_json_cursor_find(zpl_json_cursor const *c, char const *name);
+
+//! Element of an array, or member of an object, by position.
+ZPL_DEF zpl_json_cursor zpl_json_cursor_at(zpl_json_cursor const *c, zpl_isize index);
+
+//! Follow a path such as "a/b/3/c", numeric segments index arrays, the rest name object fields.
+ZPL_DEF zpl_json_cursor zpl_json_cursor_query(zpl_json_cursor const *c, char const *path);
+
+//! Point child at the first member of an object or array, returns false when it is empty or not a container.
+ZPL_DEF zpl_b32 zpl_json_cursor_first(zpl_json_cursor const *c, zpl_json_cursor *child);
+
+//! Advance to the next sibling, skipping the current value's subtree. Returns false past the last one.
+ZPL_DEF zpl_b32 zpl_json_cursor_next(zpl_json_cursor *c);
+
+//! Number of members of an object or array.
+ZPL_DEF zpl_isize zpl_json_cursor_count(zpl_json_cursor const *c);
+
+//! Text of the whole value, including quotes and brackets.
+ZPL_DEF char const *zpl_json_cursor_raw(zpl_json_cursor const *c, zpl_isize *len);
+
+//! Body of a string value, NULL if the value is not a string.
+ZPL_DEF char const *zpl_json_cursor_str(zpl_json_cursor const *c, zpl_isize *len);
+
+//! Copy of a string value, NULL if the value is not a string.
+ZPL_DEF zpl_string zpl_json_cursor_string(zpl_json_cursor const *c, zpl_allocator a);
+
+ZPL_DEF zpl_i64 zpl_json_cursor_integer(zpl_json_cursor const *c, zpl_i64 fallback);
+ZPL_DEF zpl_f64 zpl_json_cursor_real(zpl_json_cursor const *c, zpl_f64 fallback);
+ZPL_DEF zpl_b32 zpl_json_cursor_bool(zpl_json_cursor const *c, zpl_b32 fallback);
+ZPL_DEF zpl_b32 zpl_json_cursor_is_null(zpl_json_cursor const *c);
+
+ZPL_IMPL_INLINE zpl_b32 zpl_json_cursor_valid(zpl_json_cursor const *c) {
+    return c && c->value != NULL;
+}
+
+ZPL_END_C_DECLS
@@ -0,0 +1,54 @@
+// file: header/parsers/json_lines.h
+
+
+////////////////////////////////////////////////////////////////
+//
+// JSON Lines (NDJSON) Reader
+//
+// Parses a buffer of newline-delimited JSON5 records with zpl_json_parse. The buffer is split into chunks at line
+// boundaries and the chunks are handed to a job system, so they can be parsed by several threads at once. Any speedup
+// depends on the cores the machine has, apps/examples/json_lines_benchmark.c measures it. Every participating thread
+// allocates the trees from its own virtual memory arena, so workers never contend on the allocator. Records come back
+// in input order.
+// Blank lines are skipped. The text has to be zero-terminated at len and is modified in place, as zpl_json_parse does.
+// NOTE: Available when both the parser and the jobs modules are enabled.
+//
+// Usage:
+//     zpl_json_lines lines;
+//     zpl_json_lines_parse(&lines, text, text_len, &jobs, zpl_heap());
+//     for (zpl_isize i = 0; i < lines.count; ++i) use(&lines.records[i]);
+//     zpl_json_lines_free(&lines);
+//
+
+ZPL_BEGIN_C_DECLS
+
+//! Size of the address range each per-thread arena reserves at once.
+#ifndef ZPL_JSON_LINES_ARENA_RESERVE
+#define ZPL_JSON_LINES_ARENA_RESERVE zpl_megabytes(64)
+#endif
+
+//! Smallest chunk of input handed to a single job.
+#ifndef ZPL_JSON_LINES_MIN_CHUNK
+#define ZPL_JSON_LINES_MIN_CHUNK zpl_kilobytes(64)
+#endif
+
+typedef struct zpl_json_lines {
+    zpl_allocator backing;
+    zpl_json_object *records; // NOTE: one root per non-blank line, in input order
+    zpl_isize count;
+
+    zpl_arena *arenas;       // NOTE: one per thread that took part, they own all nodes below the roots
+    zpl_isize arena_count;
+
+    zpl_u8 error;            // NOTE: zpl_json_error of the first record that failed to parse
+    zpl_isize error_record;  // NOTE: index of that record, -1 if all records parsed
+} zpl_json_lines;
+
+//! Parse newline-delimited records from text. Pass NULL as the pool to parse on the calling thread only.
+//! On failure, records after error_record may be left uninitialised.
+ZPL_DEF zpl_u8 zpl_json_lines_parse(zpl_json_lines *lines, char *text, zpl_isize len, zpl_jobs_system *pool, zpl_allocator backing);
+
+//! Release the records and the per-thread arenas.
+ZPL_DEF void zpl_json_lines_free(zpl_json_lines *lines);
+
+ZPL_END_C_DECLS
@@ -0,0 +1,88 @@
+// file: header/parsers/json_stream.h
+
+
+////////////////////////////////////////////////////////////////
+//
+// JSON5 Streaming Parser
+//
+// Push parser for documents that arrive in pieces (files read in chunks, socket receives, pipes).
+// Chunks may be split anywhere, the parser reports the document as a sequence of SAX style events and never holds
+// more than the container nesting and the longest pending string, name or number, so memory stays bounded regardless
+// of the document size. Several root values may follow each other (e.g. newline-delimited records).
+//
+// Accepts the same dialect as zpl_json_parse: comments, unquoted and single-quoted names, `multi-line strings`,
+// trailing commas, =/| assignments, newline delimiters and cfg mode documents without braces around the root.
+// NOTE: Strings are reported raw, escape sequences are kept just like zpl_json_parse keeps them.
+//
+// Usage:
+//     zpl_json_stream s;
+//     zpl_json_stream_init(&s, zpl_heap(), my_proc, my_data);
+//     while (more input) zpl_json_stream_feed(&s, chunk, chunk_len);
+//     err = zpl_json_stream_finish(&s);
+//     zpl_json_stream_free(&s);
+//
+
+ZPL_BEGIN_C_DECLS
+
+#ifndef ZPL_JSON_STREAM_CHUNK_SIZE
+#define ZPL_JSON_STREAM_CHUNK_SIZE zpl_kilobytes(64)
+#endif
+
+typedef enum zpl_json_event_type {
+    ZPL_JSON_EVENT_OBJECT_BEGIN,
+    ZPL_JSON_EVENT_OBJECT_END,
+    ZPL_JSON_EVENT_ARRAY_BEGIN,
+    ZPL_JSON_EVENT_ARRAY_END,
+    ZPL_JSON_EVENT_VALUE,
+} zpl_json_event_type;
+
+typedef struct zpl_json_event {
+    zpl_u8 type;
+    zpl_isize depth; // NOTE: nesting level of the event's container, root values are at 0
+
+    // NOTE: name is the member name inside objects (NULL in arrays). Leaf values use the type, props and data fields
+    // as zpl_json_parse fills them. Strings and names only live until the callback returns.
+    zpl_adt_node node;
+} zpl_json_event;
+
+//! Receives every event, return false to stop the stream.
+typedef zpl_b32 (*zpl_json_stream_proc)(void *user_data, zpl_json_event const *event);
+
+typedef struct zpl_json_stream {
+    zpl_allocator backing;
+    zpl_json_stream_proc proc;
+    void *user_data;
+
+    zpl_array(zpl_u8) stack;
+    zpl_array(char) name;
+    zpl_array(char) token;
+    zpl_isize max_token; // NOTE: 0 for no limit on string, name and number length
+
+    zpl_u8 state;
+    zpl_u8 lex;
+    zpl_u8 quote;
+    zpl_u8 error;
+    zpl_b8 has_name;
+    zpl_b8 escaped;
+    zpl_b8 started;
+
+    zpl_isize line;
+    zpl_i64 offset; // NOTE: bytes consumed so far
+} zpl_json_stream;
+
+//! Initialize a streaming parser, the backing allocator holds its token buffers and container stack.
+ZPL_DEF zpl_u8 zpl_json_stream_init(zpl_json_stream *s, zpl_allocator backing, zpl_json_stream_proc proc, void *user_data);
+
+//! Release the parser's buffers.
+ZPL_DEF void zpl_json_stream_free(zpl_json_stream *s);
+
+//! Push the next chunk of input, returns a zpl_json_error. Errors are sticky, later chunks are ignored.
+ZPL_DEF zpl_u8 zpl_json_stream_feed(zpl_json_stream *s, void const *data, zpl_isize size);
+
+//! Signal the end of input, flushes a pending value and reports containers that were left open.
+ZPL_DEF zpl_u8 zpl_json_stream_finish(zpl_json_stream *s);
+
+//! Feed the rest of a file in ZPL_JSON_STREAM_CHUNK_SIZE pieces and finish the stream.
+ZPL_DEF zpl_u8 zpl_json_stream_file(zpl_json_stream *s, zpl_file *f);
+
+ZPL_END_C_DECLS
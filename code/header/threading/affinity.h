@@ -23,7 +23,33 @@ ZPL_BEGIN_C_DECLS
         zpl_isize threads_per_core;
     } zpl_affinity;
 
-#elif defined(ZPL_SYSTEM_LINUX) || defined(ZPL_SYSTEM_FREEBSD) || defined(ZPL_SYSTEM_EMSCRIPTEN) || defined(ZPL_SYSTEM_OPENBSD)
+#elif defined(ZPL_SYSTEM_LINUX)
+
+    //! Logical CPUs past this limit are left out of the topology and is_accurate is cleared.
+#    ifndef ZPL_AFFINITY_MAX_THREADS
+#    define ZPL_AFFINITY_MAX_THREADS 256
+#    endif
+
+    typedef struct zpl_affinity_core {
+        zpl_i32 first;   //!< Index of the core's first logical CPU in zpl_affinity::cpus.
+        zpl_i32 threads; //!< Number of online SMT siblings.
+        zpl_i32 node;    //!< NUMA node the core belongs to.
+        zpl_i32 l2;      //!< Lowest logical CPU sharing this core's L2 cache, -1 if unknown.
+        zpl_i32 l3;      //!< Lowest logical CPU sharing this core's L3 cache, -1 if unknown.
+    } zpl_affinity_core;
+
+    typedef struct zpl_affinity {
+        zpl_b32   is_accurate;
+        zpl_isize core_count;
+        zpl_isize thread_count;
+        zpl_isize threads_per_core;
+        zpl_isize node_count;
+
+        zpl_affinity_core cores[ZPL_AFFINITY_MAX_THREADS];
+        zpl_i32           cpus[ZPL_AFFINITY_MAX_THREADS]; //!< Logical CPU ids grouped by physical core.
+    } zpl_affinity;
+
+#elif defined(ZPL_SYSTEM_FREEBSD) || defined(ZPL_SYSTEM_EMSCRIPTEN) || defined(ZPL_SYSTEM_OPENBSD)
 
     typedef struct zpl_affinity {
         zpl_b32   is_accurate;
@@ -0,0 +1,102 @@
+// file: header/threading/alloc_profiler.h
+
+////////////////////////////////////////////////////////////////
+//
+// Allocation Profiler
+//
+// Wraps any allocator and records statistics per allocation site: allocation/free counts, requested bytes,
+// a power-of-two size histogram, lifetimes of freed blocks and live/peak usage.
+//
+// Sites are the named scopes opened by zpl_alloc_profiler_push/zpl_alloc_profiler_push_here on the allocating thread,
+// nested scopes form a call tree. Allocations made outside of any scope are accounted to the root site.
+// The results can be printed as a table or written as folded stacks ("a;b;c 1234" per line), the input format
+// of flamegraph.pl, inferno and speedscope.
+//
+// Every block carries a small header in front of it that keeps its site, size and allocation time.
+// Lifetimes are measured in zpl_rdtsc ticks since most blocks live shorter than the millisecond timers resolve.
+// NOTE: Scopes are per thread and shared by all profilers, bookkeeping memory comes from the heap allocator.
+//
+
+ZPL_BEGIN_C_DECLS
+
+#ifndef ZPL_ALLOC_PROFILER_MAX_DEPTH
+#define ZPL_ALLOC_PROFILER_MAX_DEPTH 32
+#endif
+
+//! Bucket i counts requests of up to 16 << i bytes, the last one everything bigger.
+#define ZPL_ALLOC_PROFILER_BUCKETS 20
+
+typedef struct zpl_alloc_site {
+    char const *name;
+    zpl_i32 line; // NOTE: 0 for named scopes, the name holds the file otherwise
+    zpl_isize parent; // NOTE: -1 for the root site
+    zpl_isize alloc_count;
+    zpl_isize free_count;
+    zpl_isize resize_count;
+    zpl_isize total_bytes;
+    zpl_isize live_bytes;
+    zpl_isize peak_bytes;
+    zpl_u64 total_lifetime; // NOTE: zpl_rdtsc ticks, freed blocks only
+    zpl_u64 max_lifetime;
+    zpl_isize histogram[ZPL_ALLOC_PROFILER_BUCKETS];
+} zpl_alloc_site;
+
+ZPL_FLAT_TABLE_DECLARE(ZPL_DEF, zpl__alloc_site_map, zpl__alloc_site_map_, zpl_isize);
+
+typedef struct zpl_alloc_profiler {
+    zpl_allocator backing;
+    zpl_mutex lock;
+    zpl_u32 id;
+    zpl_array(zpl_alloc_site) sites; // NOTE: sites[0] is the root
+    zpl__alloc_site_map site_map;
+
+    zpl_isize alloc_count;
+    zpl_isize free_count;
+    zpl_isize total_bytes;
+    zpl_isize live_bytes;
+    zpl_isize peak_bytes;
+} zpl_alloc_profiler;
+
+typedef enum zpl_alloc_profiler_metric {
+    ZPL_ALLOC_PROFILER_BYTES,
+    ZPL_ALLOC_PROFILER_COUNT,
+    ZPL_ALLOC_PROFILER_LIVE,
+} zpl_alloc_profiler_metric;
+
+//! Initialize allocation profiler in front of the backing allocator.
+ZPL_DEF void zpl_alloc_profiler_init(zpl_alloc_profiler *p, zpl_allocator backing);
+
+//! Release the profiler's bookkeeping, blocks still allocated through it stay owned by the backing allocator.
+ZPL_DEF void zpl_alloc_profiler_free(zpl_alloc_profiler *p);
+
+//! Open a named allocation scope on the calling thread, the name has to outlive the profiler.
+ZPL_DEF void zpl_alloc_profiler_push(char const *name);
+
+//! Open an allocation scope named after a source location.
+ZPL_DEF void zpl_alloc_profiler_push_at(char const *file, zpl_i32 line);
+
+//! Open an allocation scope named after the current source location.
+#define zpl_alloc_profiler_push_here() zpl_alloc_profiler_push_at(__FILE__, __LINE__)
+
+//! Close the innermost allocation scope of the calling thread.
+ZPL_DEF void zpl_alloc_profiler_pop(void);
+
+//! Print per-site statistics sorted by requested bytes.
+ZPL_DEF void zpl_alloc_profiler_report(zpl_alloc_profiler *p, zpl_file *f);
+
+//! Write folded stacks weighted by the chosen metric, suitable for flamegraph tools.
+ZPL_DEF void zpl_alloc_profiler_write_folded(zpl_alloc_profiler *p, zpl_file *f, zpl_alloc_profiler_metric metric);
+
+//! Allocation Types: alloc, free, free_all, resize (whatever the backing allocator supports).
+//! free_all is passed on without touching the live statistics, the profiler cannot tell whether the backing honoured it.
+ZPL_DEF_INLINE zpl_allocator zpl_alloc_profiler_allocator(zpl_alloc_profiler *p);
+ZPL_DEF ZPL_ALLOCATOR_PROC(zpl_alloc_profiler_allocator_proc);
+
+ZPL_IMPL_INLINE zpl_allocator zpl_alloc_profiler_allocator(zpl_alloc_profiler *p) {
+    zpl_allocator allocator;
+    allocator.proc = zpl_alloc_profiler_allocator_proc;
+    allocator.data = p;
+    return allocator;
+}
+
+ZPL_END_C_DECLS
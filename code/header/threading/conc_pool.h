@@ -0,0 +1,51 @@
+// file: header/threading/conc_pool.h
+
+////////////////////////////////////////////////////////////////
+//
+// Concurrent Pool Allocator
+//
+// Thread-safe counterpart of zpl_pool for fixed-size blocks shared by many threads (e.g. job messages).
+// The free list is a lock-free stack whose head carries a modification tag next to the pointer, so a block
+// that is popped and pushed back between another thread's read and CAS cannot be mistaken for the old head (ABA).
+// On exhaustion a new slab is taken from the backing allocator and pushed as a whole, slabs are only released
+// by zpl_conc_pool_free.
+//
+
+ZPL_BEGIN_C_DECLS
+
+typedef struct zpl_conc_pool {
+    zpl_atomic64 free_list; // NOTE: tagged head, see source/threading/conc_pool.c
+    zpl_u8 free_list_pad[ZPL_CACHE_LINE_SIZE - zpl_size_of(zpl_atomic64)];
+    zpl_atomic_ptr slabs;
+    zpl_allocator backing;
+    zpl_isize block_size;
+    zpl_isize block_align;
+    zpl_isize num_blocks;
+} zpl_conc_pool;
+
+//! Initialize concurrent pool allocator, each slab holds num_blocks blocks.
+ZPL_DEF_INLINE void zpl_conc_pool_init(zpl_conc_pool *pool, zpl_allocator backing, zpl_isize num_blocks, zpl_isize block_size);
+
+//! Initialize concurrent pool allocator with specific block alignment.
+ZPL_DEF void zpl_conc_pool_init_align(zpl_conc_pool *pool, zpl_allocator backing, zpl_isize num_blocks, zpl_isize block_size,
+                                      zpl_isize block_align);
+
+//! Release all slabs of the concurrent pool allocator.
+ZPL_DEF void zpl_conc_pool_free(zpl_conc_pool *pool);
+
+//! Allocation Types: alloc, free, free_all (the latter must not race with other operations)
+ZPL_DEF_INLINE zpl_allocator zpl_conc_pool_allocator(zpl_conc_pool *pool);
+ZPL_DEF ZPL_ALLOCATOR_PROC(zpl_conc_pool_allocator_proc);
+
+ZPL_IMPL_INLINE void zpl_conc_pool_init(zpl_conc_pool *pool, zpl_allocator backing, zpl_isize num_blocks, zpl_isize block_size) {
+    zpl_conc_pool_init_align(pool, backing, num_blocks, block_size, ZPL_DEFAULT_MEMORY_ALIGNMENT);
+}
+
+ZPL_IMPL_INLINE zpl_allocator zpl_conc_pool_allocator(zpl_conc_pool *pool) {
+    zpl_allocator allocator;
+    allocator.proc = zpl_conc_pool_allocator_proc;
+    allocator.data = pool;
+    return allocator;
+}
+
+ZPL_END_C_DECLS
@@ -0,0 +1,268 @@
+// file: header/threading/conc_ring.h
+
+/** @file conc_ring.c
+@brief Instantiated lock-free ring buffers
+@defgroup conc_ring Instantiated lock-free ring buffers
+
+
+ Thread-safe counterparts of ZPL_RING. Capacity is rounded up to a power of two so indices wrap with a mask,
+ producer and consumer indices live on separate cache lines, and nothing is overwritten when the ring is full:
+ push reports failure instead and the caller decides whether to retry, drop or block.
+
+ ZPL_SPSC_RING is a single-producer/single-consumer ring. Each side keeps a private copy of the other side's index
+ and only re-reads the shared one when the copy says the ring is full or empty, so the hot path touches no shared line.
+
+ ZPL_MPMC_RING is a multi-producer/multi-consumer ring with a sequence number per cell (Dmitry Vyukov's design).
+ Batch operations claim a run of cells with a single CAS.
+
+ Ring type and function declaration, call: ZPL_SPSC_RING_DECLARE(PREFIX, NAME, FUNC, VALUE) or ZPL_MPMC_RING_DECLARE
+ Ring function definitions, call: ZPL_SPSC_RING_DEFINE(NAME, FUNC, VALUE) or ZPL_MPMC_RING_DEFINE
+
+     PREFIX  - a prefix for function prototypes e.g. extern, static, etc.
+     NAME    - Name of the ring type
+     FUNC    - the name will prefix function names
+     VALUE   - the type of the value to be stored
+
+    funcname_init(NAME * r, zpl_allocator a, zpl_isize capacity); // returns false if the allocation failed
+    funcname_free(NAME * r);
+    funcname_push(NAME * r, VALUE value);                          // returns false if the ring is full
+    funcname_push_batch(NAME * r, VALUE const *values, zpl_isize count); // returns the number of pushed values
+    funcname_pop(NAME * r, VALUE * value);                        // returns false if the ring is empty
+    funcname_pop_batch(NAME * r, VALUE * values, zpl_isize count); // returns the number of popped values
+    funcname_count(NAME * r);                                      // approximate while other threads are active
+
+ @{
+*/
+
+ZPL_BEGIN_C_DECLS
+
+#define ZPL_SPSC_RING(PREFIX, NAME, FUNC, VALUE)                                                                    \
+    ZPL_SPSC_RING_DECLARE(PREFIX, NAME, FUNC, VALUE);                                                               \
+    ZPL_SPSC_RING_DEFINE(NAME, FUNC, VALUE);
+
+#define ZPL_MPMC_RING(PREFIX, NAME, FUNC, VALUE)                                                                    \
+    ZPL_MPMC_RING_DECLARE(PREFIX, NAME, FUNC, VALUE);                                                               \
+    ZPL_MPMC_RING_DEFINE(NAME, FUNC, VALUE);
+
+#define ZPL__CONC_RING_INTERFACE(PREFIX, NAME, FUNC, VALUE)                                                         \
+    PREFIX zpl_b32   ZPL_JOIN2(FUNC, init)          (NAME *r, zpl_allocator a, zpl_isize capacity);                 \
+    PREFIX void      ZPL_JOIN2(FUNC, free)          (NAME *r);                                                      \
+    PREFIX zpl_b32   ZPL_JOIN2(FUNC, push)          (NAME *r, VALUE value);                                         \
+    PREFIX zpl_isize ZPL_JOIN2(FUNC, push_batch)    (NAME *r, VALUE const *values, zpl_isize count);                \
+    PREFIX zpl_b32   ZPL_JOIN2(FUNC, pop)           (NAME *r, VALUE *value);                                        \
+    PREFIX zpl_isize ZPL_JOIN2(FUNC, pop_batch)     (NAME *r, VALUE *values, zpl_isize count);                      \
+    PREFIX zpl_isize ZPL_JOIN2(FUNC, count)         (NAME *r);
+
+/**
+ * Single-producer/single-consumer ring
+ */
+
+#define ZPL_SPSC_RING_DECLARE(PREFIX, NAME, FUNC, VALUE)                                                            \
+    typedef struct NAME {                                                                                           \
+        zpl_atomic64 head;                                                                                          \
+        zpl_i64 tail_cache;                                                                                         \
+        zpl_u8 head_pad[ZPL_CACHE_LINE_SIZE - 2 * zpl_size_of(zpl_i64)];                                            \
+        zpl_atomic64 tail;                                                                                          \
+        zpl_i64 head_cache;                                                                                         \
+        zpl_u8 tail_pad[ZPL_CACHE_LINE_SIZE - 2 * zpl_size_of(zpl_i64)];                                            \
+        zpl_allocator backing;                                                                                      \
+        VALUE *buf;                                                                                                 \
+        zpl_i64 mask;                                                                                               \
+    } NAME;                                                                                                         \
+                                                                                                                    \
+    ZPL__CONC_RING_INTERFACE(PREFIX, NAME, FUNC, VALUE)
+
+#define ZPL_SPSC_RING_DEFINE(NAME, FUNC, VALUE)                                                                     \
+    zpl_b32 ZPL_JOIN2(FUNC, init)(NAME * r, zpl_allocator a, zpl_isize capacity) {                                  \
+        NAME r_ = { 0 };                                                                                            \
+        zpl_i64 size = 2;                                                                                           \
+        while (size < capacity) size <<= 1;                                                                         \
+        *r = r_;                                                                                                    \
+        r->backing = a;                                                                                             \
+        r->mask = size - 1;                                                                                         \
+        r->buf = cast(VALUE *)zpl_alloc_uninit(a, size * zpl_size_of(VALUE));                                       \
+        zpl_atomic64_store(&r->head, 0);                                                                            \
+        zpl_atomic64_store(&r->tail, 0);                                                                            \
+        return r->buf != NULL;                                                                                      \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, free)(NAME * r) {                                                                          \
+        zpl_free(r->backing, r->buf);                                                                               \
+        r->buf = NULL;                                                                                              \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_isize ZPL_JOIN2(FUNC, push_batch)(NAME * r, VALUE const *values, zpl_isize count) {                         \
+        zpl_i64 head = zpl_atomic64_load(&r->head);                                                                 \
+        zpl_i64 space = r->mask + 1 - (head - r->tail_cache);                                                       \
+        zpl_i64 first;                                                                                              \
+        if (space < count) {                                                                                        \
+            r->tail_cache = zpl_atomic64_load(&r->tail);                                                            \
+            space = r->mask + 1 - (head - r->tail_cache);                                                           \
+        }                                                                                                           \
+        if (count > space) count = cast(zpl_isize)space;                                                            \
+        if (count <= 0) return 0;                                                                                   \
+        first = zpl_min(count, r->mask + 1 - (head & r->mask));                                                     \
+        zpl_memcopy(r->buf + (head & r->mask), values, first * zpl_size_of(VALUE));                                 \
+        zpl_memcopy(r->buf, values + first, (count - first) * zpl_size_of(VALUE));                                  \
+        zpl_atomic64_store(&r->head, head + count);                                                                 \
+        return count;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_b32 ZPL_JOIN2(FUNC, push)(NAME * r, VALUE value) {                                                          \
+        zpl_i64 head = zpl_atomic64_load(&r->head);                                                                 \
+        if (head - r->tail_cache > r->mask) {                                                                       \
+            r->tail_cache = zpl_atomic64_load(&r->tail);                                                            \
+            if (head - r->tail_cache > r->mask) return false;                                                       \
+        }                                                                                                           \
+        r->buf[head & r->mask] = value;                                                                             \
+        zpl_atomic64_store(&r->head, head + 1);                                                                     \
+        return true;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_isize ZPL_JOIN2(FUNC, pop_batch)(NAME * r, VALUE * values, zpl_isize count) {                               \
+        zpl_i64 tail = zpl_atomic64_load(&r->tail);                                                                 \
+        zpl_i64 avail = r->head_cache - tail;                                                                       \
+        zpl_i64 first;                                                                                              \
+        if (avail < count) {                                                                                        \
+            r->head_cache = zpl_atomic64_load(&r->head);                                                            \
+            avail = r->head_cache - tail;                                                                           \
+        }                                                                                                           \
+        if (count > avail) count = cast(zpl_isize)avail;                                                            \
+        if (count <= 0) return 0;                                                                                   \
+        first = zpl_min(count, r->mask + 1 - (tail & r->mask));                                                     \
+        zpl_memcopy(values, r->buf + (tail & r->mask), first * zpl_size_of(VALUE));                                 \
+        zpl_memcopy(values + first, r->buf, (count - first) * zpl_size_of(VALUE));                                  \
+        zpl_atomic64_store(&r->tail, tail + count);                                                                 \
+        return count;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_b32 ZPL_JOIN2(FUNC, pop)(NAME * r, VALUE * value) {                                                         \
+        zpl_i64 tail = zpl_atomic64_load(&r->tail);                                                                 \
+        if (tail == r->head_cache) {                                                                                \
+            r->head_cache = zpl_atomic64_load(&r->head);                                                            \
+            if (tail == r->head_cache) return false;                                                                \
+        }                                                                                                           \
+        *value = r->buf[tail & r->mask];                                                                            \
+        zpl_atomic64_store(&r->tail, tail + 1);                                                                     \
+        return true;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_isize ZPL_JOIN2(FUNC, count)(NAME * r) {                                                                    \
+        return cast(zpl_isize)(zpl_atomic64_load(&r->head) - zpl_atomic64_load(&r->tail));                          \
+    }
+
+/**
+ * Multi-producer/multi-consumer ring
+ */
+
+#define ZPL_MPMC_RING_DECLARE(PREFIX, NAME, FUNC, VALUE)                                                            \
+    typedef struct ZPL_JOIN2(NAME, Cell) {                                                                          \
+        zpl_atomic64 sequence;                                                                                      \
+        VALUE value;                                                                                                \
+    } ZPL_JOIN2(NAME, Cell);                                                                                        \
+                                                                                                                    \
+    typedef struct NAME {                                                                                           \
+        zpl_atomic64 head;                                                                                          \
+        zpl_u8 head_pad[ZPL_CACHE_LINE_SIZE - zpl_size_of(zpl_atomic64)];                                           \
+        zpl_atomic64 tail;                                                                                          \
+        zpl_u8 tail_pad[ZPL_CACHE_LINE_SIZE - zpl_size_of(zpl_atomic64)];                                           \
+        zpl_allocator backing;                                                                                      \
+        ZPL_JOIN2(NAME, Cell) *cells;                                                                               \
+        zpl_i64 mask;                                                                                               \
+    } NAME;                                                                                                         \
+                                                                                                                    \
+    ZPL__CONC_RING_INTERFACE(PREFIX, NAME, FUNC, VALUE)
+
+#define ZPL_MPMC_RING_DEFINE(NAME, FUNC, VALUE)                                                                     \
+    zpl_b32 ZPL_JOIN2(FUNC, init)(NAME * r, zpl_allocator a, zpl_isize capacity) {                                  \
+        NAME r_ = { 0 };                                                                                            \
+        zpl_i64 size = 2;                                                                                           \
+        while (size < capacity) size <<= 1;                                                                         \
+        *r = r_;                                                                                                    \
+        r->backing = a;                                                                                             \
+        r->mask = size - 1;                                                                                         \
+        r->cells = cast(ZPL_JOIN2(NAME, Cell) *)zpl_alloc_uninit(a, size * zpl_size_of(ZPL_JOIN2(NAME, Cell)));     \
+        if (!r->cells) return false;                                                                                \
+        for (zpl_i64 i = 0; i < size; ++i) zpl_atomic64_store(&r->cells[i].sequence, i);                            \
+        zpl_atomic64_store(&r->head, 0);                                                                            \
+        zpl_atomic64_store(&r->tail, 0);                                                                            \
+        return true;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, free)(NAME * r) {                                                                          \
+        zpl_free(r->backing, r->cells);                                                                             \
+        r->cells = NULL;                                                                                            \
+    }                                                                                                               \
+                                                                                                                    \
+    /* NOTE: Claims up to `count` consecutive free cells with one CAS on the tail */                                \
+    zpl_isize ZPL_JOIN2(FUNC, push_batch)(NAME * r, VALUE const *values, zpl_isize count) {                         \
+        zpl_i64 pos = zpl_atomic64_load(&r->tail);                                                                  \
+        zpl_i64 reserved;                                                                                           \
+        for (;;) {                                                                                                  \
+            zpl_i64 prev;                                                                                           \
+            reserved = 0;                                                                                           \
+            while (reserved < count && reserved <= r->mask &&                                                       \
+                   zpl_atomic64_load(&r->cells[(pos + reserved) & r->mask].sequence) == pos + reserved) {           \
+                ++reserved;                                                                                         \
+            }                                                                                                       \
+            if (reserved == 0) {                                                                                    \
+                if (count <= 0 || zpl_atomic64_load(&r->cells[pos & r->mask].sequence) < pos) return 0;             \
+                pos = zpl_atomic64_load(&r->tail);                                                                  \
+                continue;                                                                                           \
+            }                                                                                                       \
+            prev = zpl_atomic64_compare_exchange(&r->tail, pos, pos + reserved);                                    \
+            if (prev == pos) break;                                                                                 \
+            pos = prev;                                                                                             \
+        }                                                                                                           \
+        for (zpl_i64 i = 0; i < reserved; ++i) {                                                                    \
+            ZPL_JOIN2(NAME, Cell) *cell = &r->cells[(pos + i) & r->mask];                                           \
+            cell->value = values[i];                                                                                \
+            zpl_atomic64_store(&cell->sequence, pos + i + 1);                                                       \
+        }                                                                                                           \
+        return cast(zpl_isize)reserved;                                                                             \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_b32 ZPL_JOIN2(FUNC, push)(NAME * r, VALUE value) {                                                          \
+        return ZPL_JOIN2(FUNC, push_batch)(r, &value, 1) == 1;                                                      \
+    }                                                                                                               \
+                                                                                                                    \
+    /* NOTE: Claims up to `count` consecutive published cells with one CAS on the head */                           \
+    zpl_isize ZPL_JOIN2(FUNC, pop_batch)(NAME * r, VALUE * values, zpl_isize count) {                               \
+        zpl_i64 pos = zpl_atomic64_load(&r->head);                                                                  \
+        zpl_i64 reserved;                                                                                           \
+        for (;;) {                                                                                                  \
+            zpl_i64 prev;                                                                                           \
+            reserved = 0;                                                                                           \
+            while (reserved < count && reserved <= r->mask &&                                                       \
+                   zpl_atomic64_load(&r->cells[(pos + reserved) & r->mask].sequence) == pos + reserved + 1) {       \
+                ++reserved;                                                                                         \
+            }                                                                                                       \
+            if (reserved == 0) {                                                                                    \
+                if (count <= 0 || zpl_atomic64_load(&r->cells[pos & r->mask].sequence) < pos + 1) return 0;         \
+                pos = zpl_atomic64_load(&r->head);                                                                  \
+                continue;                                                                                           \
+            }                                                                                                       \
+            prev = zpl_atomic64_compare_exchange(&r->head, pos, pos + reserved);                                    \
+            if (prev == pos) break;                                                                                 \
+            pos = prev;                                                                                             \
+        }                                                                                                           \
+        for (zpl_i64 i = 0; i < reserved; ++i) {                                                                    \
+            ZPL_JOIN2(NAME, Cell) *cell = &r->cells[(pos + i) & r->mask];                                           \
+            values[i] = cell->value;                                                                                \
+            zpl_atomic64_store(&cell->sequence, pos + i + r->mask + 1);                                             \
+        }                                                                                                           \
+        return cast(zpl_isize)reserved;                                                                             \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_b32 ZPL_JOIN2(FUNC, pop)(NAME * r, VALUE * value) {                                                         \
+        return ZPL_JOIN2(FUNC, pop_batch)(r, value, 1) == 1;                                                        \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_isize ZPL_JOIN2(FUNC, count)(NAME * r) {                                                                    \
+        zpl_i64 count = zpl_atomic64_load(&r->tail) - zpl_atomic64_load(&r->head);                                  \
+        return cast(zpl_isize)(count < 0 ? 0 : count);                                                              \
+    }
+
+//! @}
+
+ZPL_END_C_DECLS
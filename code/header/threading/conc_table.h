@@ -0,0 +1,285 @@
+// file: header/threading/conc_table.h
+
+/** @file conc_table.c
+@brief Instantiated concurrent hash table
+@defgroup conc_table Instantiated concurrent hash table
+
+
+ Thread-safe hash table split into ZPL_CONC_TABLE_SHARDS independently locked shards, each an open-addressing
+ table laid out like ZPL_FLAT_TABLE. Writers take the shard's zpl_mutex and bump its sequence counter around
+ every change. Readers take no lock at all: they read the shard optimistically and retry if the sequence
+ counter was odd or changed meanwhile (seqlock), so lookups never write to shared memory and scale with threads.
+
+ Because readers may still be probing a shard's previous slot array while a writer grows it, replaced arrays
+ are kept until clear or destroy. They add up to less than the live array, as capacity doubles on every grow.
+
+ NOTE: Values are copied out on lookup, pointers into the table are never handed out.
+
+ Hash table type and function declaration, call: ZPL_CONC_TABLE_DECLARE(PREFIX, NAME, FUNC, VALUE)
+ Hash table function definitions, call: ZPL_CONC_TABLE_DEFINE(NAME, FUNC, VALUE)
+
+     PREFIX  - a prefix for function prototypes e.g. extern, static, etc.
+     NAME    - Name of the Hash Table
+     FUNC    - the name will prefix function names
+     VALUE   - the type of the value to be stored
+
+    tablename_init(NAME * h, zpl_allocator a);
+    tablename_destroy(NAME * h);
+    tablename_clear(NAME * h);
+    tablename_get(NAME * h, zpl_u64 key, VALUE *value); // returns true if found
+    tablename_set(NAME * h, zpl_u64 key, VALUE value);
+    tablename_remove(NAME * h, zpl_u64 key); // returns true if removed
+    tablename_count(NAME * h);
+
+ @{
+*/
+
+ZPL_BEGIN_C_DECLS
+
+#ifndef ZPL_CONC_TABLE_SHARDS
+#define ZPL_CONC_TABLE_SHARDS 64
+#endif
+
+/**
+ * Combined macro for a quick delcaration + definition
+ */
+
+#define ZPL_CONC_TABLE(PREFIX, NAME, FUNC, VALUE)                                                                   \
+    ZPL_CONC_TABLE_DECLARE(PREFIX, NAME, FUNC, VALUE);                                                              \
+    ZPL_CONC_TABLE_DEFINE(NAME, FUNC, VALUE);
+
+/**
+ * Table delcaration macro that generates the interface
+ */
+
+#define ZPL_CONC_TABLE_DECLARE(PREFIX, NAME, FUNC, VALUE)                                                           \
+    typedef struct ZPL_JOIN2(NAME, Entry) {                                                                         \
+        zpl_u64 key;                                                                                                \
+        VALUE value;                                                                                                \
+    } ZPL_JOIN2(NAME, Entry);                                                                                       \
+                                                                                                                    \
+    typedef struct ZPL_JOIN2(NAME, Slots) {                                                                         \
+        zpl_isize capacity;                                                                                         \
+        struct ZPL_JOIN2(NAME, Slots) *retired;                                                                     \
+        zpl_u8 *ctrl;                                                                                               \
+        ZPL_JOIN2(NAME, Entry) *entries;                                                                            \
+    } ZPL_JOIN2(NAME, Slots);                                                                                       \
+                                                                                                                    \
+    typedef struct ZPL_JOIN2(NAME, Shard) {                                                                         \
+        zpl_atomic64 seq;                                                                                           \
+        zpl_atomic_ptr slots;                                                                                       \
+        zpl_isize count;                                                                                            \
+        zpl_mutex lock;                                                                                             \
+        zpl_u8 pad[ZPL_CACHE_LINE_SIZE];                                                                            \
+    } ZPL_JOIN2(NAME, Shard);                                                                                       \
+                                                                                                                    \
+    typedef struct NAME {                                                                                           \
+        zpl_allocator allocator;                                                                                    \
+        ZPL_JOIN2(NAME, Shard) *shards;                                                                             \
+    } NAME;                                                                                                         \
+                                                                                                                    \
+    PREFIX void      ZPL_JOIN2(FUNC, init)          (NAME *h, zpl_allocator a);                                     \
+    PREFIX void      ZPL_JOIN2(FUNC, destroy)       (NAME *h);                                                      \
+    PREFIX void      ZPL_JOIN2(FUNC, clear)         (NAME *h);                                                      \
+    PREFIX zpl_b32   ZPL_JOIN2(FUNC, get)           (NAME *h, zpl_u64 key, VALUE *value);                           \
+    PREFIX void      ZPL_JOIN2(FUNC, set)           (NAME *h, zpl_u64 key, VALUE value);                            \
+    PREFIX zpl_b32   ZPL_JOIN2(FUNC, remove)        (NAME *h, zpl_u64 key);                                         \
+    PREFIX zpl_isize ZPL_JOIN2(FUNC, count)         (NAME *h);
+
+/**
+ * Table definition interfaces that generates the implementation
+ */
+
+#define ZPL_CONC_TABLE_DEFINE(NAME, FUNC, VALUE)                                                                    \
+    void ZPL_JOIN2(FUNC, init)(NAME * h, zpl_allocator a) {                                                         \
+        h->allocator = a;                                                                                           \
+        h->shards = cast(ZPL_JOIN2(NAME, Shard) *)zpl_alloc(a, ZPL_CONC_TABLE_SHARDS * zpl_size_of(ZPL_JOIN2(NAME, Shard))); \
+        zpl_zero_size(h->shards, ZPL_CONC_TABLE_SHARDS * zpl_size_of(ZPL_JOIN2(NAME, Shard)));                      \
+        for (zpl_isize i = 0; i < ZPL_CONC_TABLE_SHARDS; ++i) zpl_mutex_init(&h->shards[i].lock);                   \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal void ZPL_JOIN2(FUNC, _release)(NAME * h, ZPL_JOIN2(NAME, Shard) * s) {                             \
+        ZPL_JOIN2(NAME, Slots) *slots = cast(ZPL_JOIN2(NAME, Slots) *)zpl_atomic_ptr_load(&s->slots);               \
+        while (slots) {                                                                                             \
+            ZPL_JOIN2(NAME, Slots) *retired = slots->retired;                                                       \
+            zpl_free(h->allocator, slots);                                                                          \
+            slots = retired;                                                                                        \
+        }                                                                                                           \
+        zpl_atomic_ptr_store(&s->slots, NULL);                                                                      \
+        s->count = 0;                                                                                               \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, destroy)(NAME * h) {                                                                       \
+        for (zpl_isize i = 0; i < ZPL_CONC_TABLE_SHARDS; ++i) {                                                     \
+            ZPL_JOIN2(FUNC, _release)(h, &h->shards[i]);                                                            \
+            zpl_mutex_destroy(&h->shards[i].lock);                                                                  \
+        }                                                                                                           \
+        zpl_free(h->allocator, h->shards);                                                                          \
+        h->shards = NULL;                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    /* NOTE: Not safe against concurrent readers, readers may still hold the released slot arrays */               \
+    void ZPL_JOIN2(FUNC, clear)(NAME * h) {                                                                         \
+        for (zpl_isize i = 0; i < ZPL_CONC_TABLE_SHARDS; ++i) {                                                     \
+            ZPL_JOIN2(NAME, Shard) *s = &h->shards[i];                                                              \
+            zpl_mutex_lock(&s->lock);                                                                               \
+            zpl_atomic64_fetch_add(&s->seq, 1);                                                                     \
+            ZPL_JOIN2(FUNC, _release)(h, s);                                                                        \
+            zpl_atomic64_fetch_add(&s->seq, 1);                                                                     \
+            zpl_mutex_unlock(&s->lock);                                                                             \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal ZPL_JOIN2(NAME, Shard) *ZPL_JOIN2(FUNC, _shard)(NAME * h, zpl_u64 hash) {                          \
+        return &h->shards[(hash >> 48) & (ZPL_CONC_TABLE_SHARDS - 1)];                                              \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal void ZPL_JOIN2(FUNC, _set_ctrl)(ZPL_JOIN2(NAME, Slots) * t, zpl_isize index, zpl_u8 value) {       \
+        t->ctrl[index] = value;                                                                                     \
+        if (index < ZPL_FLAT_TABLE_GROUP) t->ctrl[t->capacity + index] = value;                                     \
+    }                                                                                                               \
+                                                                                                                    \
+    /* NOTE: Bounded so that a reader racing a writer can not spin on a half-written control array */              \
+    zpl_internal zpl_isize ZPL_JOIN2(FUNC, _find)(ZPL_JOIN2(NAME, Slots) * t, zpl_u64 key, zpl_u64 hash) {          \
+        zpl_isize mask = t->capacity - 1;                                                                           \
+        zpl_isize pos = cast(zpl_isize)(hash >> 7) & mask;                                                          \
+        for (zpl_isize probed = 0; probed < t->capacity; probed += ZPL_FLAT_TABLE_GROUP) {                          \
+            zpl_u8 const *group = t->ctrl + pos;                                                                    \
+            zpl_u64 m = zpl__flat_table_match(group, cast(zpl_u8)(hash & 0x7f));                                    \
+            while (m) {                                                                                             \
+                zpl_isize index = (pos + zpl__flat_table_bit(m)) & mask;                                            \
+                if (t->entries[index].key == key) return index;                                                     \
+                m &= m - 1;                                                                                         \
+            }                                                                                                       \
+            if (zpl__flat_table_empty(group)) return -1;                                                            \
+            pos = (pos + ZPL_FLAT_TABLE_GROUP) & mask;                                                              \
+        }                                                                                                           \
+        return -1;                                                                                                  \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal zpl_isize ZPL_JOIN2(FUNC, _find_empty)(ZPL_JOIN2(NAME, Slots) * t, zpl_u64 hash) {                 \
+        zpl_isize mask = t->capacity - 1;                                                                           \
+        zpl_isize pos = cast(zpl_isize)(hash >> 7) & mask;                                                          \
+        for (;;) {                                                                                                  \
+            zpl_u64 m = zpl__flat_table_empty(t->ctrl + pos);                                                       \
+            if (m) return (pos + zpl__flat_table_bit(m)) & mask;                                                    \
+            pos = (pos + ZPL_FLAT_TABLE_GROUP) & mask;                                                              \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_internal ZPL_JOIN2(NAME, Slots) *ZPL_JOIN2(FUNC, _grow)(NAME * h, ZPL_JOIN2(NAME, Slots) * old) {           \
+        zpl_isize capacity = old ? old->capacity * 2 : ZPL_FLAT_TABLE_GROUP;                                        \
+        ZPL_JOIN2(NAME, Slots) *t = cast(ZPL_JOIN2(NAME, Slots) *)zpl_alloc(h->allocator,                           \
+            zpl_size_of(ZPL_JOIN2(NAME, Slots)) + capacity * zpl_size_of(ZPL_JOIN2(NAME, Entry)) + capacity + ZPL_FLAT_TABLE_GROUP); \
+        t->capacity = capacity;                                                                                     \
+        t->retired = old;                                                                                           \
+        t->entries = cast(ZPL_JOIN2(NAME, Entry) *)(t + 1);                                                         \
+        t->ctrl = cast(zpl_u8 *)(t->entries + capacity);                                                            \
+        zpl_memset(t->ctrl, ZPL_FLAT_TABLE_EMPTY, capacity + ZPL_FLAT_TABLE_GROUP);                                 \
+        for (zpl_isize i = 0; old && i < old->capacity; ++i) {                                                      \
+            zpl_isize index;                                                                                        \
+            if (old->ctrl[i] & ZPL_FLAT_TABLE_EMPTY) continue;                                                      \
+            index = ZPL_JOIN2(FUNC, _find_empty)(t, zpl_flat_table_hash(old->entries[i].key));                      \
+            ZPL_JOIN2(FUNC, _set_ctrl)(t, index, old->ctrl[i]);                                                     \
+            t->entries[index] = old->entries[i];                                                                    \
+        }                                                                                                           \
+        return t;                                                                                                   \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_b32 ZPL_JOIN2(FUNC, get)(NAME * h, zpl_u64 key, VALUE * value) {                                            \
+        zpl_u64 hash = zpl_flat_table_hash(key);                                                                    \
+        ZPL_JOIN2(NAME, Shard) *s = ZPL_JOIN2(FUNC, _shard)(h, hash);                                               \
+        for (;;) {                                                                                                  \
+            zpl_b32 found = false;                                                                                  \
+            zpl_i64 seq = zpl_atomic64_load(&s->seq);                                                               \
+            ZPL_JOIN2(NAME, Slots) *t;                                                                              \
+            if (seq & 1) {                                                                                          \
+                zpl_yield_thread();                                                                                 \
+                continue;                                                                                           \
+            }                                                                                                       \
+            t = cast(ZPL_JOIN2(NAME, Slots) *)zpl_atomic_ptr_load(&s->slots);                                       \
+            if (t) {                                                                                                \
+                zpl_isize index = ZPL_JOIN2(FUNC, _find)(t, key, hash);                                             \
+                if (index >= 0) {                                                                                   \
+                    *value = t->entries[index].value;                                                               \
+                    found = true;                                                                                   \
+                }                                                                                                   \
+            }                                                                                                       \
+            zpl_acquire_fence();                                                                                    \
+            if (zpl_atomic64_load(&s->seq) == seq) return found;                                                    \
+        }                                                                                                           \
+    }                                                                                                               \
+                                                                                                                    \
+    void ZPL_JOIN2(FUNC, set)(NAME * h, zpl_u64 key, VALUE value) {                                                 \
+        zpl_u64 hash = zpl_flat_table_hash(key);                                                                    \
+        ZPL_JOIN2(NAME, Shard) *s = ZPL_JOIN2(FUNC, _shard)(h, hash);                                               \
+        ZPL_JOIN2(NAME, Slots) *t;                                                                                  \
+        zpl_isize index;                                                                                            \
+        zpl_mutex_lock(&s->lock);                                                                                   \
+        t = cast(ZPL_JOIN2(NAME, Slots) *)zpl_atomic_ptr_load(&s->slots);                                           \
+        index = t ? ZPL_JOIN2(FUNC, _find)(t, key, hash) : -1;                                                      \
+        if (index < 0 && (!t || (s->count + 1) * 4 > t->capacity * 3)) {                                           \
+            /* NOTE: The grown copy is private until published, readers keep using the old one meanwhile */         \
+            t = ZPL_JOIN2(FUNC, _grow)(h, t);                                                                       \
+            zpl_atomic_ptr_store(&s->slots, t);                                                                     \
+        }                                                                                                           \
+        zpl_atomic64_fetch_add(&s->seq, 1);                                                                         \
+        /* NOTE: Readers must see the odd sequence before any of the entry stores below */                          \
+        zpl_release_fence();                                                                                        \
+        if (index < 0) {                                                                                            \
+            index = ZPL_JOIN2(FUNC, _find_empty)(t, hash);                                                          \
+            t->entries[index].key = key;                                                                            \
+            ZPL_JOIN2(FUNC, _set_ctrl)(t, index, cast(zpl_u8)(hash & 0x7f));                                        \
+            s->count++;                                                                                             \
+        }                                                                                                           \
+        t->entries[index].value = value;                                                                            \
+        zpl_release_fence();                                                                                        \
+        zpl_atomic64_fetch_add(&s->seq, 1);                                                                         \
+        zpl_mutex_unlock(&s->lock);                                                                                 \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_b32 ZPL_JOIN2(FUNC, remove)(NAME * h, zpl_u64 key) {                                                        \
+        zpl_u64 hash = zpl_flat_table_hash(key);                                                                    \
+        ZPL_JOIN2(NAME, Shard) *s = ZPL_JOIN2(FUNC, _shard)(h, hash);                                               \
+        ZPL_JOIN2(NAME, Slots) *t;                                                                                  \
+        zpl_isize index, mask, hole, next;                                                                          \
+        zpl_mutex_lock(&s->lock);                                                                                   \
+        t = cast(ZPL_JOIN2(NAME, Slots) *)zpl_atomic_ptr_load(&s->slots);                                           \
+        index = t ? ZPL_JOIN2(FUNC, _find)(t, key, hash) : -1;                                                      \
+        if (index < 0) {                                                                                            \
+            zpl_mutex_unlock(&s->lock);                                                                             \
+            return false;                                                                                           \
+        }                                                                                                           \
+        zpl_atomic64_fetch_add(&s->seq, 1);                                                                         \
+        zpl_release_fence();                                                                                        \
+        mask = t->capacity - 1;                                                                                     \
+        hole = index;                                                                                               \
+        for (next = (hole + 1) & mask; !(t->ctrl[next] & ZPL_FLAT_TABLE_EMPTY); next = (next + 1) & mask) {         \
+            zpl_isize home = cast(zpl_isize)(zpl_flat_table_hash(t->entries[next].key) >> 7) & mask;                \
+            if (((next - home) & mask) >= ((next - hole) & mask)) {                                                 \
+                t->entries[hole] = t->entries[next];                                                                \
+                ZPL_JOIN2(FUNC, _set_ctrl)(t, hole, t->ctrl[next]);                                                 \
+                hole = next;                                                                                        \
+            }                                                                                                       \
+        }                                                                                                           \
+        ZPL_JOIN2(FUNC, _set_ctrl)(t, hole, ZPL_FLAT_TABLE_EMPTY);                                                  \
+        s->count--;                                                                                                 \
+        zpl_release_fence();                                                                                        \
+        zpl_atomic64_fetch_add(&s->seq, 1);                                                                         \
+        zpl_mutex_unlock(&s->lock);                                                                                 \
+        return true;                                                                                                \
+    }                                                                                                               \
+                                                                                                                    \
+    zpl_isize ZPL_JOIN2(FUNC, count)(NAME * h) {                                                                    \
+        zpl_isize count = 0;                                                                                        \
+        for (zpl_isize i = 0; i < ZPL_CONC_TABLE_SHARDS; ++i) {                                                     \
+            zpl_mutex_lock(&h->shards[i].lock);                                                                     \
+            count += h->shards[i].count;                                                                            \
+            zpl_mutex_unlock(&h->shards[i].lock);                                                                   \
+        }                                                                                                           \
+        return count;                                                                                               \
+    }
+
+//! @}
+
+ZPL_END_C_DECLS
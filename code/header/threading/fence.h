@@ -9,4 +9,10 @@ ZPL_DEF void zpl_mfence      (void);
 ZPL_DEF void zpl_sfence      (void);
 ZPL_DEF void zpl_lfence      (void);
 
+//! Orders earlier loads before later loads and stores; compiles to a compiler barrier on x86.
+ZPL_DEF void zpl_acquire_fence(void);
+
+//! Orders earlier loads and stores before later stores; compiles to a compiler barrier on x86.
+ZPL_DEF void zpl_release_fence(void);
+
 ZPL_END_C_DECLS
@@ -0,0 +1,68 @@
+// file: header/threading/slab.h
+
+////////////////////////////////////////////////////////////////
+//
+// Slab Allocator
+//
+// General purpose allocator for many small, short-lived allocations (ADT nodes, strings, arrays).
+//
+// Requests are rounded up to one of ZPL_SLAB_CLASS_COUNT size classes. Blocks of a class are carved out of
+// ZPL_SLAB_SPAN_SIZE aligned spans, so a block finds its span header by masking its address.
+// Every thread gets its own cache with a magazine (intrusive free list) per size class, hence allocation and
+// freeing on the owning thread never touch shared state. A block freed by another thread is pushed onto the
+// owner's lock-free remote list for that class; the owner takes the whole list once its magazine runs dry.
+//
+// Requests above ZPL_SLAB_MAX_SIZE go straight to the backing allocator with the requested alignment. They are
+// recognised by a small header in front of the block that holds a back-pointer tag keyed per slab.
+// A thread that is about to exit should call zpl_slab_thread_detach so another thread can adopt its cache,
+// otherwise the memory stays reserved until zpl_slab_free.
+//
+
+ZPL_BEGIN_C_DECLS
+
+#ifndef ZPL_SLAB_SPAN_SIZE
+#define ZPL_SLAB_SPAN_SIZE zpl_kilobytes(64)
+#endif
+
+#define ZPL_SLAB_CLASS_COUNT 18
+#define ZPL_SLAB_MAX_SIZE zpl_kilobytes(8)
+
+typedef struct zpl__slab_cache {
+    struct zpl__slab_cache *next;
+    zpl_atomic32 in_use;
+    zpl_atomic32 owner_id;
+    void *magazines[ZPL_SLAB_CLASS_COUNT];
+    zpl_u8 *bump[ZPL_SLAB_CLASS_COUNT];
+    zpl_u8 *bump_end[ZPL_SLAB_CLASS_COUNT];
+    void *spans;
+    zpl_atomic_ptr remote[ZPL_SLAB_CLASS_COUNT];
+} zpl__slab_cache;
+
+typedef struct zpl_slab {
+    zpl_allocator backing;
+    zpl_atomic_ptr caches;
+    zpl_u32 id;
+    zpl_uintptr large_key;
+} zpl_slab;
+
+//! Initialize slab allocator, spans are taken from the backing allocator.
+ZPL_DEF void zpl_slab_init(zpl_slab *slab, zpl_allocator backing);
+
+//! Release all memory held by the slab allocator.
+ZPL_DEF void zpl_slab_free(zpl_slab *slab);
+
+//! Hand the calling thread's cache over to other threads.
+ZPL_DEF void zpl_slab_thread_detach(zpl_slab *slab);
+
+//! Allocation Types: alloc, free, resize
+ZPL_DEF_INLINE zpl_allocator zpl_slab_allocator(zpl_slab *slab);
+ZPL_DEF ZPL_ALLOCATOR_PROC(zpl_slab_allocator_proc);
+
+ZPL_IMPL_INLINE zpl_allocator zpl_slab_allocator(zpl_slab *slab) {
+    zpl_allocator allocator;
+    allocator.proc = zpl_slab_allocator_proc;
+    allocator.data = slab;
+    return allocator;
+}
+
+ZPL_END_C_DECLS
@@ -111,7 +111,7 @@ zpl_internal zpl_adt_node *zpl__adt_get_field(zpl_adt_node *node, char *name, ch
     return NULL;
 }
 
-zpl_adt_node *zpl_adt_query(zpl_adt_node *node, char const *uri) {
+zpl_internal zpl_adt_node *zpl__adt_query(zpl_adt_node *node, char const *uri) {
     ZPL_ASSERT_NOT_NULL(uri);
 
     if (*uri == '/') {
@@ -188,7 +188,7 @@ zpl_adt_node *zpl_adt_query(zpl_adt_node *node, char const *uri) {
 
         /* go deeper if uri continues */
         if (*e) {
-            return zpl_adt_query(found_node, e+1);
+            return zpl__adt_query(found_node, e+1);
         }
     }
     /* handle field name lookup */
@@ -197,7 +197,7 @@ zpl_adt_node *zpl_adt_query(zpl_adt_node *node, char const *uri) {
 
         /* go deeper if uri continues */
         if (*e) {
-            return zpl_adt_query(found_node, e+1);
+            return zpl__adt_query(found_node, e+1);
         }
     }
     /* handle array index lookup */
@@ -208,7 +208,7 @@ zpl_adt_node *zpl_adt_query(zpl_adt_node *node, char const *uri) {
 
             /* go deeper if uri continues */
             if (*e) {
-                return zpl_adt_query(found_node, e+1);
+                return zpl__adt_query(found_node, e+1);
             }
         }
     }
@@ -216,6 +216,14 @@ zpl_adt_node *zpl_adt_query(zpl_adt_node *node, char const *uri) {
     return found_node;
 }
 
+zpl_adt_node *zpl_adt_query(zpl_adt_node *node, char const *uri) {
+    // NOTE: Path segments are copied into temporary memory, drop them once the lookup is done
+    zpl_arena_snapshot scratch = zpl_temp_snapshot_begin();
+    zpl_adt_node *found_node = zpl__adt_query(node, uri);
+    zpl_temp_snapshot_end(scratch);
+    return found_node;
+}
+
 zpl_adt_node *zpl_adt_alloc_at(zpl_adt_node *parent, zpl_isize index) {
     if (!parent || (parent->type != ZPL_ADT_TYPE_OBJECT && parent->type != ZPL_ADT_TYPE_ARRAY)) {
         return NULL;
@@ -616,6 +624,200 @@ zpl_adt_error zpl_adt_str_to_number_strict(zpl_adt_node *node) {
     return ZPL_ADT_ERROR_NONE;
 }
 
+/* tape */
+
+// NOTE: Parsers collect a whole document in a tape of nodes. Children wait on the pending stack until their branch
+// closes, then they move to the tape as one contiguous span preceded by room for a zpl_array_header, so every span
+// is the branch's zpl_array in place and the regular ADT API works on the result. The tape is a chain of chunks
+// that double in size and never move, so growing it copies nothing and the document costs a handful of
+// allocations instead of one per branch.
+
+typedef struct zpl__adt_tape_chunk {
+    struct zpl__adt_tape_chunk *next;
+    zpl_isize capacity; // NOTE: in node slots, including the ones this header occupies
+} zpl__adt_tape_chunk;
+
+typedef struct {
+    zpl_allocator backing;
+    zpl__adt_tape_chunk *chunks; // NOTE: the last one holds this owner
+    zpl_isize refs;              // NOTE: spans and moved-out arrays still handed out through zpl__adt_tape_allocator_proc
+} zpl__adt_tape_owner;
+
+typedef struct {
+    zpl_allocator backing;
+    zpl__adt_tape_owner *owner;
+    zpl_isize used; // NOTE: node slots taken in the newest chunk
+    zpl_array(zpl_adt_node) pending;
+    zpl_isize spans;
+} zpl__adt_tape;
+
+#define ZPL__ADT_TAPE_SLOTS(type) ((zpl_size_of(type) + zpl_size_of(zpl_adt_node) - 1) / zpl_size_of(zpl_adt_node))
+
+#define ZPL__ADT_TAPE_MIN_CHUNK 64
+
+zpl_internal void zpl__adt_tape_free_chunks(zpl_allocator backing, zpl__adt_tape_chunk *c) {
+    while (c) {
+        zpl__adt_tape_chunk *next = c->next;
+        zpl_free(backing, c);
+        c = next;
+    }
+}
+
+zpl_internal void zpl__adt_tape_release(zpl__adt_tape_owner *o) {
+    if (--o->refs == 0) {
+        zpl__adt_tape_free_chunks(o->backing, o->chunks);
+    }
+}
+
+zpl_internal zpl_b32 zpl__adt_tape_owns(zpl__adt_tape_owner *o, void *ptr) {
+    for (zpl__adt_tape_chunk *c = o->chunks; c; c = c->next) {
+        zpl_adt_node *nodes = cast(zpl_adt_node *)c;
+        if (cast(zpl_adt_node *)ptr >= nodes && cast(zpl_adt_node *)ptr < nodes + c->capacity) return true;
+    }
+    return false;
+}
+
+/* children of a moved array point their own children at the new place, the same fix-up zpl__adt_tape_close does */
+zpl_internal void zpl__adt_tape_reparent(zpl_array_header *h) {
+    zpl_adt_node *nodes = cast(zpl_adt_node *)(h + 1);
+    for (zpl_isize i = 0; i < zpl_min(h->count, h->capacity); ++i) {
+        zpl_adt_node *n = nodes + i;
+        if ((n->type == ZPL_ADT_TYPE_OBJECT || n->type == ZPL_ADT_TYPE_ARRAY) && n->nodes) {
+            for (zpl_isize j = 0; j < zpl_array_count(n->nodes); ++j) n->nodes[j].parent = n;
+        }
+    }
+}
+
+/* spans live inside the tape and are released with it, arrays that outgrow their span move to the backing allocator */
+zpl_internal ZPL_ALLOCATOR_PROC(zpl__adt_tape_allocator_proc) {
+    zpl__adt_tape_owner *o = cast(zpl__adt_tape_owner *)allocator_data;
+    void *ptr = NULL;
+    zpl_unused(flags);
+
+    switch (type) {
+        case ZPL_ALLOCATION_ALLOC: {
+            ptr = zpl_alloc_align(o->backing, size, alignment);
+            if (ptr) ++o->refs;
+        } break;
+
+        case ZPL_ALLOCATION_FREE: {
+            if (!zpl__adt_tape_owns(o, old_memory)) zpl_free(o->backing, old_memory);
+            zpl__adt_tape_release(o);
+        } break;
+
+        case ZPL_ALLOCATION_RESIZE: {
+            if (!zpl__adt_tape_owns(o, old_memory)) {
+                ptr = zpl_resize_align(o->backing, old_memory, old_size, size, alignment);
+            } else {
+                ptr = zpl_alloc_align(o->backing, size, alignment);
+                if (ptr) zpl_memcopy(ptr, old_memory, zpl_min(old_size, size));
+            }
+            // NOTE: zpl_array_grow hands the array header in, the nodes follow it
+            if (ptr && ptr != old_memory) zpl__adt_tape_reparent(cast(zpl_array_header *)ptr);
+        } break;
+
+        case ZPL_ALLOCATION_FREE_ALL: break;
+    }
+
+    return ptr;
+}
+
+/* starts a new chunk twice the size of the previous one with room for at least slots more nodes */
+zpl_internal zpl__adt_tape_chunk *zpl__adt_tape_grow(zpl__adt_tape *t, zpl_isize slots) {
+    zpl_isize header = ZPL__ADT_TAPE_SLOTS(zpl__adt_tape_chunk);
+    zpl_isize capacity = t->owner ? t->owner->chunks->capacity * 2 : ZPL__ADT_TAPE_MIN_CHUNK;
+    capacity = zpl_max(capacity, header + slots);
+
+    zpl__adt_tape_chunk *c = cast(zpl__adt_tape_chunk *)zpl_alloc(t->backing, capacity * zpl_size_of(zpl_adt_node));
+    if (!c) return NULL;
+    c->capacity = capacity;
+    c->next = NULL;
+    if (t->owner) {
+        c->next = t->owner->chunks;
+        t->owner->chunks = c;
+    }
+    t->used = header;
+    return c;
+}
+
+zpl_internal zpl_b32 zpl__adt_tape_init(zpl__adt_tape *t, zpl_allocator backing) {
+    zpl_zero_item(t);
+    t->backing = backing;
+
+    zpl__adt_tape_chunk *c = zpl__adt_tape_grow(t, ZPL__ADT_TAPE_SLOTS(zpl__adt_tape_owner));
+    if (!c) return false;
+    t->owner = cast(zpl__adt_tape_owner *)(cast(zpl_adt_node *)c + t->used);
+    t->owner->backing = backing;
+    t->owner->chunks = c;
+    t->owner->refs = 0;
+    t->used += ZPL__ADT_TAPE_SLOTS(zpl__adt_tape_owner);
+
+    if (!zpl_array_init(t->pending, backing)) {
+        zpl_free(backing, c);
+        return false;
+    }
+    return true;
+}
+
+zpl_internal void zpl__adt_tape_discard(zpl__adt_tape *t) {
+    zpl__adt_tape_free_chunks(t->backing, t->owner->chunks);
+    zpl_array_free(t->pending);
+    zpl_zero_item(t);
+}
+
+zpl_internal ZPL_ALWAYS_INLINE zpl_isize zpl__adt_tape_mark(zpl__adt_tape *t) {
+    return zpl_array_count(t->pending);
+}
+
+zpl_internal ZPL_ALWAYS_INLINE zpl_b32 zpl__adt_tape_push(zpl__adt_tape *t, zpl_adt_node const *node) {
+    return zpl_array_append(t->pending, *node);
+}
+
+/* moves the children pending since mark into a span that becomes the branch's array */
+zpl_internal zpl_b32 zpl__adt_tape_close(zpl__adt_tape *t, zpl_adt_node *branch, zpl_isize mark) {
+    zpl_isize count = zpl_array_count(t->pending) - mark;
+    zpl_isize slots = ZPL__ADT_TAPE_SLOTS(zpl_array_header) + count;
+    zpl__adt_tape_chunk *c = t->owner->chunks;
+
+    if (t->used + slots > c->capacity) {
+        c = zpl__adt_tape_grow(t, slots);
+        if (!c) return false;
+    }
+    zpl_adt_node *span = cast(zpl_adt_node *)c + t->used + ZPL__ADT_TAPE_SLOTS(zpl_array_header);
+    t->used += slots;
+    zpl_memcopy(span, t->pending + mark, count * zpl_size_of(zpl_adt_node));
+    zpl_array_count(t->pending) = mark;
+
+    zpl_array_header *h = ZPL_ARRAY_HEADER(span);
+    h->allocator.proc = zpl__adt_tape_allocator_proc;
+    h->allocator.data = t->owner;
+    h->elem_size = zpl_size_of(zpl_adt_node);
+    h->count = h->capacity = count;
+
+    /* the children moved, so their own children have to point at the new place */
+    for (zpl_isize i = 0; i < count; ++i) {
+        zpl_adt_node *n = span + i;
+        n->parent = branch;
+        if (n->type == ZPL_ADT_TYPE_OBJECT || n->type == ZPL_ADT_TYPE_ARRAY) {
+            for (zpl_isize j = 0; j < zpl_array_count(n->nodes); ++j) n->nodes[j].parent = n;
+        }
+    }
+
+    branch->nodes = span;
+    ++t->spans;
+    return true;
+}
+
+/* the root (a closed branch outside of the tape) takes ownership, each span holds a reference */
+zpl_internal void zpl__adt_tape_finish(zpl__adt_tape *t) {
+    t->owner->refs = t->spans;
+    zpl_array_free(t->pending);
+    zpl_zero_item(t);
+}
+
+#undef ZPL__ADT_TAPE_SLOTS
+#undef ZPL__ADT_TAPE_MIN_CHUNK
+
 #undef zpl__adt_fprintf
 
 ZPL_END_C_DECLS
@@ -432,7 +432,7 @@ zpl_file_contents zpl_file_read_contents(zpl_allocator a, zpl_b32 zero_terminate
     if (zpl_file_open(&file, filepath) == ZPL_FILE_ERROR_NONE) {
         zpl_isize file_size = cast(zpl_isize) zpl_file_size(&file);
         if (file_size > 0) {
-            result.data = zpl_alloc(a, zero_terminate ? file_size + 1 : file_size);
+            result.data = zpl_alloc_uninit(a, zero_terminate ? file_size + 1 : file_size);
             result.size = file_size;
             zpl_file_read_at(&file, result.data, result.size, 0);
             if (zero_terminate) {
@@ -477,7 +477,7 @@ char *zpl_file_read_lines(zpl_allocator alloc, zpl_array(char *)*lines, char con
     zpl_file_open(&f, filename);
     zpl_isize fsize = (zpl_isize)zpl_file_size(&f);
 
-    char *contents = (char *)zpl_alloc(alloc, fsize + 1);
+    char *contents = (char *)zpl_alloc_uninit(alloc, fsize + 1);
     zpl_file_read(&f, contents, fsize);
     contents[fsize] = 0;
     *lines = zpl_str_split_lines(alloc, contents, strip_whitespace);
@@ -176,7 +176,7 @@ char *zpl_path_get_full_name(zpl_allocator a, char const *path) {
         return NULL;
     }
 
-    new_path = zpl_alloc_array(a, char, new_len);
+    new_path = zpl_alloc_array_uninit(a, char, new_len);
     new_len1 = WideCharToMultiByte(CP_UTF8, WC_ERR_INVALID_CHARS, w_fullpath, cast(int) w_len, new_path,
                                    cast(int) new_len, NULL, NULL);
 
@@ -200,7 +200,7 @@ char *zpl_path_get_full_name(zpl_allocator a, char const *path) {
 
     len = zpl_strlen(fullpath);
 
-    result = zpl_alloc_array(a, char, len + 1);
+    result = zpl_alloc_array_uninit(a, char, len + 1);
     zpl_memmove(result, fullpath, len);
     result[len] = 0;
     zpl_free(a, p);
@@ -26,10 +26,11 @@ zpl_internal zpl_usize zpl__tar_checksum(zpl__tar_header *hr) {
 }
 
 zpl_internal zpl_b32 zpl__tar_write_null(zpl_file *archive, zpl_isize cnt) {
-    char *out = zpl_bprintf("%*r", cnt, '\0');
-    if (!zpl_file_write(archive, out, cnt))
-        return 0;
-    return 1;
+    zpl_arena_snapshot scratch = zpl_temp_snapshot_begin();
+    char *out = cast(char *)zpl_alloc(zpl_temp_allocator(), cnt);
+    zpl_b32 ok = out && zpl_file_write(archive, out, cnt);
+    zpl_temp_snapshot_end(scratch);
+    return ok ? 1 : 0;
 }
 
 zpl_isize zpl_tar_pack(zpl_file *archive, char const **paths, zpl_isize paths_len) {
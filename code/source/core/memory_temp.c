@@ -0,0 +1,91 @@
+// file: source/core/memory_temp.c
+
+////////////////////////////////////////////////////////////////
+//
+// Temporary Memory
+//
+//
+
+ZPL_BEGIN_C_DECLS
+
+typedef struct zpl__temp_state {
+    zpl_arena frames[2];
+    zpl_i32 current;
+    zpl_b32 ready;
+    zpl_b32 framed;
+} zpl__temp_state;
+
+zpl_global zpl_thread_local zpl__temp_state zpl__temp;
+
+zpl_internal zpl_arena *zpl__temp_arena(void) {
+    if (!zpl__temp.ready) {
+        zpl_arena_init_from_vm(&zpl__temp.frames[0], ZPL_TEMP_RESERVE_SIZE);
+        zpl_arena_init_from_vm(&zpl__temp.frames[1], ZPL_TEMP_RESERVE_SIZE);
+        if (!zpl__temp.frames[0].vm_block || !zpl__temp.frames[1].vm_block) {
+            // NOTE: Out of address space, try again next time
+            if (zpl__temp.frames[0].vm_block) zpl_arena_free(&zpl__temp.frames[0]);
+            if (zpl__temp.frames[1].vm_block) zpl_arena_free(&zpl__temp.frames[1]);
+            return NULL;
+        }
+        zpl__temp.current = 0;
+        zpl__temp.ready = true;
+    }
+    return &zpl__temp.frames[zpl__temp.current];
+}
+
+// NOTE: Unlike ZPL_ALLOCATION_FREE_ALL on a vm arena this keeps the committed pages, they are reused next frame
+zpl_internal void zpl__temp_rewind(zpl_arena *arena) {
+    zpl_arena_check(arena);
+    zpl__arena_vm_rewind(arena, NULL);
+    arena->total_allocated = 0;
+}
+
+void zpl_temp_reset(void) {
+    zpl__temp.framed = true;
+    if (!zpl__temp.ready) return;
+    zpl__temp.current ^= 1;
+    zpl__temp_rewind(&zpl__temp.frames[zpl__temp.current]);
+}
+
+zpl_arena_snapshot zpl_temp_snapshot_begin(void) {
+    zpl_arena *arena = zpl__temp_arena();
+    zpl_arena_snapshot none = { 0 };
+    return arena ? zpl_arena_snapshot_begin(arena) : none;
+}
+
+void zpl_temp_snapshot_end(zpl_arena_snapshot snapshot) {
+    if (snapshot.arena) zpl_arena_snapshot_end(snapshot);
+}
+
+zpl_b32 zpl_temp_framed(void) {
+    return zpl__temp.framed;
+}
+
+void zpl_temp_release(void) {
+    zpl__temp.framed = false;
+    if (!zpl__temp.ready) return;
+    zpl_arena_free(&zpl__temp.frames[0]);
+    zpl_arena_free(&zpl__temp.frames[1]);
+    zpl__temp.ready = false;
+}
+
+ZPL_ALLOCATOR_PROC(zpl_temp_allocator_proc) {
+    zpl_arena *arena = zpl__temp_arena();
+    zpl_unused(allocator_data);
+    if (!arena) return NULL;
+
+    if (!alignment) alignment = ZPL_DEFAULT_MEMORY_ALIGNMENT;
+
+    switch (type) {
+        case ZPL_ALLOCATION_FREE_ALL: {
+            zpl__temp_rewind(arena);
+        } break;
+
+        default: {
+            return zpl_arena_allocator_proc(arena, type, size, alignment, old_memory, old_size, flags);
+        }
+    }
+    return NULL;
+}
+
+ZPL_END_C_DECLS
@@ -24,6 +24,18 @@ zpl_virtual_memory zpl_vm(void *data, zpl_isize size) {
         return vm;
     }
 
+    zpl_virtual_memory zpl_vm_reserve(void *addr, zpl_isize size) {
+        zpl_virtual_memory vm;
+        ZPL_ASSERT(size > 0);
+        vm.data = VirtualAlloc(addr, size, MEM_RESERVE, PAGE_NOACCESS);
+        vm.size = size;
+        return vm;
+    }
+
+    zpl_b32 zpl_vm_commit(zpl_virtual_memory vm) {
+        return VirtualAlloc(vm.data, vm.size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+    }
+
     zpl_b32 zpl_vm_free(zpl_virtual_memory vm) {
         MEMORY_BASIC_INFORMATION info;
         while (vm.size > 0) {
@@ -81,6 +93,23 @@ zpl_virtual_memory zpl_vm(void *data, zpl_isize size) {
         return vm;
     }
 
+    zpl_virtual_memory zpl_vm_reserve(void *addr, zpl_isize size) {
+        zpl_virtual_memory vm;
+        int flags = MAP_ANONYMOUS | MAP_PRIVATE;
+#    if defined(MAP_NORESERVE)
+        flags |= MAP_NORESERVE;
+#    endif
+        ZPL_ASSERT(size > 0);
+        vm.data = mmap(addr, size, PROT_NONE, flags, -1, 0);
+        if (vm.data == MAP_FAILED) vm.data = NULL;
+        vm.size = size;
+        return vm;
+    }
+
+    zpl_b32 zpl_vm_commit(zpl_virtual_memory vm) {
+        return mprotect(vm.data, vm.size, PROT_READ | PROT_WRITE) == 0;
+    }
+
     zpl_b32 zpl_vm_free(zpl_virtual_memory vm) {
         munmap(vm.data, vm.size);
         return true;
@@ -101,7 +130,7 @@ zpl_virtual_memory zpl_vm(void *data, zpl_isize size) {
 
     zpl_b32 zpl_vm_purge(zpl_virtual_memory vm) {
         int err = madvise(vm.data, vm.size, MADV_DONTNEED);
-        return err != 0;
+        return err == 0;
     }
 
     zpl_isize zpl_virtual_memory_page_size(zpl_isize *alignment_out) {
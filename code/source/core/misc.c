@@ -20,7 +20,7 @@ const char *zpl_get_env(const char *name) {
     }
 
     zpl_isize ptr_size = zpl_strlen(ptr);
-    buffer = (char *)zpl_malloc(ptr_size * sizeof(char)+1);
+    buffer = (char *)zpl_alloc_uninit(zpl_heap_allocator( ), ptr_size * sizeof(char)+1);
     zpl_memcopy((char *)buffer, ptr, ptr_size+1);
     return buffer;
 }
@@ -11,25 +11,41 @@ zpl_isize zpl_printf_err_va(char const *fmt, va_list va) {
     return zpl_fprintf_va(zpl_file_get_standard(ZPL_FILE_STANDARD_ERROR), fmt, va);
 }
 
+// NOTE: Bounded scratch shared by the printf family, the text is written or copied out before the call returns
+zpl_global zpl_thread_local char zpl__printf_buf[ZPL_PRINTF_MAXLEN];
+
 zpl_isize zpl_fprintf_va(struct zpl_file *f, char const *fmt, va_list va) {
-    zpl_local_persist zpl_thread_local char buf[ZPL_PRINTF_MAXLEN];
-    zpl_isize len = zpl_snprintf_va(buf, zpl_size_of(buf), fmt, va);
-    zpl_b32 res = zpl_file_write(f, buf, len - 1); // NOTE: prevent extra whitespace
+    zpl_isize len = zpl_snprintf_va(zpl__printf_buf, zpl_size_of(zpl__printf_buf), fmt, va);
+    zpl_b32 res = zpl_file_write(f, zpl__printf_buf, len - 1); // NOTE: prevent extra whitespace
     return res ? len : -1;
 }
 
+// NOTE: Used by zpl_bprintf outside of temporary memory frames, kept apart so printing doesn't clobber its result
+zpl_global zpl_thread_local char zpl__bprintf_buf[ZPL_PRINTF_MAXLEN];
+
 char *zpl_bprintf_va(char const *fmt, va_list va) {
-    zpl_local_persist zpl_thread_local char buffer[ZPL_PRINTF_MAXLEN];
-    zpl_snprintf_va(buffer, zpl_size_of(buffer), fmt, va);
+    zpl_allocator a = zpl_temp_allocator();
+    char *buffer = NULL;
+    zpl_isize len;
+
+    // NOTE: Nothing would ever give temporary memory back on threads that don't reset it
+    if (zpl_temp_framed()) buffer = cast(char *)zpl_alloc_uninit(a, ZPL_PRINTF_MAXLEN);
+    if (!buffer) {
+        zpl_snprintf_va(zpl__bprintf_buf, zpl_size_of(zpl__bprintf_buf), fmt, va);
+        return zpl__bprintf_buf;
+    }
+    len = zpl_snprintf_va(buffer, ZPL_PRINTF_MAXLEN, fmt, va);
+
+    // NOTE: The buffer is the newest temporary allocation, so giving back the unused tail is free
+    if (len > 0) buffer = cast(char *)zpl_resize_uninit(a, buffer, ZPL_PRINTF_MAXLEN, len);
     return buffer;
 }
 
 zpl_isize zpl_asprintf_va(zpl_allocator allocator, char **buffer, char const *fmt, va_list va) {
-    zpl_local_persist zpl_thread_local char tmp[ZPL_PRINTF_MAXLEN];
-    ZPL_ASSERT_NOT_NULL(buffer);
     zpl_isize res;
-    res = zpl_snprintf_va(tmp, zpl_size_of(tmp), fmt, va);
-    *buffer = zpl_alloc_str(allocator, tmp);
+    ZPL_ASSERT_NOT_NULL(buffer);
+    res = zpl_snprintf_va(zpl__printf_buf, zpl_size_of(zpl__printf_buf), fmt, va);
+    *buffer = zpl_alloc_str(allocator, zpl__printf_buf);
     return res;
 }
 
@@ -5,7 +5,7 @@ ZPL_BEGIN_C_DECLS
 
 zpl_string zpl_string_make_reserve(zpl_allocator a, zpl_isize capacity) {
     zpl_isize header_size = zpl_size_of(zpl_string_header);
-    void *ptr = zpl_alloc(a, header_size + capacity + 1);
+    void *ptr = zpl_alloc_uninit(a, header_size + capacity + 1);
 
     zpl_string str;
     zpl_string_header *header;
@@ -26,7 +26,7 @@ zpl_string zpl_string_make_reserve(zpl_allocator a, zpl_isize capacity) {
 
 zpl_string zpl_string_make_length(zpl_allocator a, void const *init_str, zpl_isize num_bytes) {
     zpl_isize header_size = zpl_size_of(zpl_string_header);
-    void *ptr = zpl_alloc(a, header_size + num_bytes + 1);
+    void *ptr = zpl_alloc_uninit(a, header_size + num_bytes + 1);
 
     zpl_string str;
     zpl_string_header *header;
@@ -46,13 +46,20 @@ zpl_string zpl_string_make_length(zpl_allocator a, void const *init_str, zpl_isi
 }
 
 zpl_string zpl_string_sprintf_buf(zpl_allocator a, const char *fmt, ...) {
-    zpl_local_persist zpl_thread_local char buf[ZPL_PRINTF_MAXLEN] = { 0 };
+    zpl_b32 scratch = a.proc != zpl_temp_allocator_proc;
+    zpl_arena_snapshot mark = { 0 };
+    zpl_string str;
+    char *buf;
     va_list va;
+
+    if (scratch) mark = zpl_temp_snapshot_begin();
     va_start(va, fmt);
-    zpl_snprintf_va(buf, ZPL_PRINTF_MAXLEN, fmt, va);
+    buf = zpl_bprintf_va(fmt, va);
     va_end(va);
 
-    return zpl_string_make(a, buf);
+    str = buf ? zpl_string_make(a, buf) : NULL;
+    if (scratch) zpl_temp_snapshot_end(mark);
+    return str;
 }
 
 zpl_string zpl_string_sprintf(zpl_allocator a, char *buf, zpl_isize num_bytes, const char *fmt, ...) {
@@ -0,0 +1,58 @@
+// file: source/essentials/collections/str_table.c
+
+
+ZPL_BEGIN_C_DECLS
+
+zpl_u64 zpl_str_table_hash(void const *key, zpl_isize len) {
+    zpl_u8 const *p = cast(zpl_u8 const *)key;
+    zpl_u64 h = 0x9e3779b97f4a7c15ull ^ cast(zpl_u64)len;
+
+    // NOTE: Mix a word at a time, the finalizer takes care of avalanche
+    while (len >= 8) {
+        zpl_u64 w;
+        zpl_memcopy(&w, p, 8);
+        h = (h ^ w) * 0x9fb21c651e98df25ull;
+        h ^= h >> 29;
+        p += 8;
+        len -= 8;
+    }
+
+    if (len > 0) {
+        zpl_u64 w = 0;
+        zpl_memcopy(&w, p, len);
+        h = (h ^ w) * 0x9fb21c651e98df25ull;
+    }
+
+    return zpl_flat_table_hash(h);
+}
+
+ZPL_STR_TABLE_DEFINE(zpl_strintern, zpl__strintern_, zpl_u32);
+
+void zpl_strintern_init(zpl_strintern *s, zpl_allocator a) {
+    zpl__strintern_init(s, a);
+}
+
+void zpl_strintern_destroy(zpl_strintern *s) {
+    zpl__strintern_destroy(s);
+}
+
+char const *zpl_strintern_add(zpl_strintern *s, char const *str, zpl_isize len) {
+    zpl_u64 hash;
+    zpl_isize index;
+    if (len < 0) len = zpl__str_table_len(str);
+    hash = zpl_str_table_hash(str, len);
+    index = zpl__strintern__find(s, str, len, hash);
+    if (index < 0) {
+        index = zpl__strintern__insert(s, str, len, hash);
+        if (index < 0) return NULL;
+        s->entries[index].value = cast(zpl_u32)(s->count - 1);
+    }
+    return s->entries[index].key;
+}
+
+char const *zpl_strintern_get(zpl_strintern *s, char const *str, zpl_isize len) {
+    zpl_isize index = zpl__strintern_slot(s, str, len);
+    return index >= 0 ? s->entries[index].key : NULL;
+}
+
+ZPL_END_C_DECLS
@@ -20,6 +20,7 @@
 #    ifdef __MINGW32__
 #    define _aligned_malloc __mingw_aligned_malloc
 #    define _aligned_free  __mingw_aligned_free
+#    define _aligned_realloc __mingw_aligned_realloc
 #    endif //MINGW
 #endif
 
@@ -72,6 +73,18 @@ typedef struct zpl__heap_alloc_info {
     void *physical_start;
 } zpl__heap_alloc_info;
 
+#if !defined(ZPL_HEAP_ANALYSIS) && !defined(ZPL_SYSTEM_WINDOWS)
+// NOTE: Blocks from aligned_alloc/posix_memalign may be handed to realloc as long as its own alignment is enough.
+// glibc serves large blocks with mmap and grows those with mremap, so big buffers get remapped rather than copied.
+zpl_internal void *zpl__heap_realloc(void *old_memory, zpl_isize old_size, zpl_isize size, zpl_u64 flags) {
+    void *ptr = realloc(old_memory, size);
+    if (ptr && size > old_size && (flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO)) {
+        zpl_zero_size(zpl_pointer_add(ptr, old_size), size - old_size);
+    }
+    return ptr;
+}
+#endif
+
 ZPL_ALLOCATOR_PROC(zpl_heap_allocator_proc) {
     void *ptr = NULL;
     zpl_unused(allocator_data);
@@ -79,9 +92,9 @@ ZPL_ALLOCATOR_PROC(zpl_heap_allocator_proc) {
     if (!alignment) alignment = ZPL_DEFAULT_MEMORY_ALIGNMENT;
 
 #    ifdef ZPL_HEAP_ANALYSIS
+        // NOTE: The tracking info sits right below the returned pointer, which has to keep the requested alignment
         zpl_isize alloc_info_size = zpl_size_of(zpl__heap_alloc_info);
-        zpl_isize alloc_info_remainder = (alloc_info_size % alignment);
-        zpl_isize track_size = zpl_max(alloc_info_size, alignment) + alloc_info_remainder;
+        zpl_isize track_size = zpl_align_forward_i64(alloc_info_size, alignment);
         switch (type) {
             case ZPL_ALLOCATION_FREE: {
                 if (!old_memory) break;
@@ -105,12 +118,29 @@ ZPL_ALLOCATOR_PROC(zpl_heap_allocator_proc) {
         break;
         case ZPL_ALLOCATION_FREE: _aligned_free(old_memory); break;
         case ZPL_ALLOCATION_RESIZE: {
+#    if !defined(ZPL_HEAP_ANALYSIS)
+            // NOTE: _aligned_realloc must be given the alignment the block was allocated with, which we don't record.
+            // Only the default alignment takes the fast path, anything else is moved into a freshly aligned block.
+            if (old_memory && size > 0 && alignment == ZPL_DEFAULT_MEMORY_ALIGNMENT &&
+                (cast(zpl_uintptr)old_memory & (alignment - 1)) == 0) {
+                ptr = _aligned_realloc(old_memory, size, alignment);
+                if (ptr && size > old_size && (flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO)) {
+                    zpl_zero_size(zpl_pointer_add(ptr, old_size), size - old_size);
+                }
+                break;
+            }
+#    endif
             zpl_allocator a = zpl_heap_allocator();
-            ptr = zpl_default_resize_align(a, old_memory, old_size, size, alignment);
+            ptr = zpl_default_resize_align_with_flags(a, old_memory, old_size, size, alignment, flags);
         } break;
 
 #elif defined(ZPL_SYSTEM_LINUX) && !defined(ZPL_CPU_ARM) && !defined(ZPL_COMPILER_TINYC)
         case ZPL_ALLOCATION_ALLOC: {
+            // NOTE: calloc gets fresh pages from the OS that are already zeroed, skip the memset for them
+            if ((flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO) && alignment <= ZPL_DEFAULT_MEMORY_ALIGNMENT) {
+                ptr = calloc(1, size);
+                break;
+            }
             ptr = aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
 
             if (flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO) { zpl_zero_size(ptr, size); }
@@ -121,11 +151,21 @@ ZPL_ALLOCATOR_PROC(zpl_heap_allocator_proc) {
         } break;
 
         case ZPL_ALLOCATION_RESIZE: {
+#    if !defined(ZPL_HEAP_ANALYSIS)
+            if (old_memory && size > 0 && alignment <= ZPL_DEFAULT_MEMORY_ALIGNMENT) {
+                ptr = zpl__heap_realloc(old_memory, old_size, size, flags);
+                break;
+            }
+#    endif
             zpl_allocator a = zpl_heap_allocator();
-            ptr = zpl_default_resize_align(a, old_memory, old_size, size, alignment);
+            ptr = zpl_default_resize_align_with_flags(a, old_memory, old_size, size, alignment, flags);
         } break;
 #else
         case ZPL_ALLOCATION_ALLOC: {
+            if ((flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO) && alignment <= ZPL_DEFAULT_MEMORY_ALIGNMENT) {
+                ptr = calloc(1, size);
+                break;
+            }
             posix_memalign(&ptr, alignment, size);
 
             if (flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO) { zpl_zero_size(ptr, size); }
@@ -136,8 +176,14 @@ ZPL_ALLOCATOR_PROC(zpl_heap_allocator_proc) {
         } break;
 
         case ZPL_ALLOCATION_RESIZE: {
+#    if !defined(ZPL_HEAP_ANALYSIS)
+            if (old_memory && size > 0 && alignment <= ZPL_DEFAULT_MEMORY_ALIGNMENT) {
+                ptr = zpl__heap_realloc(old_memory, old_size, size, flags);
+                break;
+            }
+#    endif
             zpl_allocator a = zpl_heap_allocator( );
-            ptr = zpl_default_resize_align(a, old_memory, old_size, size, alignment);
+            ptr = zpl_default_resize_align_with_flags(a, old_memory, old_size, size, alignment, flags);
         } break;
 #endif
 
@@ -146,7 +192,7 @@ ZPL_ALLOCATOR_PROC(zpl_heap_allocator_proc) {
 
 #    ifdef ZPL_HEAP_ANALYSIS
         if (type == ZPL_ALLOCATION_ALLOC) {
-            zpl__heap_alloc_info *alloc_info = cast(zpl__heap_alloc_info *)(cast(char *)ptr + alloc_info_remainder);
+            zpl__heap_alloc_info *alloc_info = cast(zpl__heap_alloc_info *)(cast(char *)ptr + track_size - alloc_info_size);
             zpl_zero_item(alloc_info);
             alloc_info->size = size - track_size;
             alloc_info->physical_start = ptr;
@@ -159,6 +205,103 @@ ZPL_ALLOCATOR_PROC(zpl_heap_allocator_proc) {
     return ptr;
 }
 
+#if defined(ZPL_MODULE_CORE)
+
+//
+// Virtual Memory Arena
+//
+
+typedef struct zpl__arena_vm_block {
+    struct zpl__arena_vm_block *prev;
+    zpl_virtual_memory vm;
+    zpl_isize committed;
+} zpl__arena_vm_block;
+
+#define ZPL__ARENA_VM_HEADER zpl_align_forward_i64(zpl_size_of(zpl__arena_vm_block), ZPL_DEFAULT_MEMORY_ALIGNMENT)
+
+zpl_internal void zpl__arena_vm_use(zpl_arena *arena, zpl__arena_vm_block *block) {
+    arena->vm_block = block;
+    arena->physical_start = zpl_pointer_add(block, ZPL__ARENA_VM_HEADER);
+    arena->total_size = block->vm.size - ZPL__ARENA_VM_HEADER;
+    arena->total_allocated = arena->total_size;
+}
+
+zpl_internal zpl_b32 zpl__arena_vm_commit(zpl_arena *arena, zpl_isize total) {
+    zpl__arena_vm_block *block = cast(zpl__arena_vm_block *)arena->vm_block;
+    zpl_isize needed = ZPL__ARENA_VM_HEADER + total, committed;
+    if (needed <= block->committed) return true;
+    if (needed > block->vm.size) return false;
+
+    committed = zpl_min(zpl_align_forward_i64(needed, ZPL_ARENA_VM_COMMIT_SIZE), block->vm.size);
+    if (!zpl_vm_commit(zpl_vm(zpl_pointer_add(block->vm.data, block->committed), committed - block->committed))) return false;
+    block->committed = committed;
+    return true;
+}
+
+zpl_internal zpl_b32 zpl__arena_vm_chain(zpl_arena *arena, zpl_isize min_size) {
+    zpl__arena_vm_block *prev = cast(zpl__arena_vm_block *)arena->vm_block, *block;
+    zpl_isize page_size = zpl_virtual_memory_page_size(NULL);
+    zpl_isize size = zpl_align_forward_i64(min_size + ZPL__ARENA_VM_HEADER, page_size);
+    zpl_isize committed;
+    zpl_virtual_memory vm;
+
+    if (prev) size = zpl_max(size, prev->vm.size);
+    vm = zpl_vm_reserve(NULL, size);
+    if (!vm.data) return false;
+
+    // NOTE: The block header lives in the first committed page
+    committed = zpl_min(zpl_align_forward_i64(ZPL_ARENA_VM_COMMIT_SIZE, page_size), size);
+    if (!zpl_vm_commit(zpl_vm(vm.data, committed))) {
+        zpl_vm_free(vm);
+        return false;
+    }
+
+    block = cast(zpl__arena_vm_block *)vm.data;
+    block->prev = prev;
+    block->vm = vm;
+    block->committed = committed;
+    zpl__arena_vm_use(arena, block);
+    arena->total_allocated = 0;
+    arena->temp_mark = 0; // NOTE: Open snapshots belong to earlier blocks
+    return true;
+}
+
+void zpl_arena_init_from_vm(zpl_arena *arena, zpl_isize reserve_size) {
+    zpl_zero_item(arena);
+    zpl__arena_vm_chain(arena, reserve_size);
+    arena->total_allocated = 0;
+}
+
+zpl_internal void zpl__arena_vm_rewind(zpl_arena *arena, void *target) {
+    zpl__arena_vm_block *block = cast(zpl__arena_vm_block *)arena->vm_block;
+    while (block != target && block->prev) {
+        zpl__arena_vm_block *prev = block->prev;
+        zpl_vm_free(block->vm);
+        block = prev;
+    }
+    zpl__arena_vm_use(arena, block);
+}
+
+zpl_internal void zpl__arena_vm_purge(zpl_arena *arena) {
+    zpl__arena_vm_block *block = cast(zpl__arena_vm_block *)arena->vm_block;
+    zpl_isize page_size = zpl_virtual_memory_page_size(NULL);
+
+    // NOTE: Keep the page holding the block header, the rest is handed back to the system
+    if (block->committed > page_size) {
+        zpl_vm_purge(zpl_vm(zpl_pointer_add(block->vm.data, page_size), block->committed - page_size));
+    }
+}
+
+zpl_internal void zpl__arena_vm_release(zpl_arena *arena) {
+    zpl__arena_vm_block *block;
+    zpl__arena_vm_rewind(arena, NULL);
+    block = cast(zpl__arena_vm_block *)arena->vm_block;
+    zpl_vm_free(block->vm);
+    zpl_zero_item(arena);
+}
+
+#endif
+
 //
 // Arena Allocator
 //
@@ -167,20 +310,30 @@ ZPL_ALLOCATOR_PROC(zpl_arena_allocator_proc) {
     zpl_arena *arena = cast(zpl_arena *) allocator_data;
     void *ptr = NULL;
 
-    zpl_unused(old_size);
-
     switch (type) {
         case ZPL_ALLOCATION_ALLOC: {
             void *end = zpl_pointer_add(arena->physical_start, arena->total_allocated);
-            zpl_isize total_size = zpl_align_forward_i64(size, alignment);
+            zpl_isize total_size;
+
+            ptr = zpl_align_forward(end, alignment);
+            total_size = zpl_pointer_diff(arena->physical_start, ptr) + size;
 
             // NOTE: Out of memory
-            if (arena->total_allocated + total_size > cast(zpl_isize) arena->total_size) {
+            if (total_size > arena->total_size) {
+#if defined(ZPL_MODULE_CORE)
+                if (!arena->vm_block || !zpl__arena_vm_chain(arena, size + alignment)) return NULL;
+                ptr = zpl_align_forward(arena->physical_start, alignment);
+                total_size = zpl_pointer_diff(arena->physical_start, ptr) + size;
+#else
                 return NULL;
+#endif
             }
 
-            ptr = zpl_align_forward(end, alignment);
-            arena->total_allocated += total_size;
+#if defined(ZPL_MODULE_CORE)
+            if (arena->vm_block && !zpl__arena_vm_commit(arena, total_size)) return NULL;
+#endif
+
+            arena->total_allocated = total_size;
             if (flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO) zpl_zero_size(ptr, size);
         } break;
 
@@ -189,51 +342,121 @@ ZPL_ALLOCATOR_PROC(zpl_arena_allocator_proc) {
         // Use Temp_Arena_Memory if you want to free a block
         break;
 
-        case ZPL_ALLOCATION_FREE_ALL: arena->total_allocated = 0; break;
+        case ZPL_ALLOCATION_FREE_ALL: {
+#if defined(ZPL_MODULE_CORE)
+            if (arena->vm_block) {
+                zpl__arena_vm_rewind(arena, NULL);
+                zpl__arena_vm_purge(arena);
+            }
+#endif
+            arena->total_allocated = 0;
+        } break;
 
         case ZPL_ALLOCATION_RESIZE: {
-            // TODO: Check if ptr is on top of stack and just extend
             zpl_allocator a = zpl_arena_allocator(arena);
-            ptr = zpl_default_resize_align(a, old_memory, old_size, size, alignment);
+            void *end = zpl_pointer_add(arena->physical_start, arena->total_allocated);
+
+            // NOTE: The top allocation can grow or shrink in place
+            if (old_memory && size > 0 && zpl_pointer_add(old_memory, old_size) == end &&
+                (cast(zpl_uintptr)old_memory & cast(zpl_uintptr)(alignment - 1)) == 0) {
+                zpl_isize total_size = zpl_pointer_diff(arena->physical_start, old_memory) + size;
+                zpl_b32 fits;
+                // NOTE: Memory below the newest open snapshot is given back by that snapshot, not here
+                if (total_size < arena->temp_mark) total_size = arena->temp_mark;
+                fits = total_size <= arena->total_size;
+#if defined(ZPL_MODULE_CORE)
+                if (fits && arena->vm_block) fits = zpl__arena_vm_commit(arena, total_size);
+#endif
+                if (fits) {
+                    if (size > old_size && (flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO)) {
+                        zpl_zero_size(zpl_pointer_add(old_memory, old_size), size - old_size);
+                    }
+                    arena->total_allocated = total_size;
+                    ptr = old_memory;
+                    break;
+                }
+            }
+            ptr = zpl_default_resize_align_with_flags(a, old_memory, old_size, size, alignment, flags);
         } break;
     }
     return ptr;
 }
 
+void zpl_arena_free(zpl_arena *arena) {
+#if defined(ZPL_MODULE_CORE)
+    if (arena->vm_block) {
+        zpl__arena_vm_release(arena);
+        return;
+    }
+#endif
+    if (arena->backing.proc) {
+        zpl_free(arena->backing, arena->physical_start);
+        arena->physical_start = NULL;
+    }
+}
+
+void zpl_arena_snapshot_end(zpl_arena_snapshot tmp) {
+#if defined(ZPL_MODULE_CORE)
+    // NOTE: Drop the blocks chained since the snapshot was taken
+    if (tmp.arena->vm_block != tmp.vm_block) zpl__arena_vm_rewind(tmp.arena, tmp.vm_block);
+#endif
+    ZPL_ASSERT(tmp.arena->total_allocated >= tmp.original_count);
+    ZPL_ASSERT(tmp.arena->temp_count > 0);
+    tmp.arena->total_allocated = tmp.original_count;
+    tmp.arena->temp_mark = tmp.temp_mark;
+    tmp.arena->temp_count--;
+}
+
 //
 // Pool Allocator
 //
 
-void zpl_pool_init_align(zpl_pool *pool, zpl_allocator backing, zpl_isize num_blocks, zpl_isize block_size, zpl_isize block_align) {
-    zpl_isize actual_block_size, pool_size, block_index;
-    void *data, *curr;
-    zpl_uintptr *end;
-
-    zpl_zero_item(pool);
-
-    pool->backing = backing;
-    pool->block_size = block_size;
-    pool->block_align = block_align;
-    pool->num_blocks = num_blocks;
+// NOTE: Every slab ends with a link to the next slab chained on exhaustion
+zpl_internal void **zpl__pool_slab_link(zpl_pool *pool, void *slab) {
+    return cast(void **)zpl_pointer_add(slab, pool->num_blocks * (pool->block_size + pool->block_align));
+}
 
-    actual_block_size = block_size + block_align;
-    pool_size = num_blocks * actual_block_size;
+zpl_internal void *zpl__pool_slab_alloc(zpl_pool *pool) {
+    zpl_isize slab_size = pool->num_blocks * (pool->block_size + pool->block_align) + zpl_size_of(void *);
+    void *slab = zpl_alloc_align_uninit(pool->backing, slab_size, pool->block_align);
+    void *link = NULL;
+    if (slab) zpl_memcopy(zpl__pool_slab_link(pool, slab), &link, zpl_size_of(void *));
+    return slab;
+}
 
-    data = zpl_alloc_align(backing, pool_size, block_align);
+// NOTE: Init intrusive freelist, the last block points to `tail`
+zpl_internal void *zpl__pool_slab_thread(zpl_pool *pool, void *slab, void *tail) {
+    zpl_isize actual_block_size = pool->block_size + pool->block_align;
+    zpl_isize block_index;
+    void *curr = slab;
+    zpl_uintptr *end;
 
-    // NOTE: Init intrusive freelist
-    curr = data;
-    for (block_index = 0; block_index < num_blocks - 1; block_index++) {
+    for (block_index = 0; block_index < pool->num_blocks - 1; block_index++) {
         zpl_uintptr *next = cast(zpl_uintptr *) curr;
         *next = cast(zpl_uintptr) curr + actual_block_size;
         curr = zpl_pointer_add(curr, actual_block_size);
     }
 
     end = cast(zpl_uintptr *) curr;
-    *end = cast(zpl_uintptr) NULL;
+    *end = cast(zpl_uintptr) tail;
+    return slab;
+}
+
+void zpl_pool_init_align(zpl_pool *pool, zpl_allocator backing, zpl_isize num_blocks, zpl_isize block_size, zpl_isize block_align) {
+    void *data;
+
+    zpl_zero_item(pool);
+
+    pool->backing = backing;
+    pool->block_size = block_size;
+    pool->block_align = block_align;
+    pool->num_blocks = num_blocks;
+
+    data = zpl__pool_slab_alloc(pool);
+    if (!data) return;
 
     pool->physical_start = data;
-    pool->free_list = data;
+    pool->free_list = zpl__pool_slab_thread(pool, data, NULL);
 }
 
 ZPL_ALLOCATOR_PROC(zpl_pool_allocator_proc) {
@@ -247,7 +470,15 @@ ZPL_ALLOCATOR_PROC(zpl_pool_allocator_proc) {
             zpl_uintptr next_free;
             ZPL_ASSERT(size == pool->block_size);
             ZPL_ASSERT(alignment == pool->block_align);
-            ZPL_ASSERT(pool->free_list != NULL);
+
+            // NOTE: Chain another slab right after the first one once all blocks are taken
+            if (pool->free_list == NULL) {
+                void *slab = pool->physical_start ? zpl__pool_slab_alloc(pool) : NULL;
+                if (!slab) return NULL;
+                zpl_memcopy(zpl__pool_slab_link(pool, slab), zpl__pool_slab_link(pool, pool->physical_start), zpl_size_of(void *));
+                zpl_memcopy(zpl__pool_slab_link(pool, pool->physical_start), &slab, zpl_size_of(void *));
+                pool->free_list = zpl__pool_slab_thread(pool, slab, NULL);
+            }
 
             next_free = *cast(zpl_uintptr *) pool->free_list;
             ptr = pool->free_list;
@@ -267,24 +498,16 @@ ZPL_ALLOCATOR_PROC(zpl_pool_allocator_proc) {
         } break;
 
         case ZPL_ALLOCATION_FREE_ALL: {
-            zpl_isize actual_block_size, block_index;
-            void *curr;
-            zpl_uintptr *end;
-
-            actual_block_size = pool->block_size + pool->block_align;
+            void *free_list = NULL, *slab;
             pool->total_size = 0;
+            if (!pool->physical_start) break;
 
-            // NOTE: Init intrusive freelist
-            curr = pool->physical_start;
-            for (block_index = 0; block_index < pool->num_blocks - 1; block_index++) {
-                zpl_uintptr *next = cast(zpl_uintptr *) curr;
-                *next = cast(zpl_uintptr) curr + actual_block_size;
-                curr = zpl_pointer_add(curr, actual_block_size);
+            zpl_memcopy(&slab, zpl__pool_slab_link(pool, pool->physical_start), zpl_size_of(void *));
+            while (slab) {
+                free_list = zpl__pool_slab_thread(pool, slab, free_list);
+                zpl_memcopy(&slab, zpl__pool_slab_link(pool, slab), zpl_size_of(void *));
             }
-
-            end = cast(zpl_uintptr *) curr;
-            *end = cast(zpl_uintptr) NULL;
-            pool->free_list = pool->physical_start;
+            pool->free_list = zpl__pool_slab_thread(pool, pool->physical_start, free_list);
         } break;
 
         case ZPL_ALLOCATION_RESIZE:
@@ -296,6 +519,20 @@ ZPL_ALLOCATOR_PROC(zpl_pool_allocator_proc) {
     return ptr;
 }
 
+void zpl_pool_free(zpl_pool *pool) {
+    void *slab = pool->physical_start;
+    if (!pool->backing.proc) return;
+
+    while (slab) {
+        void *next;
+        zpl_memcopy(&next, zpl__pool_slab_link(pool, slab), zpl_size_of(void *));
+        zpl_free(pool->backing, slab);
+        slab = next;
+    }
+    pool->physical_start = NULL;
+    pool->free_list = NULL;
+}
+
 
 //
 // Scratch Memory Allocator
@@ -383,7 +620,7 @@ ZPL_ALLOCATOR_PROC(zpl_scratch_allocator_proc) {
         break;
 
         case ZPL_ALLOCATION_RESIZE:
-        ptr = zpl_default_resize_align(zpl_scratch_allocator(s), old_memory, old_size, size, alignment);
+        ptr = zpl_default_resize_align_with_flags(zpl_scratch_allocator(s), old_memory, old_size, size, alignment, flags);
         break;
     }
 
@@ -258,7 +258,7 @@ zpl_u8 *zpl_base64_encode(zpl_allocator a, void const *data, zpl_isize len) {
     }
 
     enc_len = zpl__base64_encoded_size(len);
-    ret = cast(zpl_u8 *)zpl_alloc(a, enc_len+1);
+    ret = cast(zpl_u8 *)zpl_alloc_uninit(a, enc_len+1);
     ret[enc_len] = 0;
 
     for (i=0, j=0; i < len; i+=3, j+=4) {
@@ -7,22 +7,425 @@
 
 ZPL_BEGIN_C_DECLS
 
-ZPL_RING_DEFINE(zpl__jobs_ring_, zpl_thread_job);
-
 zpl_global const zpl_u32 zpl__jobs_chances[ZPL_JOBS_MAX_PRIORITIES] = {
     2, 3, 5, 7, 11
 };
 
+zpl_global zpl_thread_local zpl_thread_worker *zpl__jobs_current_worker = NULL;
+
+zpl_internal zpl_b32 zpl__jobs_deque_init(zpl__jobs_deque *d, zpl_allocator a, zpl_u32 capacity) {
+    zpl_i64 size = 1;
+    while (size < cast(zpl_i64)capacity) size <<= 1;
+
+    zpl_atomic64_store(&d->top, 0);
+    zpl_atomic64_store(&d->bottom, 0);
+    d->mask = size - 1;
+    d->jobs = cast(zpl_thread_job *)zpl_alloc(a, size * zpl_size_of(zpl_thread_job));
+    return d->jobs != NULL;
+}
+
+zpl_internal zpl_b32 zpl__jobs_deque_push(zpl__jobs_deque *d, zpl_thread_job job) {
+    zpl_i64 b = zpl_atomic64_load(&d->bottom);
+    zpl_i64 t = zpl_atomic64_load(&d->top);
+
+    if (b - t > d->mask) {
+        return false;
+    }
+
+    d->jobs[b & d->mask] = job;
+    zpl_sfence(); // NOTE: The job has to be visible before thieves can see the new bottom
+    zpl_atomic64_store(&d->bottom, b + 1);
+    return true;
+}
+
+zpl_internal zpl_b32 zpl__jobs_deque_pop(zpl__jobs_deque *d, zpl_thread_job *job) {
+    zpl_i64 b = zpl_atomic64_load(&d->bottom) - 1;
+    zpl_i64 t;
+
+    // NOTE: Publish the new bottom before reading top, thieves race us for the last job. The exchange is a full
+    // barrier on every target, a plain store followed by zpl_mfence isn't where atomics are volatile accesses.
+    zpl_atomic64_exchange(&d->bottom, b);
+    t = zpl_atomic64_load(&d->top);
+
+    if (t > b) {
+        zpl_atomic64_store(&d->bottom, b + 1);
+        return false;
+    }
+
+    *job = d->jobs[b & d->mask];
+
+    if (t == b) {
+        zpl_b32 won = zpl_atomic64_compare_exchange(&d->top, t, t + 1) == t;
+        zpl_atomic64_store(&d->bottom, b + 1);
+        return won;
+    }
+
+    return true;
+}
+
+zpl_internal zpl_b32 zpl__jobs_deque_steal(zpl__jobs_deque *d, zpl_thread_job *job) {
+    zpl_i64 t = zpl_atomic64_load(&d->top);
+    zpl_i64 b;
+
+    zpl_mfence();
+    b = zpl_atomic64_load(&d->bottom);
+
+    if (t >= b) {
+        return false;
+    }
+
+    *job = d->jobs[t & d->mask];
+    return zpl_atomic64_compare_exchange(&d->top, t, t + 1) == t;
+}
+
+zpl_internal zpl_b32 zpl__jobs_queue_init(zpl__jobs_queue *q, zpl_allocator a, zpl_u32 capacity) {
+    zpl_i64 size = 2;
+    while (size < cast(zpl_i64)capacity) size <<= 1;
+
+    q->mask = size - 1;
+    q->cells = cast(zpl__jobs_cell *)zpl_alloc(a, size * zpl_size_of(zpl__jobs_cell));
+    if (!q->cells) {
+        return false;
+    }
+
+    for (zpl_i64 i = 0; i < size; ++i) {
+        zpl_atomic64_store(&q->cells[i].sequence, i);
+    }
+    zpl_atomic64_store(&q->head, 0);
+    zpl_atomic64_store(&q->tail, 0);
+    return true;
+}
+
+//! Reserves up to `count` consecutive cells, fills them in and publishes them. Returns the number of enqueued jobs.
+zpl_internal zpl_u32 zpl__jobs_queue_push(zpl__jobs_queue *q, zpl_thread_job const *jobs, zpl_u32 count) {
+    zpl_i64 pos = zpl_atomic64_load(&q->tail);
+    zpl_i64 reserved;
+
+    for (;;) {
+        zpl_i64 seq, prev;
+        reserved = 0;
+
+        while (reserved < count && reserved <= q->mask) {
+            seq = zpl_atomic64_load(&q->cells[(pos + reserved) & q->mask].sequence);
+            if (seq != pos + reserved) break;
+            ++reserved;
+        }
+
+        if (reserved == 0) {
+            seq = zpl_atomic64_load(&q->cells[pos & q->mask].sequence);
+            if (seq < pos) {
+                return 0; // NOTE: The queue is full
+            }
+            pos = zpl_atomic64_load(&q->tail);
+            continue;
+        }
+
+        prev = zpl_atomic64_compare_exchange(&q->tail, pos, pos + reserved);
+        if (prev == pos) {
+            break;
+        }
+        pos = prev;
+    }
+
+    for (zpl_i64 i = 0; i < reserved; ++i) {
+        zpl__jobs_cell *cell = &q->cells[(pos + i) & q->mask];
+        cell->job = jobs[i];
+        zpl_atomic64_store(&cell->sequence, pos + i + 1);
+    }
+
+    return cast(zpl_u32)reserved;
+}
+
+zpl_internal zpl_b32 zpl__jobs_queue_pop(zpl__jobs_queue *q, zpl_thread_job *job) {
+    zpl_i64 pos = zpl_atomic64_load(&q->head);
+    zpl__jobs_cell *cell;
+
+    for (;;) {
+        zpl_i64 seq, prev;
+        cell = &q->cells[pos & q->mask];
+        seq = zpl_atomic64_load(&cell->sequence);
+
+        if (seq == pos + 1) {
+            prev = zpl_atomic64_compare_exchange(&q->head, pos, pos + 1);
+            if (prev == pos) {
+                break;
+            }
+            pos = prev;
+        } else if (seq < pos + 1) {
+            return false; // NOTE: The queue is empty
+        } else {
+            pos = zpl_atomic64_load(&q->head);
+        }
+    }
+
+    *job = cell->job;
+    zpl_atomic64_store(&cell->sequence, pos + q->mask + 1);
+    return true;
+}
+
+zpl_internal zpl_b32 zpl__jobs_dequeue(zpl_jobs_system *pool, zpl_u32 *counter, zpl_thread_job *job) {
+    zpl_b32 last_empty = false;
+
+    for (zpl_usize i = 0; i < ZPL_JOBS_MAX_PRIORITIES; ++i) {
+        zpl_thread_queue *q = &pool->queues[i];
+        if (zpl_jobs_empty(pool, (zpl_jobs_priority)i)) {
+            last_empty = (i+1 == ZPL_JOBS_MAX_PRIORITIES);
+            continue;
+        }
+        if (!last_empty && (((*counter)++ % q->chance) != 0)) {
+            continue;
+        }
+        if (!zpl__jobs_queue_pop(&q->jobs, job)) {
+            continue;
+        }
+
+#    ifdef ZPL_JOBS_DEBUG
+        ++q->hits;
+#    endif
+        return true;
+    }
+
+    return false;
+}
+
+zpl_internal zpl_b32 zpl__jobs_find(zpl_jobs_system *pool, zpl_thread_worker *tw, zpl_u32 *counter, zpl_u32 *seed, zpl_thread_job *job) {
+    if (tw && zpl__jobs_deque_pop(&tw->deque, job)) {
+        return true;
+    }
+
+    if (zpl__jobs_dequeue(pool, counter, job)) {
+        return true;
+    }
+
+    if ((pool->flags & ZPL_JOBS_FLAG_WORK_STEALING) && pool->max_threads > 0) {
+        // NOTE: xorshift32, picks a random victim and walks the others from there
+        zpl_u32 victim;
+        *seed ^= *seed << 13;
+        *seed ^= *seed >> 17;
+        *seed ^= *seed << 5;
+        victim = *seed % pool->max_threads;
+
+        for (zpl_u32 i = 0; i < pool->max_threads; ++i) {
+            zpl_thread_worker *other = pool->workers + (victim + i) % pool->max_threads;
+            if (other == tw) continue;
+
+            if (zpl__jobs_deque_steal(&other->deque, job)) {
+#            ifdef ZPL_JOBS_DEBUG
+                if (tw) ++tw->steals;
+#            endif
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+zpl_internal void zpl__jobs_counter_lock(zpl_jobs_counter *c) {
+    while (zpl_atomic32_exchange(&c->lock, 1) != 0) {
+        zpl_yield_thread();
+    }
+}
+
+zpl_internal void zpl__jobs_counter_unlock(zpl_jobs_counter *c) {
+    zpl_atomic32_exchange(&c->lock, 0);
+}
+
+zpl_internal zpl_b32 zpl__jobs_submit(zpl_jobs_system *pool, zpl_thread_job job, zpl_jobs_priority priority);
+zpl_internal void zpl__jobs_run(zpl_jobs_system *pool, zpl_thread_job *job);
+
+zpl_internal void zpl__jobs_counter_signal(zpl_jobs_system *pool, zpl_jobs_counter *c) {
+    zpl__jobs_continuation ready[ZPL_JOBS_MAX_CONTINUATIONS];
+    zpl_u32 ready_count = 0;
+
+    // NOTE: Only the final decrement takes the lock, zpl_jobs_counter_done waits for it to be released
+    // so that the counter can't go out of scope while we still touch it.
+    for (;;) {
+        zpl_i32 value = zpl_atomic32_load(&c->value);
+        ZPL_ASSERT(value > 0);
+        if (value == 1) break;
+        if (zpl_atomic32_compare_exchange(&c->value, value, value - 1) == value) {
+            return;
+        }
+    }
+
+    zpl__jobs_counter_lock(c);
+    if (zpl_atomic32_fetch_add(&c->value, -1) == 1) {
+        ready_count = c->continuation_count;
+        zpl_memcopy(ready, c->continuations, ready_count * zpl_size_of(zpl__jobs_continuation));
+        c->continuation_count = 0;
+    }
+    zpl__jobs_counter_unlock(c);
+
+    for (zpl_u32 i = 0; i < ready_count; ++i) {
+        // NOTE: Run the continuation right here if the queues are full, zpl__jobs_run retires it from pending
+        if (!zpl__jobs_submit(pool, ready[i].job, ready[i].priority)) {
+            if (pool->flags & ZPL_JOBS_FLAG_WORK_STEALING) {
+                zpl_atomic32_fetch_add(&pool->pending, 1);
+            }
+            zpl__jobs_run(pool, &ready[i].job);
+        }
+    }
+}
+
+void zpl__jobs_run(zpl_jobs_system *pool, zpl_thread_job *job) {
+    job->proc(job->data);
+
+    if (job->counter) {
+        zpl__jobs_counter_signal(pool, job->counter);
+    }
+    if (pool->flags & ZPL_JOBS_FLAG_WORK_STEALING) {
+        zpl_atomic32_fetch_add(&pool->pending, -1);
+    }
+}
+
+zpl_internal zpl_b32 zpl__jobs_has_work(zpl_jobs_system *pool, zpl_thread_worker *tw) {
+    if (zpl_atomic32_load(&tw->status) != ZPL_JOBS_STATUS_WAITING) {
+        return true;
+    }
+
+    if (pool->flags & ZPL_JOBS_FLAG_WORK_STEALING) {
+        if (!zpl_jobs_empty_all(pool)) {
+            return true;
+        }
+
+        for (zpl_u32 i = 0; i < pool->max_threads; ++i) {
+            zpl__jobs_deque *d = &pool->workers[i].deque;
+            if (zpl_atomic64_load(&d->bottom) > zpl_atomic64_load(&d->top)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+zpl_internal zpl_b32 zpl__jobs_unpark(zpl_thread_worker *tw) {
+    if (zpl_atomic32_exchange(&tw->parked, 0) == 1) {
+        zpl_atomic32_fetch_add(&tw->pool->sleepers, -1);
+        zpl_atomic32_fetch_add(&tw->unparks, 1);
+        zpl_semaphore_release(&tw->wake);
+        return true;
+    }
+    return false;
+}
+
+zpl_internal void zpl__jobs_unpark_some(zpl_jobs_system *pool, zpl_u32 count) {
+    // NOTE: The job has to be published before we look for sleepers, the read-modify-write orders it like the
+    // exchange in zpl__jobs_park does on the worker's side
+    if (zpl_atomic32_fetch_add(&pool->sleepers, 0) <= 0) {
+        return;
+    }
+
+    for (zpl_u32 i = 0; i < pool->max_threads && count > 0; ++i) {
+        if (zpl_atomic32_load(&pool->sleepers) <= 0) {
+            return;
+        }
+        if (zpl__jobs_unpark(pool->workers + i)) {
+            --count;
+        }
+    }
+}
+
+zpl_internal void zpl__jobs_park(zpl_thread_worker *tw) {
+    zpl_jobs_system *pool = tw->pool;
+
+    zpl_atomic32_exchange(&tw->parked, 1);
+    zpl_atomic32_fetch_add(&pool->sleepers, 1);
+
+    // NOTE: Re-check after announcing ourselves, a producer either sees us parked or we see its job
+    if (zpl__jobs_has_work(pool, tw)) {
+        if (zpl_atomic32_exchange(&tw->parked, 0) == 1) {
+            zpl_atomic32_fetch_add(&pool->sleepers, -1);
+            return;
+        }
+        // NOTE: A producer has already claimed us, consume its wake-up below
+    }
+
+    ++tw->parks;
+    zpl_semaphore_wait(&tw->wake);
+}
+
+zpl_internal void zpl__jobs_idle(zpl_thread_worker *tw, zpl_u32 *spins) {
+#    ifdef ZPL_JOBS_DEBUG
+    ++tw->idle;
+#    endif
+
+    if (*spins < cast(zpl_u32)zpl_atomic32_load(&tw->pool->spin_budget)) {
+        // NOTE: Give up the time slice every now and then in case the pool is oversubscribed
+        if ((++*spins & 63) == 0) {
+            zpl_yield();
+        } else {
+            zpl_yield_thread();
+        }
+        return;
+    }
+
+    *spins = 0;
+    zpl__jobs_park(tw);
+}
+
+zpl_internal zpl_isize zpl__jobs_entry_stealing(zpl_thread_worker *tw) {
+    zpl_jobs_system *pool = tw->pool;
+    zpl_thread_job job;
+    zpl_u32 spins = 0;
+
+    while (zpl_atomic32_load(&tw->status) != ZPL_JOBS_STATUS_TERM) {
+        if (zpl__jobs_find(pool, tw, &tw->counter, &tw->seed, &job)) {
+            spins = 0;
+            zpl_atomic32_compare_exchange(&tw->status, ZPL_JOBS_STATUS_WAITING, ZPL_JOBS_STATUS_BUSY);
+            zpl__jobs_run(pool, &job);
+            zpl_atomic32_compare_exchange(&tw->status, ZPL_JOBS_STATUS_BUSY, ZPL_JOBS_STATUS_WAITING);
+
+#        ifdef ZPL_JOBS_DEBUG
+            ++tw->hits;
+#        endif
+        } else {
+            zpl__jobs_idle(tw, &spins);
+        }
+    }
+
+    return 0;
+}
+
+/* finds hardware thread n, counting the first thread of every core before any SMT sibling, false past the last one */
+zpl_internal zpl_b32 zpl__jobs_hardware_thread(zpl_affinity *a, zpl_isize n, zpl_isize *core, zpl_isize *thread) {
+    for (zpl_isize t = 0; ; ++t) {
+        zpl_b32 any = false;
+        for (zpl_isize c = 0; c < a->core_count; ++c) {
+            if (t >= zpl_affinity_thread_count_for_core(a, c)) continue;
+            any = true;
+            if (n-- == 0) {
+                *core = c;
+                *thread = t;
+                return true;
+            }
+        }
+        if (!any) return false;
+    }
+}
+
 zpl_isize zpl__jobs_entry(struct zpl_thread *thread) {
     zpl_thread_worker *tw = (zpl_thread_worker *)thread->user_data;
+    zpl_u32 spins = 0;
+    zpl__jobs_current_worker = tw;
+
+    if (tw->core >= 0) {
+        zpl_affinity_set(tw->pool->affinity, tw->core, tw->smt);
+    }
+
+    if (tw->pool->flags & ZPL_JOBS_FLAG_WORK_STEALING) {
+        return zpl__jobs_entry_stealing(tw);
+    }
 
     for (;;) {
         zpl_u32 status = zpl_atomic32_load(&tw->status);
 
         switch (status) {
             case ZPL_JOBS_STATUS_READY: {
+                spins = 0;
                 zpl_atomic32_store(&tw->status, ZPL_JOBS_STATUS_BUSY);
-                tw->job.proc(tw->job.data);
+                zpl__jobs_run(tw->pool, &tw->job);
                 zpl_atomic32_compare_exchange(&tw->status, ZPL_JOBS_STATUS_BUSY, ZPL_JOBS_STATUS_WAITING);
 
 #            ifdef ZPL_JOBS_DEBUG
@@ -31,10 +434,12 @@ zpl_isize zpl__jobs_entry(struct zpl_thread *thread) {
             } break;
 
             case ZPL_JOBS_STATUS_WAITING: {
-#            ifdef ZPL_JOBS_DEBUG
-                ++tw->idle;
-#            endif
-                zpl_yield();
+                zpl__jobs_idle(tw, &spins);
+            } break;
+
+            case ZPL_JOBS_STATUS_BUSY: {
+                // NOTE: zpl_jobs_process has claimed us and is about to hand over a job
+                zpl_yield_thread();
             } break;
 
             case ZPL_JOBS_STATUS_TERM: {
@@ -51,19 +456,40 @@ void zpl_jobs_init(zpl_jobs_system *pool, zpl_allocator a, zpl_u32 max_threads)
 }
 
 void zpl_jobs_init_with_limit(zpl_jobs_system *pool, zpl_allocator a, zpl_u32 max_threads, zpl_u32 max_jobs) {
+    zpl_jobs_init_with_flags(pool, a, max_threads, max_jobs, 0);
+}
+
+void zpl_jobs_init_with_flags(zpl_jobs_system *pool, zpl_allocator a, zpl_u32 max_threads, zpl_u32 max_jobs, zpl_u32 flags) {
     zpl_jobs_system pool_ = { 0 };
     *pool = pool_;
 
     pool->alloc = a;
     pool->max_threads = max_threads;
     pool->max_jobs = max_jobs;
-    pool->counter = 0;
+    pool->flags = flags;
+    zpl_atomic32_store(&pool->pending, 0);
+    zpl_atomic32_store(&pool->spin_budget, ZPL_JOBS_SPIN_BUDGET);
+    zpl_atomic32_store(&pool->sleepers, 0);
 
     zpl_buffer_init(pool->workers, a, max_threads);
 
+    if (flags & ZPL_JOBS_FLAG_PIN_WORKERS) {
+        pool->affinity = cast(zpl_affinity *)zpl_alloc(a, zpl_size_of(zpl_affinity));
+        if (pool->affinity) zpl_affinity_init(pool->affinity);
+    }
+
+    if (pool->affinity) {
+        pool->core_count = pool->affinity->core_count;
+    } else {
+        zpl_affinity af;
+        zpl_affinity_init(&af);
+        pool->core_count = af.core_count;
+        zpl_affinity_destroy(&af);
+    }
+
     for (zpl_usize i = 0; i < ZPL_JOBS_MAX_PRIORITIES; ++i) {
         zpl_thread_queue *q = &pool->queues[i];
-        zpl__jobs_ring_init(&q->jobs, a, max_jobs);
+        zpl__jobs_queue_init(&q->jobs, a, max_jobs);
         q->chance = zpl__jobs_chances[i];
     }
 
@@ -72,6 +498,17 @@ void zpl_jobs_init_with_limit(zpl_jobs_system *pool, zpl_allocator a, zpl_u32 ma
         zpl_thread_worker *tw = pool->workers + i;
         *tw = worker_;
 
+        tw->pool = pool;
+        tw->index = cast(zpl_u32)i;
+        tw->seed = cast(zpl_u32)(i * 2654435761u) | 1;
+        tw->core = -1;
+        if (pool->affinity) zpl__jobs_hardware_thread(pool->affinity, cast(zpl_isize)i + 1, &tw->core, &tw->smt);
+
+        if (flags & ZPL_JOBS_FLAG_WORK_STEALING) {
+            zpl__jobs_deque_init(&tw->deque, a, max_jobs);
+        }
+
+        zpl_semaphore_init(&tw->wake);
         zpl_thread_init(&tw->thread);
         zpl_atomic32_store(&tw->status, ZPL_JOBS_STATUS_WAITING);
         zpl_thread_start(&tw->thread, zpl__jobs_entry, (void *)tw);
@@ -83,29 +520,282 @@ void zpl_jobs_free(zpl_jobs_system *pool) {
         zpl_thread_worker *tw = pool->workers + i;
 
         zpl_atomic32_store(&tw->status, ZPL_JOBS_STATUS_TERM);
+        zpl_mfence();
+        zpl__jobs_unpark(tw);
         zpl_thread_destroy(&tw->thread);
+        zpl_semaphore_destroy(&tw->wake);
+
+        if (pool->flags & ZPL_JOBS_FLAG_WORK_STEALING) {
+            zpl_free(pool->alloc, tw->deque.jobs);
+        }
     }
 
     zpl_buffer_free(pool->workers);
 
+    if (pool->affinity) {
+        zpl_affinity_destroy(pool->affinity);
+        zpl_free(pool->alloc, pool->affinity);
+    }
+
     for (zpl_usize i = 0; i < ZPL_JOBS_MAX_PRIORITIES; ++i) {
         zpl_thread_queue *q = &pool->queues[i];
-        zpl__jobs_ring_free(&q->jobs);
+        zpl_free(pool->alloc, q->jobs.cells);
     }
 }
 
+void zpl_jobs_set_spin_budget(zpl_jobs_system *pool, zpl_u32 spins) {
+    zpl_atomic32_store(&pool->spin_budget, cast(zpl_i32)spins);
+}
+
+zpl_b32 zpl__jobs_submit(zpl_jobs_system *pool, zpl_thread_job job, zpl_jobs_priority priority) {
+    if (pool->flags & ZPL_JOBS_FLAG_WORK_STEALING) {
+        zpl_thread_worker *tw = zpl__jobs_current_worker;
+
+        if (tw && tw->pool == pool) {
+            zpl_atomic32_fetch_add(&pool->pending, 1);
+            if (zpl__jobs_deque_push(&tw->deque, job)) {
+                zpl__jobs_unpark_some(pool, 1);
+                return true;
+            }
+            zpl_atomic32_fetch_add(&pool->pending, -1);
+        }
+    }
+
+    return zpl_jobs_enqueue_batch(pool, &job, 1, priority) == 1;
+}
+
 zpl_b32 zpl_jobs_enqueue_with_priority(zpl_jobs_system *pool, zpl_jobs_proc proc, void *data, zpl_jobs_priority priority) {
+    return zpl_jobs_enqueue_counted(pool, proc, data, priority, NULL);
+}
+
+zpl_u32 zpl_jobs_enqueue_batch(zpl_jobs_system *pool, zpl_thread_job const *jobs, zpl_u32 count, zpl_jobs_priority priority) {
     ZPL_ASSERT(priority >= 0 && priority < ZPL_JOBS_MAX_PRIORITIES);
+    zpl__jobs_queue *q = &pool->queues[priority].jobs;
+    zpl_b32 stealing = (pool->flags & ZPL_JOBS_FLAG_WORK_STEALING) != 0;
+    zpl_u32 total = 0;
+
+    if (stealing) {
+        zpl_atomic32_fetch_add(&pool->pending, cast(zpl_i32)count);
+    }
+
+    while (total < count) {
+        zpl_u32 pushed = zpl__jobs_queue_push(q, jobs + total, count - total);
+        if (pushed == 0) break;
+        total += pushed;
+    }
+
+    if (stealing) {
+        if (total < count) {
+            zpl_atomic32_fetch_add(&pool->pending, -cast(zpl_i32)(count - total));
+        }
+        zpl__jobs_unpark_some(pool, total);
+    }
+
+    return total;
+}
+
+void zpl_jobs_counter_init(zpl_jobs_counter *counter) {
+    zpl_zero_item(counter);
+}
+
+zpl_b32 zpl_jobs_counter_done(zpl_jobs_counter *counter) {
+    return zpl_atomic32_load(&counter->value) == 0 && zpl_atomic32_load(&counter->lock) == 0;
+}
+
+zpl_b32 zpl_jobs_enqueue_counted(zpl_jobs_system *pool, zpl_jobs_proc proc, void *data, zpl_jobs_priority priority, zpl_jobs_counter *counter) {
     ZPL_ASSERT_NOT_NULL(proc);
     zpl_thread_job job = {0};
     job.proc = proc;
     job.data = data;
+    job.counter = counter;
+
+    if (counter) {
+        zpl_atomic32_fetch_add(&counter->value, 1);
+    }
+
+    if (!zpl__jobs_submit(pool, job, priority)) {
+        if (counter) {
+            zpl__jobs_counter_signal(pool, counter);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+zpl_b32 zpl_jobs_enqueue_after(zpl_jobs_system *pool, zpl_jobs_counter *dependency, zpl_jobs_proc proc, void *data, zpl_jobs_priority priority, zpl_jobs_counter *counter) {
+    ZPL_ASSERT_NOT_NULL(dependency);
+    ZPL_ASSERT_NOT_NULL(proc);
+    zpl_b32 deferred = false;
+    zpl__jobs_continuation cont = {0};
+    cont.job.proc = proc;
+    cont.job.data = data;
+    cont.job.counter = counter;
+    cont.priority = priority;
+
+    zpl__jobs_counter_lock(dependency);
+    if (zpl_atomic32_load(&dependency->value) > 0) {
+        if (dependency->continuation_count == ZPL_JOBS_MAX_CONTINUATIONS) {
+            zpl__jobs_counter_unlock(dependency);
+            return false;
+        }
+        // NOTE: The continuation counts as pending work from now on
+        if (counter) {
+            zpl_atomic32_fetch_add(&counter->value, 1);
+        }
+        dependency->continuations[dependency->continuation_count++] = cont;
+        deferred = true;
+    }
+    zpl__jobs_counter_unlock(dependency);
 
-    if (!zpl_jobs_full(pool, priority)) {
-        zpl__jobs_ring_append(&pool->queues[priority].jobs, job);
+    if (deferred) {
         return true;
     }
-    return false;
+
+    return zpl_jobs_enqueue_counted(pool, proc, data, priority, counter);
+}
+
+void zpl_jobs_wait(zpl_jobs_system *pool, zpl_jobs_counter *counter) {
+    zpl_thread_worker *tw = zpl__jobs_current_worker;
+    zpl_u32 dequeue_counter = 0, seed = 0x9e3779b9u, spins = 0;
+    zpl_thread_job job;
+
+    if (tw && tw->pool != pool) {
+        tw = NULL;
+    }
+
+    while (!zpl_jobs_counter_done(counter)) {
+        if (!(pool->flags & ZPL_JOBS_FLAG_WORK_STEALING)) {
+            zpl_jobs_process(pool);
+        }
+
+        if (zpl__jobs_find(pool, tw, tw ? &tw->counter : &dequeue_counter, tw ? &tw->seed : &seed, &job)) {
+            zpl__jobs_run(pool, &job);
+            spins = 0;
+        } else if ((++spins & 63) == 0) {
+            zpl_yield();
+        } else {
+            zpl_yield_thread();
+        }
+    }
+}
+
+typedef struct {
+    zpl_atomic64 next;
+    zpl_atomic32 slot;
+    zpl_isize end, grain;
+    zpl_jobs_range_proc range_proc;
+    zpl_jobs_reduce_proc reduce_proc;
+    void *data;
+    zpl_u8 *partials;
+    zpl_isize partial_size;
+} zpl__jobs_range;
+
+zpl_internal void zpl__jobs_range_entry(void *data) {
+    zpl__jobs_range *r = cast(zpl__jobs_range *)data;
+    void *partial = NULL;
+
+    if (r->reduce_proc) {
+        partial = r->partials + zpl_atomic32_fetch_add(&r->slot, 1) * r->partial_size;
+    }
+
+    for (;;) {
+        zpl_isize begin = cast(zpl_isize)zpl_atomic64_fetch_add(&r->next, r->grain);
+        if (begin >= r->end) break;
+        zpl_isize end = zpl_min(begin + r->grain, r->end);
+
+        if (r->reduce_proc) {
+            r->reduce_proc(r->data, begin, end, partial);
+        } else {
+            r->range_proc(r->data, begin, end);
+        }
+    }
+}
+
+zpl_internal void zpl__jobs_range_run(zpl_jobs_system *pool, zpl__jobs_range *r, zpl_isize begin, zpl_isize grain, zpl_isize participants) {
+    zpl_jobs_counter counter;
+    zpl_jobs_counter_init(&counter);
+
+    r->grain = grain;
+    zpl_atomic64_store(&r->next, begin);
+    zpl_atomic32_store(&r->slot, 0);
+
+    // NOTE: Helpers that don't fit into the queue are fine, the remaining participants just take more chunks
+    for (zpl_isize i = 1; i < participants; ++i) {
+        if (!zpl_jobs_enqueue_counted(pool, zpl__jobs_range_entry, r, ZPL_JOBS_PRIORITY_HIGH, &counter)) {
+            break;
+        }
+    }
+
+    zpl__jobs_range_entry(r);
+    zpl_jobs_wait(pool, &counter);
+}
+
+zpl_internal zpl_isize zpl__jobs_range_grain(zpl_jobs_system *pool, zpl_isize count, zpl_isize participants, zpl_isize grain) {
+    if (grain > 0) {
+        return grain;
+    }
+
+    // NOTE: Participants beyond the core count only take turns, splitting finer for them just adds overhead
+    participants = zpl_clamp(pool->core_count, 1, participants);
+    grain = count / (participants * ZPL_JOBS_PARALLEL_SPLIT);
+    return grain > 0 ? grain : 1;
+}
+
+void zpl_jobs_parallel_for(zpl_jobs_system *pool, zpl_isize begin, zpl_isize end, zpl_isize grain, zpl_jobs_range_proc proc, void *data) {
+    ZPL_ASSERT_NOT_NULL(proc);
+    zpl__jobs_range r = {0};
+    zpl_isize count = end - begin, participants = pool->max_threads + 1;
+
+    if (count <= 0) {
+        return;
+    }
+
+    grain = zpl__jobs_range_grain(pool, count, participants, grain);
+    participants = zpl_min(participants, (count + grain - 1) / grain);
+
+    r.end = end;
+    r.range_proc = proc;
+    r.data = data;
+    zpl__jobs_range_run(pool, &r, begin, grain, participants);
+}
+
+void zpl_jobs_parallel_reduce(zpl_jobs_system *pool, zpl_isize begin, zpl_isize end, zpl_isize grain,
+                              zpl_jobs_reduce_proc proc, zpl_jobs_combine_proc combine, void *data,
+                              void *result, zpl_isize result_size) {
+    ZPL_ASSERT_NOT_NULL(proc);
+    ZPL_ASSERT_NOT_NULL(combine);
+    ZPL_ASSERT_NOT_NULL(result);
+    zpl__jobs_range r = {0};
+    zpl_isize count = end - begin, participants = pool->max_threads + 1;
+
+    if (count <= 0) {
+        return;
+    }
+
+    grain = zpl__jobs_range_grain(pool, count, participants, grain);
+    participants = zpl_min(participants, (count + grain - 1) / grain);
+
+    r.partials = cast(zpl_u8 *)zpl_alloc(pool->alloc, participants * result_size);
+    if (!r.partials) {
+        proc(data, begin, end, result);
+        return;
+    }
+    for (zpl_isize i = 0; i < participants; ++i) {
+        zpl_memcopy(r.partials + i * result_size, result, result_size);
+    }
+
+    r.end = end;
+    r.reduce_proc = proc;
+    r.data = data;
+    r.partial_size = result_size;
+    zpl__jobs_range_run(pool, &r, begin, grain, participants);
+
+    for (zpl_isize i = 0; i < participants; ++i) {
+        combine(data, result, r.partials + i * result_size);
+    }
+
+    zpl_free(pool->alloc, r.partials);
 }
 
 zpl_b32 zpl_jobs_enqueue(zpl_jobs_system *pool, zpl_jobs_proc proc, void *data) {
@@ -114,15 +804,21 @@ zpl_b32 zpl_jobs_enqueue(zpl_jobs_system *pool, zpl_jobs_proc proc, void *data)
 
 zpl_b32 zpl_jobs_empty(zpl_jobs_system *pool, zpl_jobs_priority priority) {
     ZPL_ASSERT(priority >= 0 && priority < ZPL_JOBS_MAX_PRIORITIES);
-    return zpl__jobs_ring_empty(&pool->queues[priority].jobs);
+    zpl__jobs_queue *q = &pool->queues[priority].jobs;
+    return zpl_atomic64_load(&q->head) >= zpl_atomic64_load(&q->tail);
 }
 
 zpl_b32 zpl_jobs_full(zpl_jobs_system *pool, zpl_jobs_priority priority) {
     ZPL_ASSERT(priority >= 0 && priority < ZPL_JOBS_MAX_PRIORITIES);
-    return zpl__jobs_ring_full(&pool->queues[priority].jobs);
+    zpl__jobs_queue *q = &pool->queues[priority].jobs;
+    return zpl_atomic64_load(&q->tail) - zpl_atomic64_load(&q->head) > q->mask;
 }
 
 zpl_b32 zpl_jobs_done(zpl_jobs_system *pool) {
+    if (pool->flags & ZPL_JOBS_FLAG_WORK_STEALING) {
+        return zpl_atomic32_load(&pool->pending) == 0;
+    }
+
     for (zpl_usize i = 0; i < pool->max_threads; ++i) {
         zpl_thread_worker *tw = pool->workers + i;
         if (zpl_atomic32_load(&tw->status) != ZPL_JOBS_STATUS_WAITING) {
@@ -152,6 +848,9 @@ zpl_b32 zpl_jobs_full_all(zpl_jobs_system *pool) {
 }
 
 zpl_b32 zpl_jobs_process(zpl_jobs_system *pool) {
+    if (pool->flags & ZPL_JOBS_FLAG_WORK_STEALING) {
+        return !zpl_jobs_done(pool);
+    }
     if (zpl_jobs_empty_all(pool)) {
         return false;
     }
@@ -159,26 +858,17 @@ zpl_b32 zpl_jobs_process(zpl_jobs_system *pool) {
     for (zpl_usize i = 0; i < pool->max_threads; ++i) {
         zpl_thread_worker *tw = pool->workers + i;
         zpl_u32 status = zpl_atomic32_load(&tw->status);
-        zpl_b32 last_empty = false;
-
-        if (status == ZPL_JOBS_STATUS_WAITING) {
-            for (zpl_usize j = 0; j < ZPL_JOBS_MAX_PRIORITIES; ++j) {
-                zpl_thread_queue *q = &pool->queues[j];
-                if (zpl_jobs_empty(pool, (zpl_jobs_priority)j)) {
-                    last_empty = (j+1 == ZPL_JOBS_MAX_PRIORITIES);
-                    continue;
-                }
-                if (!last_empty && ((pool->counter++ % q->chance) != 0)) {
-                    continue;
-                }
-
-                last_empty = false;
-                tw->job = *zpl__jobs_ring_get(&q->jobs);
+
+        // NOTE: Claim the worker first, so that other threads helping in zpl_jobs_wait can dispatch too
+        if (status == ZPL_JOBS_STATUS_WAITING &&
+            zpl_atomic32_compare_exchange(&tw->status, ZPL_JOBS_STATUS_WAITING, ZPL_JOBS_STATUS_BUSY) == ZPL_JOBS_STATUS_WAITING) {
+            // NOTE: Claiming the worker makes its counter ours, helpers in zpl_jobs_wait can't race on a shared one
+            if (zpl__jobs_dequeue(pool, &tw->counter, &tw->job)) {
                 zpl_atomic32_store(&tw->status, ZPL_JOBS_STATUS_READY);
-#            ifdef ZPL_JOBS_DEBUG
-                ++q->hits;
-#            endif
-                break;
+                zpl_mfence();
+                zpl__jobs_unpark(tw);
+            } else {
+                zpl_atomic32_store(&tw->status, ZPL_JOBS_STATUS_WAITING);
             }
         }
     }
@@ -13,13 +13,43 @@
 #define ZPL_JSON_ASSERT(msg)
 #endif
 
+#if !defined(ZPL_JSON_NO_SIMD)
+#    if defined(__AVX2__)
+#        define ZPL_JSON_AVX2
+#        include <immintrin.h>
+#    elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define ZPL_JSON_SSE2
+#        include <emmintrin.h>
+#    elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#        define ZPL_JSON_NEON
+#        include <arm_neon.h>
+#    endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#endif
+
 ZPL_BEGIN_C_DECLS
 
-char *zpl__json_parse_object(zpl_adt_node *obj, char *base, zpl_allocator a, zpl_u8 *err_code);
-char *zpl__json_parse_array(zpl_adt_node *obj, char *base, zpl_allocator a, zpl_u8 *err_code);
-char *zpl__json_parse_value(zpl_adt_node *obj, char *base, zpl_allocator a, zpl_u8 *err_code);
-char *zpl__json_parse_name(zpl_adt_node *obj, char *base, zpl_u8 *err_code);
-char *zpl__json_trim(char *base, zpl_b32 catch_newline);
+/* Structural index: the input is classified 64 bytes at a time into bitmasks of whitespace, newlines and quotes.
+   The tree builder asks the index for the block under its cursor and skips whitespace runs and string bodies with
+   a single bit scan instead of testing each byte. Blocks are classified when the cursor first enters them, so the
+   index never holds more than one block and needs no memory of its own. */
+typedef struct zpl__json_index {
+    char const *text;
+    zpl_isize len; // NOTE: offset of the next terminator, the builder may step past it into a nulled string end
+    zpl_isize block; // NOTE: offset of the classified block
+    zpl_u64 space;
+    zpl_u64 newline;
+    zpl_u64 quote;
+} zpl__json_index;
+
+char *zpl__json_parse_object(zpl_adt_node *obj, char *base, zpl__adt_tape *t, zpl_u8 *err_code, zpl__json_index *ix);
+char *zpl__json_parse_array(zpl_adt_node *obj, char *base, zpl__adt_tape *t, zpl_u8 *err_code, zpl__json_index *ix);
+char *zpl__json_parse_value(zpl_adt_node *obj, char *base, zpl__adt_tape *t, zpl_u8 *err_code, zpl__json_index *ix);
+char *zpl__json_parse_name(zpl_adt_node *obj, char *base, zpl_u8 *err_code, zpl__json_index *ix);
+char *zpl__json_trim(char *base, zpl_b32 catch_newline, zpl__json_index *ix);
 zpl_b8 zpl__json_write_value(zpl_file *f, zpl_adt_node *o, zpl_adt_node *t, zpl_isize indent, zpl_b32 is_inline, zpl_b32 is_last);
 
 #define zpl__json_fprintf(s_, fmt_, ...)                                                                               \
@@ -34,15 +64,32 @@ zpl_u8 zpl_json_parse(zpl_adt_node *root, char *text, zpl_allocator a) {
     ZPL_ASSERT(root);
     ZPL_ASSERT(text);
     zpl_zero_item(root);
-    text = zpl__json_trim(text, true);
+
+    zpl__json_index ix;
+    ix.text = text;
+    ix.len = cast(zpl_isize)strlen(text); // NOTE: libc's is vectorized, zpl_strlen walks bytes
+    ix.block = -64;
+    text = zpl__json_trim(text, true, &ix);
 
 #ifndef ZPL_PARSER_DISABLE_ANALYSIS
-    if (!zpl_strchr("{[", *text)) {
+    if (*text && *text != '{' && *text != '[') {
         root->cfg_mode = true;
     }
 #endif
 
-    zpl__json_parse_object(root, text, a, &err_code);
+    zpl__adt_tape t;
+    if (!zpl__adt_tape_init(&t, a)) {
+        return ZPL_JSON_ERROR_OUT_OF_MEMORY;
+    }
+
+    zpl__json_parse_object(root, text, &t, &err_code, &ix);
+
+    if (err_code != ZPL_JSON_ERROR_NONE) {
+        zpl__adt_tape_discard(&t);
+        root->nodes = NULL;
+        return err_code;
+    }
+    zpl__adt_tape_finish(&t);
     return err_code;
 }
 
@@ -65,20 +112,26 @@ zpl_string zpl_json_write_string(zpl_allocator a, zpl_adt_node *obj, zpl_isize i
 
 /* private */
 
-#define zpl__json_append_node(x, item)\
+#define zpl__json_push_node(item)\
 do {\
-if (!zpl_array_append(x, item)) {\
+if (!zpl__adt_tape_push(t, &item)) {\
     *err_code = ZPL_JSON_ERROR_OUT_OF_MEMORY;\
     return NULL;\
 }\
-if (item.type == ZPL_ADT_TYPE_OBJECT || item.type == ZPL_ADT_TYPE_ARRAY) {\
-for (zpl_isize i = 0; i < zpl_array_count(item.nodes); i++)\
-item.nodes[i].parent = zpl_array_end(x);\
+} while (0);
+
+#define zpl__json_close_branch(obj, mark)\
+do {\
+if (!zpl__adt_tape_close(t, obj, mark)) {\
+    *err_code = ZPL_JSON_ERROR_OUT_OF_MEMORY;\
+    return NULL;\
 }\
 } while (0);
 
-static ZPL_ALWAYS_INLINE zpl_b32 zpl__json_is_assign_char(char c) { return !!zpl_strchr(":=|", c); }
-static ZPL_ALWAYS_INLINE zpl_b32 zpl__json_is_delim_char(char c) { return !!zpl_strchr(",|\n", c); }
+static ZPL_ALWAYS_INLINE zpl_b32 zpl__json_is_assign_char(char c) { return c == ':' || c == '=' || c == '|'; }
+/* NOTE: the terminator counts as a delimiter, objects end at it */
+static ZPL_ALWAYS_INLINE zpl_b32 zpl__json_is_delim_char(char c) { return c == ',' || c == '|' || c == '\n' || c == '\0'; }
+static ZPL_ALWAYS_INLINE zpl_b32 zpl__json_is_quote_char(char c) { return c == '"' || c == '\'' || c == '`'; }
 static ZPL_ALWAYS_INLINE const char *zpl__json_string_space(zpl_isize indent) { return indent == ZPL_JSON_INDENT_STYLE_COMPACT ? "" : " "; }
 static ZPL_ALWAYS_INLINE const char *zpl__json_string_eol(zpl_adt_node *o, zpl_isize indent) {
     zpl_b8 force_new_line = false;
@@ -89,6 +142,157 @@ static ZPL_ALWAYS_INLINE const char *zpl__json_string_eol(zpl_adt_node *o, zpl_i
 }
 ZPL_DEF_INLINE zpl_b32 zpl__json_validate_name(char const *str, char *err);
 
+zpl_internal void zpl__json_index_block(zpl__json_index *ix, zpl_isize at) {
+    zpl_isize block = at & ~cast(zpl_isize)63;
+    char const *src = ix->text + block;
+    char tail[64];
+    zpl_u64 space = 0, newline = 0, quote = 0;
+
+    /* the last block is padded with zeroes, they classify as neither and stop every scan at the terminator */
+    if (ix->len - block < 64) {
+        zpl_zero_size(tail, 64);
+        zpl_memcopy(tail, src, ix->len - block);
+        src = tail;
+    }
+
+#if defined(ZPL_JSON_AVX2)
+    for (zpl_isize i = 0; i < 64; i += 32) {
+        __m256i v = _mm256_loadu_si256(cast(__m256i const *)(src + i));
+        __m256i ctl = _mm256_sub_epi8(v, _mm256_set1_epi8(9)); /* \t..\r map to 0..4 */
+        __m256i sp = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                     _mm256_cmpeq_epi8(_mm256_min_epu8(ctl, _mm256_set1_epi8(4)), ctl));
+        __m256i nl = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+        __m256i q = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                                                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\''))),
+                                    _mm256_cmpeq_epi8(v, _mm256_set1_epi8('`')));
+        space |= cast(zpl_u64)cast(zpl_u32)_mm256_movemask_epi8(sp) << i;
+        newline |= cast(zpl_u64)cast(zpl_u32)_mm256_movemask_epi8(nl) << i;
+        quote |= cast(zpl_u64)cast(zpl_u32)_mm256_movemask_epi8(q) << i;
+    }
+#elif defined(ZPL_JSON_SSE2)
+    for (zpl_isize i = 0; i < 64; i += 16) {
+        __m128i v = _mm_loadu_si128(cast(__m128i const *)(src + i));
+        __m128i ctl = _mm_sub_epi8(v, _mm_set1_epi8(9)); /* \t..\r map to 0..4 */
+        __m128i sp = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                  _mm_cmpeq_epi8(_mm_min_epu8(ctl, _mm_set1_epi8(4)), ctl));
+        __m128i nl = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+        __m128i q = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\''))),
+                                 _mm_cmpeq_epi8(v, _mm_set1_epi8('`')));
+        space |= cast(zpl_u64)_mm_movemask_epi8(sp) << i;
+        newline |= cast(zpl_u64)_mm_movemask_epi8(nl) << i;
+        quote |= cast(zpl_u64)_mm_movemask_epi8(q) << i;
+    }
+#elif defined(ZPL_JSON_NEON)
+    {
+        static const zpl_u8 weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+        uint8x16_t w = vld1q_u8(weights);
+        uint8x16_t sp[4], nl[4], q[4];
+        for (int i = 0; i < 4; ++i) {
+            uint8x16_t v = vld1q_u8(cast(zpl_u8 const *)src + i * 16);
+            uint8x16_t ctl = vsubq_u8(v, vdupq_n_u8(9)); /* \t..\r map to 0..4 */
+            sp[i] = vandq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vcleq_u8(ctl, vdupq_n_u8(4))), w);
+            nl[i] = vandq_u8(vceqq_u8(v, vdupq_n_u8('\n')), w);
+            q[i] = vandq_u8(vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')), vceqq_u8(v, vdupq_n_u8('\''))),
+                                     vceqq_u8(v, vdupq_n_u8('`'))), w);
+        }
+        /* pairwise adds fold the weighted lanes into one bit per byte */
+#define zpl__json_neon_mask(m) vgetq_lane_u64(vreinterpretq_u64_u8(vpaddq_u8(vpaddq_u8(vpaddq_u8(m[0], m[1]), vpaddq_u8(m[2], m[3])), vdupq_n_u8(0))), 0)
+        space = zpl__json_neon_mask(sp);
+        newline = zpl__json_neon_mask(nl);
+        quote = zpl__json_neon_mask(q);
+#undef zpl__json_neon_mask
+    }
+#else
+    for (zpl_isize i = 0; i < 64; ++i) {
+        char c = src[i];
+        space |= cast(zpl_u64)(zpl_char_is_space(c) != 0) << i;
+        newline |= cast(zpl_u64)(c == '\n') << i;
+        quote |= cast(zpl_u64)zpl__json_is_quote_char(c) << i;
+    }
+#endif
+
+    ix->block = block;
+    ix->space = space;
+    ix->newline = newline;
+    ix->quote = quote;
+}
+
+/* classifies the block holding at, offsets past the terminator are clamped to it */
+zpl_internal ZPL_ALWAYS_INLINE zpl_isize zpl__json_index_at(zpl__json_index *ix, zpl_isize at) {
+    if (at > ix->len) at = ix->len;
+    if (cast(zpl_usize)(at - ix->block) >= 64) zpl__json_index_block(ix, at);
+    return at;
+}
+
+zpl_internal ZPL_ALWAYS_INLINE zpl_isize zpl__json_index_bit(zpl_u64 mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return cast(zpl_isize)__builtin_ctzll(mask);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return cast(zpl_isize)index;
+#else
+    zpl_isize index = 0;
+    while (!(mask & 1)) { mask >>= 1; ++index; }
+    return index;
+#endif
+}
+
+/* returns the first byte at or after p that is not whitespace (or is a newline when asked to catch them) */
+zpl_internal char *zpl__json_index_skip_space(zpl__json_index *ix, char *p, zpl_b32 catch_newline) {
+    zpl_isize at = p - ix->text;
+
+    /* the zero padding past the terminator always stops this */
+    for (;;) {
+        at = zpl__json_index_at(ix, at);
+        zpl_u64 stop = (~ix->space | (catch_newline ? ix->newline : 0)) >> (at - ix->block);
+        if (stop) return cast(char *)ix->text + at + zpl__json_index_bit(stop);
+        at = ix->block + 64;
+    }
+}
+
+/* returns the closing quote c at or after p, quotes preceded by a backslash are skipped when escapes are enabled */
+zpl_internal char *zpl__json_index_skip_quoted(zpl__json_index *ix, char *p, char c, zpl_b32 escapes) {
+    zpl_isize at = p - ix->text;
+
+    for (;;) {
+        at = zpl__json_index_at(ix, at);
+        zpl_u64 hits = ix->quote >> (at - ix->block);
+        while (hits) {
+            char *q = cast(char *)ix->text + at + zpl__json_index_bit(hits);
+            if (*q == c && !(escapes && *(q - 1) == '\\')) return q;
+            hits &= hits - 1;
+        }
+        if (ix->block + 64 > ix->len) return cast(char *)ix->text + ix->len;
+        at = ix->block + 64;
+    }
+}
+
+/* decodes a complete keyword or number token, used where values are not parsed in place */
+zpl_internal zpl_u8 zpl__json_parse_token(zpl_adt_node *node, char *buf) {
+    node->type = ZPL_ADT_TYPE_REAL;
+    /**/ if (!zpl_strcmp(buf, "true"))      { node->props = ZPL_ADT_PROPS_TRUE; node->real = 1; }
+    else if (!zpl_strcmp(buf, "false"))     { node->props = ZPL_ADT_PROPS_FALSE; node->real = 0; }
+    else if (!zpl_strcmp(buf, "null"))      { node->props = ZPL_ADT_PROPS_NULL; node->real = 0; }
+    else if (!zpl_strcmp(buf, "Infinity"))  { node->props = ZPL_ADT_PROPS_INFINITY; node->real = ZPL_INFINITY; }
+    else if (!zpl_strcmp(buf, "-Infinity")) { node->props = ZPL_ADT_PROPS_INFINITY_NEG; node->real = -ZPL_INFINITY; }
+    else if (!zpl_strcmp(buf, "NaN"))       { node->props = ZPL_ADT_PROPS_NAN; node->real = ZPL_NAN; }
+    else if (!zpl_strcmp(buf, "-NaN"))      { node->props = ZPL_ADT_PROPS_NAN_NEG; node->real = -ZPL_NAN; }
+    else if (zpl_char_is_digit(*buf) || *buf == '+' || *buf == '-' || *buf == '.') {
+        node->type = ZPL_ADT_TYPE_UNINITIALISED;
+        char *e = zpl_adt_parse_number(node, buf);
+        if (*e || (node->type != ZPL_ADT_TYPE_INTEGER && node->type != ZPL_ADT_TYPE_REAL)) {
+            node->type = ZPL_ADT_TYPE_UNINITIALISED;
+            return ZPL_JSON_ERROR_INVALID_VALUE;
+        }
+    }
+    else {
+        node->type = ZPL_ADT_TYPE_UNINITIALISED;
+        return ZPL_JSON_ERROR_UNKNOWN_KEYWORD;
+    }
+    return ZPL_JSON_ERROR_NONE;
+}
+
 #define jx(x) !zpl_char_is_hex_digit(str[x])
 ZPL_IMPL_INLINE zpl_b32 zpl__json_validate_name(char const *str, char *err) {
     while (*str) {
@@ -106,31 +310,29 @@ ZPL_IMPL_INLINE zpl_b32 zpl__json_validate_name(char const *str, char *err) {
 }
 #undef jx
 
-char *zpl__json_parse_array(zpl_adt_node *obj, char *base, zpl_allocator a, zpl_u8 *err_code) {
+char *zpl__json_parse_array(zpl_adt_node *obj, char *base, zpl__adt_tape *t, zpl_u8 *err_code, zpl__json_index *ix) {
     ZPL_ASSERT(obj && base);
     char *p = base;
 
     obj->type = ZPL_ADT_TYPE_ARRAY;
-    if (!zpl_array_init(obj->nodes, a)) {
-        *err_code = ZPL_JSON_ERROR_OUT_OF_MEMORY;
-        return NULL;
-    }
+    zpl_isize mark = zpl__adt_tape_mark(t);
 
     while (*p) {
-        p = zpl__json_trim(p, false);
+        p = zpl__json_trim(p, false, ix);
 
         if (*p == ']') {
+            zpl__json_close_branch(obj, mark);
             return p;
         }
 
         zpl_adt_node elem = { 0 };
-        p = zpl__json_parse_value(&elem, p, a, err_code);
+        p = zpl__json_parse_value(&elem, p, t, err_code, ix);
 
         if (*err_code != ZPL_JSON_ERROR_NONE) { return NULL; }
 
-        zpl__json_append_node(obj->nodes, elem);
+        zpl__json_push_node(elem);
 
-        p = zpl__json_trim(p, false);
+        p = zpl__json_trim(p, false, ix);
 
         if (*p == ',') {
             ++p;
@@ -141,6 +343,7 @@ char *zpl__json_parse_array(zpl_adt_node *obj, char *base, zpl_allocator a, zpl_
                 *err_code = ZPL_JSON_ERROR_ARRAY_LEFT_OPEN;
                 return NULL;
             }
+            zpl__json_close_branch(obj, mark);
             return p;
         }
     }
@@ -149,118 +352,91 @@ char *zpl__json_parse_array(zpl_adt_node *obj, char *base, zpl_allocator a, zpl_
     return NULL;
 }
 
-char *zpl__json_parse_value(zpl_adt_node *obj, char *base, zpl_allocator a, zpl_u8 *err_code) {
+char *zpl__json_parse_value(zpl_adt_node *obj, char *base, zpl__adt_tape *t, zpl_u8 *err_code, zpl__json_index *ix) {
     ZPL_ASSERT(obj && base);
     char *p = base, *b = p, *e = p;
 
     /* handle quoted strings */
-    if (!!zpl_strchr("`\"'", *p)) {
+    if (zpl__json_is_quote_char(*p)) {
         char c = *p;
         obj->type = (c == '`') ? ZPL_ADT_TYPE_MULTISTRING : ZPL_ADT_TYPE_STRING;
         b = e = p + 1;
         obj->string = b;
-        e = cast(char *)zpl_str_skip_literal(e, c);
-        *e = '\0', p = e + 1;
+        e = zpl__json_index_skip_quoted(ix, e, c, true);
+        p = e;
+        if (e < ix->text + ix->len) *e = '\0', ++p; /* unterminated strings stop at the terminator */
     } else if (zpl_char_is_alpha(*p) || (*p == '-' && !zpl_char_is_digit(*(p + 1)))) {
-        /* handle constants */
-        if (zpl_str_has_prefix(p, "true")) {
-            obj->type = ZPL_ADT_TYPE_REAL;
-            obj->props = ZPL_ADT_PROPS_TRUE;
-            obj->real = 1;
-            p += 4;
-        } else if (zpl_str_has_prefix(p, "false")) {
-            obj->type = ZPL_ADT_TYPE_REAL;
-            obj->props = ZPL_ADT_PROPS_FALSE;
-            obj->real = 0;
-            p += 5;
-        } else if (zpl_str_has_prefix(p, "null")) {
-            obj->type = ZPL_ADT_TYPE_REAL;
-            obj->props = ZPL_ADT_PROPS_NULL;
-            obj->real = 0;
-            p += 4;
-        } else if (zpl_str_has_prefix(p, "Infinity")) {
-            obj->type = ZPL_ADT_TYPE_REAL;
-            obj->real = ZPL_INFINITY;
-            obj->props = ZPL_ADT_PROPS_INFINITY;
-            p += 8;
-        } else if (zpl_str_has_prefix(p, "-Infinity")) {
-            obj->type = ZPL_ADT_TYPE_REAL;
-            obj->real = -ZPL_INFINITY;
-            obj->props = ZPL_ADT_PROPS_INFINITY_NEG;
-            p += 9;
-        } else if (zpl_str_has_prefix(p, "NaN")) {
-            obj->type = ZPL_ADT_TYPE_REAL;
-            obj->real = ZPL_NAN;
-            obj->props = ZPL_ADT_PROPS_NAN;
-            p += 3;
-        } else if (zpl_str_has_prefix(p, "-NaN")) {
-            obj->type = ZPL_ADT_TYPE_REAL;
-            obj->real = -ZPL_NAN;
-            obj->props = ZPL_ADT_PROPS_NAN_NEG;
-            p += 4;
-        } else {
+        /* handle constants, decoded the same way as in the cursor and the stream parser */
+        char token[16];
+        zpl_isize len = 0;
+        while (len < zpl_size_of(token) - 1 && (zpl_char_is_alpha(p[len]) || (len == 0 && p[len] == '-'))) {
+            token[len] = p[len];
+            ++len;
+        }
+        token[len] = '\0';
+
+        if (zpl__json_parse_token(obj, token) != ZPL_JSON_ERROR_NONE) {
             ZPL_JSON_ASSERT("unknown keyword");
             *err_code = ZPL_JSON_ERROR_UNKNOWN_KEYWORD;
             return NULL;
         }
+        p += len;
     } else if (zpl_char_is_digit(*p) || *p == '+' || *p == '-' || *p == '.') {
         /* handle numbers */
         /* defer operation to our helper method. */
         p = zpl_adt_parse_number(obj, p);
-    } else if (!!zpl_strchr("[{", *p)) {
+    } else if (*p == '[' || *p == '{') {
         /* handle compound objects */
-        p = zpl__json_parse_object(obj, p, a, err_code);
+        p = zpl__json_parse_object(obj, p, t, err_code, ix);
         ++p;
     }
 
     return p;
 }
 
-char *zpl__json_parse_object(zpl_adt_node *obj, char *base, zpl_allocator a, zpl_u8 *err_code) {
+char *zpl__json_parse_object(zpl_adt_node *obj, char *base, zpl__adt_tape *t, zpl_u8 *err_code, zpl__json_index *ix) {
     ZPL_ASSERT(obj && base);
     char *p = base;
 
-    p = zpl__json_trim(p, false);
+    p = zpl__json_trim(p, false, ix);
     /**/ if (*p == '{') { ++p; }
     else if (*p == '[') { /* special case for when we call this func on an array. */
         ++p;
         obj->type = ZPL_ADT_TYPE_ARRAY;
-        return zpl__json_parse_array(obj, p, a, err_code);
+        return zpl__json_parse_array(obj, p, t, err_code, ix);
     }
 
-    if (!zpl_array_init(obj->nodes, a)) {
-        *err_code = ZPL_JSON_ERROR_OUT_OF_MEMORY;
-        return NULL;
-    }
+    zpl_isize mark = zpl__adt_tape_mark(t);
     obj->type = ZPL_ADT_TYPE_OBJECT;
 
     do {
         zpl_adt_node node = { 0 };
-        p = zpl__json_trim(p, false);
-        if (*p == '}' && obj->type == ZPL_ADT_TYPE_OBJECT) return p;
-        else if (*p == ']' && obj->type == ZPL_ADT_TYPE_ARRAY) return p;
-        else if (!!zpl_strchr("}]", *p)) {
+        p = zpl__json_trim(p, false, ix);
+        if (*p == '}') break;
+        else if (*p == ']' || *p == '\0') {
             ZPL_JSON_ASSERT("mismatched end pair");
             *err_code = ZPL_JSON_ERROR_OBJECT_END_PAIR_MISMATCHED;
             return NULL;
         }
 
         /* First, we parse the key, then we proceed to the value itself. */
-        p = zpl__json_parse_name(&node, p, err_code);
+        p = zpl__json_parse_name(&node, p, err_code, ix);
         if (err_code && *err_code != ZPL_JSON_ERROR_NONE) { return NULL; }
-        p = zpl__json_trim(p + 1, false);
-        p = zpl__json_parse_value(&node, p, a, err_code);
+        /* skip the assignment (already nulled behind unquoted names), unless the name ran into the terminator */
+        if (p < ix->text + ix->len) ++p;
+        p = zpl__json_trim(p, false, ix);
+        p = zpl__json_parse_value(&node, p, t, err_code, ix);
         if (err_code && *err_code != ZPL_JSON_ERROR_NONE) { return NULL; }
 
-        zpl__json_append_node(obj->nodes, node);
+        zpl__json_push_node(node);
 
         char *end_p = p; zpl_unused(end_p);
-        p = zpl__json_trim(p, true);
+        p = zpl__json_trim(p, true, ix);
 
         /* this code analyses the keyvalue pair delimiter used in the packet. */
         if (zpl__json_is_delim_char(*p)) {
 #ifndef ZPL_PARSER_DISABLE_ANALYSIS
-            zpl_adt_node *n = zpl_array_end(obj->nodes);
+            zpl_adt_node *n = zpl_array_end(t->pending);
             n->delim_style = ZPL_ADT_DELIM_STYLE_COMMA;
 
             if (*p == '\n')
@@ -271,16 +447,18 @@ char *zpl__json_parse_object(zpl_adt_node *obj, char *base, zpl_allocator a, zpl
             }
 #endif
             if (*p == 0) {
-                return p;
+                break;
             }
             ++p;
         }
-        p = zpl__json_trim(p, false);
+        p = zpl__json_trim(p, false, ix);
     } while (*p);
+
+    zpl__json_close_branch(obj, mark);
     return p;
 }
 
-char *zpl__json_parse_name(zpl_adt_node *node, char *base, zpl_u8 *err_code) {
+char *zpl__json_parse_name(zpl_adt_node *node, char *base, zpl_u8 *err_code, zpl__json_index *ix) {
     char *p = base, *b = p, *e = p;
     zpl_u8 name_style=0;
 
@@ -295,11 +473,11 @@ char *zpl__json_parse_name(zpl_adt_node *node, char *base, zpl_u8 *err_code) {
 #endif
             char c = *p;
             b = ++p;
-            e = cast(char *)zpl_str_control_skip(b, c);
+            e = zpl__json_index_skip_quoted(ix, b, c, zpl_char_is_control(c));
             node->name = b;
 
             /* we can safely null-terminate here, since "e" points to the quote pair end. */
-            *e++ = '\0';
+            if (e < ix->text + ix->len) *e++ = '\0';
         }
         else {
             b = e = p;
@@ -310,7 +488,7 @@ char *zpl__json_parse_name(zpl_adt_node *node, char *base, zpl_u8 *err_code) {
         }
 
         char *assign_p = e; zpl_unused(assign_p);
-        p = zpl__json_trim(e, false);
+        p = zpl__json_trim(e, false, ix);
 #ifndef ZPL_PARSER_DISABLE_ANALYSIS
         node->assign_line_width = cast(zpl_u8)(p-assign_p);
 #endif
@@ -349,29 +527,27 @@ char *zpl__json_parse_name(zpl_adt_node *node, char *base, zpl_u8 *err_code) {
     return p;
 }
 
-char *zpl__json_trim(char *base, zpl_b32 catch_newline) {
+char *zpl__json_trim(char *base, zpl_b32 catch_newline, zpl__json_index *ix) {
     ZPL_ASSERT_NOT_NULL(base);
     char *p = base;
-    do {
-        if (zpl_str_has_prefix(p, "//")) {
-            const char *e = zpl_str_skip(p, '\n');
-            p += (e-p);
+    for (;;) {
+        p = zpl__json_index_skip_space(ix, p, catch_newline);
+
+        if (*p == '/' && *(p+1) == '/') {
+            p = cast(char *)zpl_str_skip(p, '\n');
+            if (*p) ++p; /* the comment owns its newline */
         }
-        else if (zpl_str_has_prefix(p, "/*")) {
+        else if (*p == '/' && *(p+1) == '*') {
             const char *e = zpl_str_skip(p+2, '*');
-            if (*e && *(e+1) == '/') {
-                e+=2; /* advance past end comment block */
-                p += (e-p);
+            if (!*e || *(e+1) != '/') {
+                return p;
             }
+            p = cast(char *)e + 2; /* advance past end comment block */
         }
-        else if (*p == '\n' && catch_newline) {
-            return p;
-        }
-        else if (!zpl_char_is_space(*p)) {
+        else {
             return p;
         }
-    } while (*p++);
-    return NULL;
+    }
 }
 
 zpl_b8 zpl_json_write(zpl_file *f, zpl_adt_node *o, zpl_isize indent) {
@@ -521,6 +697,7 @@ zpl_b8 zpl__json_write_value(zpl_file *f, zpl_adt_node *o, zpl_adt_node *t, zpl_
 
 #undef zpl__json_fprintf
 #undef zpl___ind
-#undef zpl__json_append_node
+#undef zpl__json_push_node
+#undef zpl__json_close_branch
 
 ZPL_END_C_DECLS
@@ -0,0 +1,323 @@
+// file: source/parsers/json_cursor.c
+
+////////////////////////////////////////////////////////////////
+//
+// JSON5 Cursor
+//
+//
+
+ZPL_BEGIN_C_DECLS
+
+/* private */
+
+zpl_internal char const *zpl__json_cursor_trim(char const *p, char const *end) {
+    while (p < end) {
+        if (zpl_char_is_space(*p)) {
+            ++p;
+        }
+        else if (*p == '/' && p + 1 < end && *(p+1) == '/') {
+            char const *e = cast(char const *)zpl_memchr(p, '\n', end - p);
+            p = e ? e + 1 : end;
+        }
+        else if (*p == '/' && p + 1 < end && *(p+1) == '*') {
+            p += 2;
+            while (p + 1 < end && !(*p == '*' && *(p+1) == '/')) ++p;
+            p = zpl_min(p + 2, end);
+        }
+        else {
+            break;
+        }
+    }
+    return p;
+}
+
+/* returns the closing quote, or end for unterminated strings */
+zpl_internal char const *zpl__json_cursor_string_end(char const *p, char const *end) {
+    char q = *p++;
+    while (p < end) {
+        char const *e = cast(char const *)zpl_memchr(p, cast(zpl_u8)q, end - p);
+        if (!e) break;
+
+        /* an odd run of backslashes escapes the quote */
+        zpl_isize slashes = 0;
+        while (e - slashes > p && *(e - slashes - 1) == '\\') ++slashes;
+        if ((slashes & 1) == 0) return e;
+        p = e + 1;
+    }
+    return end;
+}
+
+zpl_internal zpl_b32 zpl__json_cursor_is_quote(char c) { return c == '"' || c == '\'' || c == '`'; }
+zpl_internal zpl_b32 zpl__json_cursor_is_token_end(char c) {
+    return zpl_char_is_space(c) || c == ',' || c == '|' || c == ']' || c == '}' || c == '/';
+}
+
+/* matches brackets to skip a whole object or array, strings and comments may contain unbalanced ones */
+zpl_internal char const *zpl__json_cursor_skip_container(char const *p, char const *end) {
+    zpl_isize depth = 0;
+    while (p < end) {
+        switch (*p) {
+            case '"': case '\'': case '`': {
+                p = zpl_min(zpl__json_cursor_string_end(p, end) + 1, end);
+            } break;
+
+            case '/': {
+                char const *e = zpl__json_cursor_trim(p, end);
+                p = (e == p) ? p + 1 : e;
+            } break;
+
+            case '{': case '[': {
+                ++depth, ++p;
+            } break;
+
+            case '}': case ']': {
+                ++p;
+                if (--depth == 0) return p;
+            } break;
+
+            default: ++p;
+        }
+    }
+    return end;
+}
+
+zpl_internal char const *zpl__json_cursor_skip_value(char const *p, char const *end) {
+    if (p >= end) return end;
+    if (*p == '{' || *p == '[') return zpl__json_cursor_skip_container(p, end);
+    if (zpl__json_cursor_is_quote(*p)) return zpl_min(zpl__json_cursor_string_end(p, end) + 1, end);
+    while (p < end && !zpl__json_cursor_is_token_end(*p)) ++p;
+    return p;
+}
+
+/* reads the member starting at p (name and assignment for objects) and points c at its value */
+zpl_internal zpl_b32 zpl__json_cursor_member(zpl_json_cursor *c, char const *p) {
+    char const *end = c->end;
+    p = zpl__json_cursor_trim(p, end);
+    c->name = NULL, c->name_len = 0;
+
+    if (p >= end || *p == '}' || *p == ']') {
+        c->value = NULL;
+        return false;
+    }
+
+    if (c->in_object) {
+        if (*p == '"' || *p == '\'') {
+            char const *e = zpl__json_cursor_string_end(p, end);
+            c->name = p + 1;
+            c->name_len = e - c->name;
+            p = zpl_min(e + 1, end);
+        }
+        else if (zpl_char_is_alpha(*p) || *p == '_' || *p == '$') {
+            c->name = p;
+            do { ++p; } while (p < end && (zpl_char_is_alphanumeric(*p) || *p == '_'));
+            c->name_len = p - c->name;
+        }
+        else {
+            c->value = NULL;
+            return false;
+        }
+
+        p = zpl__json_cursor_trim(p, end);
+        if (p >= end || (*p != ':' && *p != '=' && *p != '|')) {
+            c->value = NULL;
+            return false;
+        }
+        p = zpl__json_cursor_trim(p + 1, end);
+    }
+
+    c->value = (p < end) ? p : NULL;
+    return c->value != NULL;
+}
+
+/* decodes numbers and keywords into a leaf, the same way zpl_json_parse does */
+zpl_internal zpl_b32 zpl__json_cursor_leaf(zpl_json_cursor const *c, zpl_adt_node *node) {
+    char buf[64];
+    zpl_zero_item(node);
+    if (!zpl_json_cursor_valid(c) || c->cfg_mode) return false;
+
+    zpl_isize len = zpl__json_cursor_skip_value(c->value, c->end) - c->value;
+    if (len <= 0 || len >= zpl_size_of(buf)) return false;
+    zpl_memcopy(buf, c->value, len);
+    buf[len] = '\0';
+
+    return zpl__json_parse_token(node, buf) == ZPL_JSON_ERROR_NONE;
+}
+
+zpl_internal zpl_json_cursor zpl__json_cursor_find(zpl_json_cursor const *c, char const *name, zpl_isize len) {
+    zpl_json_cursor it;
+    if (zpl_json_cursor_first(c, &it) && it.in_object) {
+        do {
+            if (it.name_len == len && !zpl_strncmp(it.name, name, len)) return it;
+        } while (zpl_json_cursor_next(&it));
+    }
+    zpl_zero_item(&it);
+    return it;
+}
+
+/* public */
+
+zpl_json_cursor zpl_json_cursor_make(char const *text, zpl_isize len) {
+    zpl_json_cursor c = {0};
+    ZPL_ASSERT(text || len == 0);
+    c.end = text + len;
+    c.value = zpl__json_cursor_trim(text, c.end);
+
+    if (c.value >= c.end) {
+        c.value = NULL;
+    }
+    else if (*c.value != '{' && *c.value != '[') {
+        c.cfg_mode = true;
+    }
+    return c;
+}
+
+zpl_u8 zpl_json_cursor_type(zpl_json_cursor const *c) {
+    zpl_adt_node leaf;
+    if (!zpl_json_cursor_valid(c)) return ZPL_ADT_TYPE_UNINITIALISED;
+    if (c->cfg_mode || *c->value == '{') return ZPL_ADT_TYPE_OBJECT;
+    if (*c->value == '[') return ZPL_ADT_TYPE_ARRAY;
+    if (*c->value == '`') return ZPL_ADT_TYPE_MULTISTRING;
+    if (*c->value == '"' || *c->value == '\'') return ZPL_ADT_TYPE_STRING;
+    zpl__json_cursor_leaf(c, &leaf);
+    return leaf.type;
+}
+
+zpl_json_cursor zpl_json_cursor_find(zpl_json_cursor const *c, char const *name) {
+    ZPL_ASSERT_NOT_NULL(name);
+    return zpl__json_cursor_find(c, name, zpl_strlen(name));
+}
+
+zpl_json_cursor zpl_json_cursor_at(zpl_json_cursor const *c, zpl_isize index) {
+    zpl_json_cursor it;
+    if (index >= 0 && zpl_json_cursor_first(c, &it)) {
+        while (index-- > 0) {
+            if (!zpl_json_cursor_next(&it)) break;
+        }
+        if (index < 0) return it;
+    }
+    zpl_zero_item(&it);
+    return it;
+}
+
+zpl_json_cursor zpl_json_cursor_query(zpl_json_cursor const *c, char const *path) {
+    ZPL_ASSERT_NOT_NULL(path);
+    zpl_json_cursor it = *c;
+
+    while (*path && zpl_json_cursor_valid(&it)) {
+        char const *e = zpl_str_skip(path, '/');
+        zpl_isize len = e - path;
+        zpl_b32 is_index = len > 0;
+
+        for (zpl_isize i = 0; i < len; ++i) {
+            if (!zpl_char_is_digit(path[i])) is_index = false;
+        }
+
+        if (is_index && zpl_json_cursor_type(&it) == ZPL_ADT_TYPE_ARRAY) {
+            it = zpl_json_cursor_at(&it, cast(zpl_isize)zpl_str_to_i64(path, NULL, 10));
+        }
+        else if (len > 0) {
+            it = zpl__json_cursor_find(&it, path, len);
+        }
+
+        path = *e ? e + 1 : e;
+    }
+    return it;
+}
+
+zpl_b32 zpl_json_cursor_first(zpl_json_cursor const *c, zpl_json_cursor *child) {
+    ZPL_ASSERT_NOT_NULL(child);
+    zpl_zero_item(child);
+    if (!zpl_json_cursor_valid(c)) return false;
+
+    child->end = c->end;
+    if (c->cfg_mode) {
+        child->in_object = true;
+        return zpl__json_cursor_member(child, c->value);
+    }
+    if (*c->value != '{' && *c->value != '[') return false;
+
+    child->in_object = (*c->value == '{');
+    return zpl__json_cursor_member(child, c->value + 1);
+}
+
+zpl_b32 zpl_json_cursor_next(zpl_json_cursor *c) {
+    ZPL_ASSERT_NOT_NULL(c);
+    if (!zpl_json_cursor_valid(c)) return false;
+
+    char const *p = zpl__json_cursor_skip_value(c->value, c->end);
+    p = zpl__json_cursor_trim(p, c->end);
+    if (p < c->end && (*p == ',' || *p == '|')) ++p;
+
+    /* a stray character (e.g. a lone '/') that is neither a value nor a separator, stop instead of looping on it */
+    if (p == c->value) {
+        c->value = NULL;
+        return false;
+    }
+    return zpl__json_cursor_member(c, p);
+}
+
+zpl_isize zpl_json_cursor_count(zpl_json_cursor const *c) {
+    zpl_json_cursor it;
+    zpl_isize count = 0;
+    if (zpl_json_cursor_first(c, &it)) {
+        do { ++count; } while (zpl_json_cursor_next(&it));
+    }
+    return count;
+}
+
+char const *zpl_json_cursor_raw(zpl_json_cursor const *c, zpl_isize *len) {
+    if (!zpl_json_cursor_valid(c)) {
+        if (len) *len = 0;
+        return NULL;
+    }
+    char const *e = c->cfg_mode ? c->end : zpl__json_cursor_skip_value(c->value, c->end);
+    if (len) *len = e - c->value;
+    return c->value;
+}
+
+char const *zpl_json_cursor_str(zpl_json_cursor const *c, zpl_isize *len) {
+    zpl_u8 type = zpl_json_cursor_type(c);
+    if (type != ZPL_ADT_TYPE_STRING && type != ZPL_ADT_TYPE_MULTISTRING) {
+        if (len) *len = 0;
+        return NULL;
+    }
+    char const *e = zpl__json_cursor_string_end(c->value, c->end);
+    if (len) *len = e - (c->value + 1);
+    return c->value + 1;
+}
+
+zpl_string zpl_json_cursor_string(zpl_json_cursor const *c, zpl_allocator a) {
+    zpl_isize len;
+    char const *str = zpl_json_cursor_str(c, &len);
+    if (!str) return NULL;
+    return zpl_string_make_length(a, str, len);
+}
+
+zpl_i64 zpl_json_cursor_integer(zpl_json_cursor const *c, zpl_i64 fallback) {
+    zpl_adt_node leaf;
+    if (!zpl__json_cursor_leaf(c, &leaf)) return fallback;
+    if (leaf.type == ZPL_ADT_TYPE_REAL) return cast(zpl_i64)leaf.real;
+    return leaf.integer;
+}
+
+zpl_f64 zpl_json_cursor_real(zpl_json_cursor const *c, zpl_f64 fallback) {
+    zpl_adt_node leaf;
+    if (!zpl__json_cursor_leaf(c, &leaf)) return fallback;
+    if (leaf.type == ZPL_ADT_TYPE_INTEGER) return cast(zpl_f64)leaf.integer;
+    return leaf.real;
+}
+
+zpl_b32 zpl_json_cursor_bool(zpl_json_cursor const *c, zpl_b32 fallback) {
+    zpl_adt_node leaf;
+    if (!zpl__json_cursor_leaf(c, &leaf)) return fallback;
+    if (leaf.props == ZPL_ADT_PROPS_TRUE) return true;
+    if (leaf.props == ZPL_ADT_PROPS_FALSE) return false;
+    return fallback;
+}
+
+zpl_b32 zpl_json_cursor_is_null(zpl_json_cursor const *c) {
+    zpl_adt_node leaf;
+    return zpl__json_cursor_leaf(c, &leaf) && leaf.props == ZPL_ADT_PROPS_NULL;
+}
+
+ZPL_END_C_DECLS
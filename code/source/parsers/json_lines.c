@@ -0,0 +1,186 @@
+// file: source/parsers/json_lines.c
+
+////////////////////////////////////////////////////////////////
+//
+// JSON Lines (NDJSON) Reader
+//
+//
+
+ZPL_BEGIN_C_DECLS
+
+typedef struct {
+    char *begin, *end;
+    zpl_isize first; // NOTE: index of the chunk's first record
+    zpl_isize count;
+    zpl_u8 error;
+    zpl_isize error_record;
+} zpl__json_lines_chunk;
+
+typedef struct {
+    zpl_json_lines *lines;
+    zpl__json_lines_chunk *chunks;
+    zpl_atomic32 next_arena;
+    zpl_u32 id;
+} zpl__json_lines_ctx;
+
+zpl_global zpl_atomic32 zpl__json_lines_ids;
+zpl_global zpl_thread_local zpl_u32 zpl__json_lines_current_id = 0;
+zpl_global zpl_thread_local zpl_arena *zpl__json_lines_current_arena = NULL;
+
+zpl_internal zpl_b32 zpl__json_lines_blank(char const *p) {
+    while (zpl_char_is_space(*p)) ++p;
+    return *p == '\0';
+}
+
+/* terminates every line in place and counts the records */
+zpl_internal void zpl__json_lines_split(void *data, zpl_isize begin, zpl_isize end) {
+    zpl__json_lines_ctx *ctx = cast(zpl__json_lines_ctx *)data;
+
+    for (zpl_isize i = begin; i < end; ++i) {
+        zpl__json_lines_chunk *c = ctx->chunks + i;
+        char *p = c->begin;
+
+        while (p < c->end) {
+            char *e = cast(char *)zpl_memchr(p, '\n', c->end - p);
+            if (!e) e = c->end;
+            *e = '\0';
+            if (!zpl__json_lines_blank(p)) ++c->count;
+            p = e + 1;
+        }
+    }
+}
+
+/* each thread claims its own arena slot the first time it gets a chunk of this parse */
+zpl_internal zpl_arena *zpl__json_lines_arena(zpl__json_lines_ctx *ctx) {
+    if (zpl__json_lines_current_id != ctx->id) {
+        zpl__json_lines_current_arena = ctx->lines->arenas + zpl_atomic32_fetch_add(&ctx->next_arena, 1);
+        zpl__json_lines_current_id = ctx->id;
+        zpl_arena_init_from_vm(zpl__json_lines_current_arena, ZPL_JSON_LINES_ARENA_RESERVE);
+    }
+    return zpl__json_lines_current_arena;
+}
+
+zpl_internal void zpl__json_lines_parse_range(void *data, zpl_isize begin, zpl_isize end) {
+    zpl__json_lines_ctx *ctx = cast(zpl__json_lines_ctx *)data;
+    zpl_json_lines *lines = ctx->lines;
+    zpl_allocator a = zpl_arena_allocator(zpl__json_lines_arena(ctx));
+
+    for (zpl_isize i = begin; i < end; ++i) {
+        zpl__json_lines_chunk *c = ctx->chunks + i;
+        zpl_json_object *rec = lines->records + c->first;
+        char *p = c->begin;
+
+        while (p < c->end) {
+            // NOTE: grab the line end first, the parser nulls bytes inside the line
+            char *e = p + strlen(p);
+
+            if (!zpl__json_lines_blank(p)) {
+                zpl_u8 err = zpl_json_parse(rec, p, a);
+                if (err != ZPL_JSON_ERROR_NONE) {
+                    c->error = err;
+                    c->error_record = rec - lines->records;
+                    zpl_zero_array(rec + 1, (c->count - (c->error_record - c->first) - 1));
+                    break;
+                }
+                ++rec;
+            }
+            p = e + 1;
+        }
+    }
+}
+
+zpl_internal void zpl__json_lines_run(zpl__json_lines_ctx *ctx, char *text, zpl_isize len, zpl_jobs_system *pool, zpl_isize chunk_count) {
+    zpl_json_lines *lines = ctx->lines;
+
+    /* cut the text into chunks that start at line boundaries */
+    char *p = text, *end = text + len;
+    for (zpl_isize i = 0; i < chunk_count; ++i) {
+        char *e = end;
+        if (i < chunk_count - 1) {
+            e = zpl_max(text + len / chunk_count * (i + 1), p);
+            if (e > p) {
+                char *nl = cast(char *)zpl_memchr(e - 1, '\n', end - (e - 1));
+                e = nl ? nl + 1 : end;
+            }
+        }
+        ctx->chunks[i].begin = p;
+        ctx->chunks[i].end = e;
+        p = e;
+    }
+
+    if (pool) {
+        zpl_jobs_parallel_for(pool, 0, chunk_count, 1, zpl__json_lines_split, ctx);
+    }
+    else {
+        zpl__json_lines_split(ctx, 0, chunk_count);
+    }
+
+    for (zpl_isize i = 0; i < chunk_count; ++i) {
+        ctx->chunks[i].first = lines->count;
+        lines->count += ctx->chunks[i].count;
+    }
+    if (lines->count == 0) return;
+
+    lines->records = cast(zpl_json_object *)zpl_alloc(lines->backing, lines->count * zpl_size_of(zpl_json_object));
+    if (!lines->records) {
+        lines->count = 0;
+        lines->error = ZPL_JSON_ERROR_OUT_OF_MEMORY;
+        return;
+    }
+
+    if (pool) {
+        zpl_jobs_parallel_for(pool, 0, chunk_count, 1, zpl__json_lines_parse_range, ctx);
+    }
+    else {
+        zpl__json_lines_parse_range(ctx, 0, chunk_count);
+    }
+    lines->arena_count = zpl_atomic32_load(&ctx->next_arena);
+
+    for (zpl_isize i = 0; i < chunk_count; ++i) {
+        if (ctx->chunks[i].error != ZPL_JSON_ERROR_NONE) {
+            lines->error = ctx->chunks[i].error;
+            lines->error_record = ctx->chunks[i].error_record;
+            break;
+        }
+    }
+}
+
+zpl_u8 zpl_json_lines_parse(zpl_json_lines *lines, char *text, zpl_isize len, zpl_jobs_system *pool, zpl_allocator backing) {
+    ZPL_ASSERT_NOT_NULL(lines);
+    ZPL_ASSERT(text && text[len] == '\0');
+    zpl_zero_item(lines);
+    lines->backing = backing;
+    lines->error_record = -1;
+
+    zpl_isize participants = pool ? cast(zpl_isize)pool->max_threads + 1 : 1;
+    zpl_isize chunk_count = zpl_clamp(len / ZPL_JSON_LINES_MIN_CHUNK, 1, participants * ZPL_JOBS_PARALLEL_SPLIT);
+
+    zpl__json_lines_ctx ctx = {0};
+    ctx.lines = lines;
+    ctx.id = cast(zpl_u32)zpl_atomic32_fetch_add(&zpl__json_lines_ids, 1) + 1;
+    ctx.chunks = cast(zpl__json_lines_chunk *)zpl_alloc(backing, chunk_count * zpl_size_of(zpl__json_lines_chunk));
+    lines->arenas = cast(zpl_arena *)zpl_alloc(backing, participants * zpl_size_of(zpl_arena));
+
+    if (ctx.chunks && lines->arenas) {
+        zpl_zero_array(ctx.chunks, chunk_count);
+        zpl__json_lines_run(&ctx, text, len, pool, chunk_count);
+    }
+    else {
+        lines->error = ZPL_JSON_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (ctx.chunks) zpl_free(backing, ctx.chunks);
+    return lines->error;
+}
+
+void zpl_json_lines_free(zpl_json_lines *lines) {
+    ZPL_ASSERT_NOT_NULL(lines);
+    for (zpl_isize i = 0; i < lines->arena_count; ++i) {
+        zpl_arena_free(lines->arenas + i);
+    }
+    if (lines->arenas) zpl_free(lines->backing, lines->arenas);
+    if (lines->records) zpl_free(lines->backing, lines->records);
+    zpl_zero_item(lines);
+}
+
+ZPL_END_C_DECLS
@@ -0,0 +1,394 @@
+// file: source/parsers/json_stream.c
+
+////////////////////////////////////////////////////////////////
+//
+// JSON5 Streaming Parser
+//
+//
+
+ZPL_BEGIN_C_DECLS
+
+/* what the parser expects next */
+enum {
+    ZPL__JSON_STREAM_ROOT,
+    ZPL__JSON_STREAM_KEY,
+    ZPL__JSON_STREAM_ASSIGN,
+    ZPL__JSON_STREAM_VALUE,
+    ZPL__JSON_STREAM_DELIM,
+};
+
+/* token being read across chunk boundaries */
+enum {
+    ZPL__JSON_LEX_NONE,
+    ZPL__JSON_LEX_STRING,
+    ZPL__JSON_LEX_BARE,
+    ZPL__JSON_LEX_SLASH,
+    ZPL__JSON_LEX_LINE_COMMENT,
+    ZPL__JSON_LEX_BLOCK_COMMENT,
+};
+
+/* container kinds kept on the stack, cfg mode roots have no braces and close at the end of input */
+#define ZPL__JSON_STREAM_OBJECT '{'
+#define ZPL__JSON_STREAM_ARRAY  '['
+#define ZPL__JSON_STREAM_CFG    'c'
+
+zpl_internal ZPL_ALWAYS_INLINE zpl_u8 zpl__json_stream_top(zpl_json_stream *s) {
+    zpl_isize count = zpl_array_count(s->stack);
+    return count ? s->stack[count - 1] : 0;
+}
+
+zpl_internal ZPL_ALWAYS_INLINE zpl_b32 zpl__json_stream_in_object(zpl_json_stream *s) {
+    zpl_u8 top = zpl__json_stream_top(s);
+    return top == ZPL__JSON_STREAM_OBJECT || top == ZPL__JSON_STREAM_CFG;
+}
+
+zpl_internal ZPL_ALWAYS_INLINE zpl_b32 zpl__json_stream_is_name_char(char c) {
+    return zpl_char_is_alphanumeric(c) || c == '_' || c == '$';
+}
+
+zpl_internal ZPL_ALWAYS_INLINE zpl_b32 zpl__json_stream_is_value_char(char c) {
+    switch (c) {
+        case ',': case ']': case '}': case '|': case ':': case '=': case '/':
+        case '{': case '[': case '"': case '\'': case '`': case '\0': return false;
+        default: return !zpl_char_is_space(c);
+    }
+}
+
+zpl_internal zpl_u8 zpl__json_stream_fail(zpl_json_stream *s, zpl_u8 err) {
+    ZPL_JSON_ASSERT("stream error");
+    s->error = err;
+    return err;
+}
+
+zpl_internal zpl_b32 zpl__json_stream_append(zpl_json_stream *s, zpl_array(char) *buf, char const *data, zpl_isize size) {
+    if (s->max_token > 0 && zpl_array_count(*buf) + size > s->max_token) {
+        zpl__json_stream_fail(s, ZPL_JSON_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+    if (size > 0 && !zpl_array_appendv(*buf, cast(char *)data, size)) {
+        zpl__json_stream_fail(s, ZPL_JSON_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+    return true;
+}
+
+/* terminates the buffer in place so it can be handed out as a C string */
+zpl_internal char *zpl__json_stream_cstr(zpl_json_stream *s, zpl_array(char) *buf) {
+    if (!zpl_array_append(*buf, '\0')) {
+        zpl__json_stream_fail(s, ZPL_JSON_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    --zpl_array_count(*buf);
+    return *buf;
+}
+
+zpl_internal void zpl__json_stream_emit(zpl_json_stream *s, zpl_u8 type, zpl_json_event *ev) {
+    ev->type = type;
+    ev->node.name = NULL;
+    if (s->has_name && type != ZPL_JSON_EVENT_OBJECT_END && type != ZPL_JSON_EVENT_ARRAY_END) {
+        ev->node.name = zpl__json_stream_cstr(s, &s->name);
+        if (!ev->node.name) return;
+        s->has_name = false;
+    }
+    if (!s->proc(s->user_data, ev)) {
+        zpl__json_stream_fail(s, ZPL_JSON_ERROR_ABORTED);
+    }
+}
+
+zpl_internal void zpl__json_stream_value_done(zpl_json_stream *s) {
+    s->state = zpl_array_count(s->stack) ? ZPL__JSON_STREAM_DELIM : ZPL__JSON_STREAM_ROOT;
+}
+
+zpl_internal void zpl__json_stream_begin(zpl_json_stream *s, zpl_u8 kind) {
+    zpl_json_event ev = {0};
+    ev.depth = zpl_array_count(s->stack);
+    ev.node.type = (kind == ZPL__JSON_STREAM_ARRAY) ? ZPL_ADT_TYPE_ARRAY : ZPL_ADT_TYPE_OBJECT;
+
+    if (!zpl_array_append(s->stack, kind)) {
+        zpl__json_stream_fail(s, ZPL_JSON_ERROR_OUT_OF_MEMORY);
+        return;
+    }
+    zpl__json_stream_emit(s, kind == ZPL__JSON_STREAM_ARRAY ? ZPL_JSON_EVENT_ARRAY_BEGIN : ZPL_JSON_EVENT_OBJECT_BEGIN, &ev);
+    s->state = (kind == ZPL__JSON_STREAM_ARRAY) ? ZPL__JSON_STREAM_VALUE : ZPL__JSON_STREAM_KEY;
+    s->started = true;
+}
+
+zpl_internal void zpl__json_stream_end(zpl_json_stream *s, zpl_u8 kind) {
+    zpl_json_event ev = {0};
+    if (zpl__json_stream_top(s) != kind) {
+        zpl__json_stream_fail(s, ZPL_JSON_ERROR_OBJECT_END_PAIR_MISMATCHED);
+        return;
+    }
+    zpl_array_pop(s->stack);
+    ev.depth = zpl_array_count(s->stack);
+    ev.node.type = (kind == ZPL__JSON_STREAM_ARRAY) ? ZPL_ADT_TYPE_ARRAY : ZPL_ADT_TYPE_OBJECT;
+    zpl__json_stream_emit(s, kind == ZPL__JSON_STREAM_ARRAY ? ZPL_JSON_EVENT_ARRAY_END : ZPL_JSON_EVENT_OBJECT_END, &ev);
+    zpl__json_stream_value_done(s);
+}
+
+/* a string or bare token was read completely */
+zpl_internal void zpl__json_stream_token(zpl_json_stream *s) {
+    zpl_json_event ev = {0};
+    zpl_u8 lex = s->lex;
+    s->lex = ZPL__JSON_LEX_NONE;
+
+    if (s->state == ZPL__JSON_STREAM_KEY) {
+        s->has_name = true;
+        s->state = ZPL__JSON_STREAM_ASSIGN;
+        return;
+    }
+
+    ev.depth = zpl_array_count(s->stack);
+    char *token = zpl__json_stream_cstr(s, &s->token);
+    if (!token) return;
+
+    if (lex == ZPL__JSON_LEX_STRING) {
+        ev.node.type = (s->quote == '`') ? ZPL_ADT_TYPE_MULTISTRING : ZPL_ADT_TYPE_STRING;
+        ev.node.string = token;
+    } else {
+        zpl_u8 err = zpl__json_parse_token(&ev.node, token);
+        if (err != ZPL_JSON_ERROR_NONE) {
+            zpl__json_stream_fail(s, err);
+            return;
+        }
+    }
+
+    zpl__json_stream_emit(s, ZPL_JSON_EVENT_VALUE, &ev);
+    zpl_array_clear(s->token);
+    s->started = true;
+    zpl__json_stream_value_done(s);
+}
+
+zpl_internal void zpl__json_stream_start_token(zpl_json_stream *s, zpl_u8 lex, char quote) {
+    s->lex = lex;
+    s->quote = quote;
+    s->escaped = false;
+    if (s->state == ZPL__JSON_STREAM_KEY) zpl_array_clear(s->name);
+    else zpl_array_clear(s->token);
+}
+
+/* handles one significant character outside of tokens, returns the number of bytes consumed */
+zpl_internal zpl_isize zpl__json_stream_structural(zpl_json_stream *s, char c) {
+    switch (s->state) {
+        case ZPL__JSON_STREAM_ROOT: {
+            if (c == '{') { zpl__json_stream_begin(s, ZPL__JSON_STREAM_OBJECT); return 1; }
+            if (c == '[') { zpl__json_stream_begin(s, ZPL__JSON_STREAM_ARRAY); return 1; }
+            if (!s->started) {
+                /* same as zpl_json_parse, documents that do not start with a bracket are cfg mode objects */
+                zpl__json_stream_begin(s, ZPL__JSON_STREAM_CFG);
+                return 0;
+            }
+            s->state = ZPL__JSON_STREAM_VALUE;
+            return 0;
+        }
+
+        case ZPL__JSON_STREAM_KEY: {
+            if (c == '}') { zpl__json_stream_end(s, ZPL__JSON_STREAM_OBJECT); return 1; }
+            if (c == ']') { zpl__json_stream_fail(s, ZPL_JSON_ERROR_OBJECT_END_PAIR_MISMATCHED); return 0; }
+            if (c == '"' || c == '\'') { zpl__json_stream_start_token(s, ZPL__JSON_LEX_STRING, c); return 1; }
+            if (zpl_char_is_alpha(c) || c == '_' || c == '$') { zpl__json_stream_start_token(s, ZPL__JSON_LEX_BARE, 0); return 0; }
+            zpl__json_stream_fail(s, ZPL_JSON_ERROR_INVALID_NAME);
+            return 0;
+        }
+
+        case ZPL__JSON_STREAM_ASSIGN: {
+            if (c == ':' || c == '=' || c == '|') { s->state = ZPL__JSON_STREAM_VALUE; return 1; }
+            zpl__json_stream_fail(s, ZPL_JSON_ERROR_INVALID_ASSIGNMENT);
+            return 0;
+        }
+
+        case ZPL__JSON_STREAM_VALUE: {
+            if (c == '{') { zpl__json_stream_begin(s, ZPL__JSON_STREAM_OBJECT); return 1; }
+            if (c == '[') { zpl__json_stream_begin(s, ZPL__JSON_STREAM_ARRAY); return 1; }
+            if (c == ']' && zpl__json_stream_top(s) == ZPL__JSON_STREAM_ARRAY) { zpl__json_stream_end(s, ZPL__JSON_STREAM_ARRAY); return 1; }
+            if (c == '"' || c == '\'' || c == '`') { zpl__json_stream_start_token(s, ZPL__JSON_LEX_STRING, c); return 1; }
+            if (zpl__json_stream_is_value_char(c)) { zpl__json_stream_start_token(s, ZPL__JSON_LEX_BARE, 0); return 0; }
+            zpl__json_stream_fail(s, ZPL_JSON_ERROR_INVALID_VALUE);
+            return 0;
+        }
+
+        case ZPL__JSON_STREAM_DELIM: {
+            zpl_b32 in_object = zpl__json_stream_in_object(s);
+            if (c == ',' || c == '|') { s->state = in_object ? ZPL__JSON_STREAM_KEY : ZPL__JSON_STREAM_VALUE; return 1; }
+            if (c == '}') { zpl__json_stream_end(s, ZPL__JSON_STREAM_OBJECT); return 1; }
+            if (c == ']') { zpl__json_stream_end(s, ZPL__JSON_STREAM_ARRAY); return 1; }
+            if (in_object) {
+                /* newline delimited members */
+                s->state = ZPL__JSON_STREAM_KEY;
+                return 0;
+            }
+            zpl__json_stream_fail(s, ZPL_JSON_ERROR_ARRAY_LEFT_OPEN);
+            return 0;
+        }
+    }
+
+    zpl__json_stream_fail(s, ZPL_JSON_ERROR_INTERNAL);
+    return 0;
+}
+
+zpl_u8 zpl_json_stream_init(zpl_json_stream *s, zpl_allocator backing, zpl_json_stream_proc proc, void *user_data) {
+    ZPL_ASSERT_NOT_NULL(s);
+    ZPL_ASSERT_NOT_NULL(proc);
+    zpl_zero_item(s);
+    s->backing = backing;
+    s->proc = proc;
+    s->user_data = user_data;
+    s->line = 1;
+
+    if (!zpl_array_init(s->stack, backing) || !zpl_array_init(s->name, backing) || !zpl_array_init(s->token, backing)) {
+        zpl_json_stream_free(s);
+        return ZPL_JSON_ERROR_OUT_OF_MEMORY;
+    }
+    return ZPL_JSON_ERROR_NONE;
+}
+
+void zpl_json_stream_free(zpl_json_stream *s) {
+    ZPL_ASSERT_NOT_NULL(s);
+    if (s->stack) zpl_array_free(s->stack);
+    if (s->name) zpl_array_free(s->name);
+    if (s->token) zpl_array_free(s->token);
+    s->stack = NULL, s->name = NULL, s->token = NULL;
+}
+
+zpl_u8 zpl_json_stream_feed(zpl_json_stream *s, void const *data, zpl_isize size) {
+    ZPL_ASSERT_NOT_NULL(s);
+    char const *p = cast(char const *)data, *end = p + size;
+
+    while (p < end && !s->error) {
+        char const *run = p;
+
+        switch (s->lex) {
+            case ZPL__JSON_LEX_STRING: {
+                while (p < end) {
+                    if (s->escaped) s->escaped = false;
+                    else if (*p == '\\') s->escaped = true;
+                    else if (*p == s->quote) break;
+                    if (*p == '\n') ++s->line;
+                    ++p;
+                }
+                zpl__json_stream_append(s, s->state == ZPL__JSON_STREAM_KEY ? &s->name : &s->token, run, p - run);
+                if (p < end && !s->error) {
+                    ++p;
+                    zpl__json_stream_token(s);
+                }
+            } break;
+
+            case ZPL__JSON_LEX_BARE: {
+                zpl_b32 is_name = s->state == ZPL__JSON_STREAM_KEY;
+                while (p < end && (is_name ? zpl__json_stream_is_name_char(*p) : zpl__json_stream_is_value_char(*p))) ++p;
+                zpl__json_stream_append(s, is_name ? &s->name : &s->token, run, p - run);
+                if (p < end && !s->error) zpl__json_stream_token(s);
+            } break;
+
+            case ZPL__JSON_LEX_SLASH: {
+                if (*p == '/') s->lex = ZPL__JSON_LEX_LINE_COMMENT;
+                else if (*p == '*') s->lex = ZPL__JSON_LEX_BLOCK_COMMENT, s->escaped = false;
+                else {
+                    zpl__json_stream_fail(s, ZPL_JSON_ERROR_INVALID_VALUE);
+                    break;
+                }
+                ++p;
+            } break;
+
+            case ZPL__JSON_LEX_LINE_COMMENT: {
+                char const *e = cast(char const *)zpl_memchr(p, '\n', end - p);
+                if (e) s->lex = ZPL__JSON_LEX_NONE;
+                p = e ? e : end;
+            } break;
+
+            case ZPL__JSON_LEX_BLOCK_COMMENT: {
+                /* escaped remembers a trailing '*' across chunks */
+                for (; p < end; ++p) {
+                    if (s->escaped && *p == '/') {
+                        s->lex = ZPL__JSON_LEX_NONE;
+                        ++p;
+                        break;
+                    }
+                    s->escaped = (*p == '*');
+                    if (*p == '\n') ++s->line;
+                }
+            } break;
+
+            default: {
+                char c = *p;
+                if (zpl_char_is_space(c)) {
+                    if (c == '\n') ++s->line;
+                    ++p;
+                } else if (c == '/') {
+                    s->lex = ZPL__JSON_LEX_SLASH;
+                    ++p;
+                } else {
+                    p += zpl__json_stream_structural(s, c);
+                }
+            } break;
+        }
+
+        s->offset += p - run;
+    }
+
+    return s->error;
+}
+
+zpl_u8 zpl_json_stream_finish(zpl_json_stream *s) {
+    ZPL_ASSERT_NOT_NULL(s);
+    if (s->error) return s->error;
+
+    switch (s->lex) {
+        case ZPL__JSON_LEX_BARE: {
+            zpl__json_stream_token(s);
+        } break;
+
+        case ZPL__JSON_LEX_STRING:
+        case ZPL__JSON_LEX_BLOCK_COMMENT: {
+            return zpl__json_stream_fail(s, ZPL_JSON_ERROR_UNEXPECTED_END_OF_INPUT);
+        }
+
+        case ZPL__JSON_LEX_SLASH: {
+            return zpl__json_stream_fail(s, ZPL_JSON_ERROR_INVALID_VALUE);
+        }
+    }
+    s->lex = ZPL__JSON_LEX_NONE;
+    if (s->error) return s->error;
+
+    if (zpl__json_stream_top(s) == ZPL__JSON_STREAM_CFG && zpl_array_count(s->stack) == 1) {
+        if (s->state != ZPL__JSON_STREAM_KEY && s->state != ZPL__JSON_STREAM_DELIM) {
+            return zpl__json_stream_fail(s, ZPL_JSON_ERROR_UNEXPECTED_END_OF_INPUT);
+        }
+        zpl__json_stream_end(s, ZPL__JSON_STREAM_CFG);
+    }
+    else if (zpl_array_count(s->stack) > 0 || s->state == ZPL__JSON_STREAM_VALUE) {
+        return zpl__json_stream_fail(s, ZPL_JSON_ERROR_UNEXPECTED_END_OF_INPUT);
+    }
+
+    return s->error;
+}
+
+zpl_u8 zpl_json_stream_file(zpl_json_stream *s, zpl_file *f) {
+    ZPL_ASSERT_NOT_NULL(s);
+    ZPL_ASSERT_NOT_NULL(f);
+
+    char *chunk = cast(char *)zpl_alloc_uninit(s->backing, ZPL_JSON_STREAM_CHUNK_SIZE);
+    if (!chunk) return zpl__json_stream_fail(s, ZPL_JSON_ERROR_OUT_OF_MEMORY);
+
+    zpl_i64 offset = zpl_file_tell(f);
+    for (;;) {
+        zpl_isize bytes_read = 0;
+        if (!zpl_file_read_at_check(f, chunk, ZPL_JSON_STREAM_CHUNK_SIZE, offset, &bytes_read)) {
+            zpl__json_stream_fail(s, ZPL_JSON_ERROR_INTERNAL);
+            break;
+        }
+        if (bytes_read <= 0) break;
+        offset += bytes_read;
+        if (zpl_json_stream_feed(s, chunk, bytes_read)) break;
+    }
+    zpl_file_seek(f, offset);
+    zpl_free(s->backing, chunk);
+
+    return zpl_json_stream_finish(s);
+}
+
+#undef ZPL__JSON_STREAM_OBJECT
+#undef ZPL__JSON_STREAM_ARRAY
+#undef ZPL__JSON_STREAM_CFG
+
+ZPL_END_C_DECLS
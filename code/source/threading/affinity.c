@@ -3,6 +3,8 @@
 
 #if defined(ZPL_SYSTEM_MACOS)
 #    include <sys/sysctl.h>
+#elif defined(ZPL_SYSTEM_LINUX)
+#    include <fcntl.h>
 #endif
 
 ZPL_BEGIN_C_DECLS
@@ -137,7 +139,181 @@ ZPL_BEGIN_C_DECLS
         return a->threads_per_core;
     }
 
-#elif defined(ZPL_SYSTEM_LINUX) || defined(ZPL_SYSTEM_FREEBSD) || defined(ZPL_SYSTEM_OPENBSD)
+#elif defined(ZPL_SYSTEM_LINUX)
+#    define ZPL__AFFINITY_MASK_WORDS ((ZPL_AFFINITY_MAX_THREADS + 63) / 64)
+
+    zpl_internal zpl_isize zpl__affinity_read(char const *path, char *buf, zpl_isize size) {
+        zpl_isize len;
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return -1;
+        len = read(fd, buf, size - 1);
+        close(fd);
+        if (len < 0) return -1;
+        buf[len] = 0;
+        return len;
+    }
+
+    zpl_internal char const *zpl__affinity_parse_int(char const *p, zpl_i32 *value) {
+        *value = -1;
+        if (*p < '0' || *p > '9') return p;
+        *value = 0;
+        while (*p >= '0' && *p <= '9') *value = *value * 10 + (*p++ - '0');
+        return p;
+    }
+
+    zpl_internal zpl_i32 zpl__affinity_read_int(char const *path) {
+        char buf[32];
+        zpl_i32 value = -1;
+        if (zpl__affinity_read(path, buf, zpl_size_of(buf)) > 0) zpl__affinity_parse_int(buf, &value);
+        return value;
+    }
+
+    // NOTE: Parses the kernel's cpulist format, e.g. "0-3,8,10-11"
+    zpl_internal zpl_b32 zpl__affinity_read_list(char const *path, zpl_u64 *mask) {
+        char buf[1024];
+        char const *p = buf;
+        zpl_zero_size(mask, ZPL__AFFINITY_MASK_WORDS * zpl_size_of(zpl_u64));
+        if (zpl__affinity_read(path, buf, zpl_size_of(buf)) <= 0) return false;
+
+        for (;;) {
+            zpl_i32 lo, hi;
+            p = zpl__affinity_parse_int(p, &lo);
+            if (lo < 0) break;
+            hi = lo;
+            if (*p == '-') p = zpl__affinity_parse_int(p + 1, &hi);
+            for (; lo <= hi && lo < ZPL_AFFINITY_MAX_THREADS; ++lo) {
+                mask[lo / 64] |= 1ull << (lo % 64);
+            }
+            if (*p++ != ',') break;
+        }
+        return true;
+    }
+
+    zpl_internal zpl_b32 zpl__affinity_has(zpl_u64 const *mask, zpl_isize cpu) {
+        return (mask[cpu / 64] >> (cpu % 64)) & 1;
+    }
+
+    zpl_internal zpl_i32 zpl__affinity_lowest(zpl_u64 const *mask) {
+        for (zpl_i32 i = 0; i < ZPL_AFFINITY_MAX_THREADS; ++i) {
+            if (zpl__affinity_has(mask, i)) return i;
+        }
+        return -1;
+    }
+
+    zpl_internal void zpl__affinity_caches(zpl_affinity_core *core, zpl_i32 cpu) {
+        char path[128], type[32];
+        zpl_u64 shared[ZPL__AFFINITY_MASK_WORDS];
+
+        for (zpl_i32 index = 0; ; ++index) {
+            zpl_i32 level;
+            snprintf(path, zpl_size_of(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", cpu, index);
+            level = zpl__affinity_read_int(path);
+            if (level < 0) break;
+            if (level != 2 && level != 3) continue;
+
+            snprintf(path, zpl_size_of(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/type", cpu, index);
+            if (zpl__affinity_read(path, type, zpl_size_of(type)) > 0 && type[0] == 'I') continue;
+
+            snprintf(path, zpl_size_of(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", cpu, index);
+            if (!zpl__affinity_read_list(path, shared)) continue;
+
+            if (level == 2) core->l2 = zpl__affinity_lowest(shared);
+            else            core->l3 = zpl__affinity_lowest(shared);
+        }
+    }
+
+    void zpl_affinity_init(zpl_affinity *a) {
+        char path[128];
+        zpl_u64 online[ZPL__AFFINITY_MASK_WORDS], siblings[ZPL__AFFINITY_MASK_WORDS], nodes[ZPL__AFFINITY_MASK_WORDS];
+        zpl_u64 assigned[ZPL__AFFINITY_MASK_WORDS] = {0};
+
+        zpl_zero_item(a);
+        a->is_accurate = true;
+
+        if (!zpl__affinity_read_list("/sys/devices/system/cpu/online", online)) {
+            zpl_isize count = sysconf(_SC_NPROCESSORS_ONLN);
+            a->is_accurate = false;
+            for (zpl_isize cpu = 0; cpu < count && cpu < ZPL_AFFINITY_MAX_THREADS; ++cpu) {
+                online[cpu / 64] |= 1ull << (cpu % 64);
+            }
+        }
+
+        // NOTE: Group logical CPUs into physical cores by their SMT siblings
+        for (zpl_i32 cpu = 0; cpu < ZPL_AFFINITY_MAX_THREADS; ++cpu) {
+            zpl_affinity_core *core;
+            if (!zpl__affinity_has(online, cpu) || zpl__affinity_has(assigned, cpu)) continue;
+
+            snprintf(path, zpl_size_of(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+            if (!zpl__affinity_read_list(path, siblings)) {
+                a->is_accurate = false;
+            }
+            siblings[cpu / 64] |= 1ull << (cpu % 64);
+
+            core = &a->cores[a->core_count++];
+            core->first = cast(zpl_i32)a->thread_count;
+            core->l2 = core->l3 = -1;
+
+            for (zpl_i32 sibling = cpu; sibling < ZPL_AFFINITY_MAX_THREADS; ++sibling) {
+                if (!zpl__affinity_has(siblings, sibling) || !zpl__affinity_has(online, sibling) || zpl__affinity_has(assigned, sibling)) continue;
+                assigned[sibling / 64] |= 1ull << (sibling % 64);
+                a->cpus[a->thread_count++] = sibling;
+                core->threads++;
+            }
+
+            if (core->threads > a->threads_per_core) a->threads_per_core = core->threads;
+            zpl__affinity_caches(core, cpu);
+        }
+
+        a->node_count = 1;
+        if (zpl__affinity_read_list("/sys/devices/system/node/online", nodes)) {
+            for (zpl_i32 node = 0; node < ZPL_AFFINITY_MAX_THREADS; ++node) {
+                if (!zpl__affinity_has(nodes, node)) continue;
+                a->node_count = node + 1;
+
+                snprintf(path, zpl_size_of(path), "/sys/devices/system/node/node%d/cpulist", node);
+                if (!zpl__affinity_read_list(path, siblings)) continue;
+
+                for (zpl_isize i = 0; i < a->core_count; ++i) {
+                    if (zpl__affinity_has(siblings, a->cpus[a->cores[i].first])) a->cores[i].node = node;
+                }
+            }
+        }
+
+        // NOTE: logical CPUs past ZPL_AFFINITY_MAX_THREADS were left out
+        if (sysconf(_SC_NPROCESSORS_ONLN) > a->thread_count) {
+            a->is_accurate = false;
+        }
+
+        if (a->core_count == 0) {
+            a->is_accurate      = false;
+            a->core_count       = 1;
+            a->thread_count     = 1;
+            a->threads_per_core = 1;
+            a->cores[0].threads = 1;
+            a->cores[0].l2 = a->cores[0].l3 = -1;
+        }
+    }
+
+    void zpl_affinity_destroy(zpl_affinity *a) {
+        zpl_unused(a);
+    }
+
+    zpl_b32 zpl_affinity_set(zpl_affinity *a, zpl_isize core, zpl_isize thread_index) {
+        cpu_set_t set;
+        ZPL_ASSERT(0 <= core && core < a->core_count);
+        ZPL_ASSERT(thread_index < a->cores[core].threads);
+
+        CPU_ZERO(&set);
+        CPU_SET(a->cpus[a->cores[core].first + thread_index], &set);
+        return pthread_setaffinity_np(pthread_self(), zpl_size_of(set), &set) == 0;
+    }
+
+    zpl_isize zpl_affinity_thread_count_for_core(zpl_affinity *a, zpl_isize core) {
+        ZPL_ASSERT(0 <= core && core < a->core_count);
+        return a->cores[core].threads;
+    }
+
+#elif defined(ZPL_SYSTEM_FREEBSD) || defined(ZPL_SYSTEM_OPENBSD)
     void zpl_affinity_init(zpl_affinity *a) {
         a->core_count       = sysconf(_SC_NPROCESSORS_ONLN);
         a->threads_per_core = 1;
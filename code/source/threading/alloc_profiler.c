@@ -0,0 +1,347 @@
+// file: source/threading/alloc_profiler.c
+
+////////////////////////////////////////////////////////////////
+//
+// Allocation Profiler
+//
+//
+
+ZPL_BEGIN_C_DECLS
+
+ZPL_FLAT_TABLE_DEFINE(zpl__alloc_site_map, zpl__alloc_site_map_, zpl_isize);
+
+typedef struct zpl__alloc_record {
+    zpl_isize size;
+    zpl_isize site;
+    zpl_isize track; // NOTE: distance between the backing block and the user pointer
+    zpl_u64 time;
+} zpl__alloc_record;
+
+typedef struct zpl__alloc_frame {
+    char const *name;
+    zpl_i32 line;
+} zpl__alloc_frame;
+
+zpl_global zpl_atomic32 zpl__alloc_profiler_ids;
+
+zpl_global zpl_thread_local zpl__alloc_frame zpl__alloc_scope[ZPL_ALLOC_PROFILER_MAX_DEPTH];
+zpl_global zpl_thread_local zpl_i32 zpl__alloc_scope_depth = 0;
+zpl_global zpl_thread_local zpl_u32 zpl__alloc_scope_version = 0;
+
+// NOTE: Resolving the scope stack into a site takes a lookup per frame, cache the result until the stack changes
+zpl_global zpl_thread_local zpl_alloc_profiler *zpl__alloc_cached_profiler = NULL;
+zpl_global zpl_thread_local zpl_u32 zpl__alloc_cached_id = 0;
+zpl_global zpl_thread_local zpl_u32 zpl__alloc_cached_version = 0;
+zpl_global zpl_thread_local zpl_isize zpl__alloc_cached_site = 0;
+
+zpl_internal zpl_u64 zpl__alloc_site_key(zpl_isize parent, char const *name, zpl_i32 line) {
+    zpl_u64 key = cast(zpl_u64)cast(zpl_uintptr)name * 0x9E3779B97F4A7C15ull;
+    key ^= (cast(zpl_u64)parent << 32) + cast(zpl_u32)line + (key >> 29);
+    return key * 0xBF58476D1CE4E5B9ull;
+}
+
+zpl_internal zpl_b32 zpl__alloc_site_is(zpl_alloc_site *site, zpl_isize parent, char const *name, zpl_i32 line) {
+    return site->parent == parent && site->name == name && site->line == line;
+}
+
+zpl_internal zpl_isize zpl__alloc_site_child(zpl_alloc_profiler *p, zpl_isize parent, char const *name, zpl_i32 line) {
+    zpl_u64 key = zpl__alloc_site_key(parent, name, line);
+    zpl_isize *found = zpl__alloc_site_map_get(&p->site_map, key);
+    zpl_alloc_site site = { 0 };
+
+    if (found && zpl__alloc_site_is(&p->sites[*found], parent, name, line)) return *found;
+
+    // NOTE: Key collisions are practically impossible, fall back to a scan rather than mixing two sites up
+    if (found) {
+        for (zpl_isize i = 0; i < zpl_array_count(p->sites); ++i) {
+            if (zpl__alloc_site_is(&p->sites[i], parent, name, line)) return i;
+        }
+    }
+
+    site.name = name;
+    site.line = line;
+    site.parent = parent;
+    zpl_array_append(p->sites, site);
+    if (!found) zpl__alloc_site_map_set(&p->site_map, key, zpl_array_count(p->sites) - 1);
+    return zpl_array_count(p->sites) - 1;
+}
+
+// NOTE: Expects the profiler to be locked
+zpl_internal zpl_isize zpl__alloc_site_current(zpl_alloc_profiler *p) {
+    zpl_isize site = 0;
+    zpl_i32 depth = zpl_min(zpl__alloc_scope_depth, ZPL_ALLOC_PROFILER_MAX_DEPTH);
+
+    if (zpl__alloc_cached_profiler == p && zpl__alloc_cached_id == p->id &&
+        zpl__alloc_cached_version == zpl__alloc_scope_version) {
+        return zpl__alloc_cached_site;
+    }
+
+    for (zpl_i32 i = 0; i < depth; ++i) {
+        site = zpl__alloc_site_child(p, site, zpl__alloc_scope[i].name, zpl__alloc_scope[i].line);
+    }
+
+    zpl__alloc_cached_profiler = p;
+    zpl__alloc_cached_id = p->id;
+    zpl__alloc_cached_version = zpl__alloc_scope_version;
+    zpl__alloc_cached_site = site;
+    return site;
+}
+
+zpl_internal zpl_isize zpl__alloc_bucket(zpl_isize size) {
+    zpl_isize bucket = 0;
+    while (bucket < ZPL_ALLOC_PROFILER_BUCKETS - 1 && size > (cast(zpl_isize)16 << bucket)) bucket++;
+    return bucket;
+}
+
+zpl_internal void zpl__alloc_site_live(zpl_alloc_profiler *p, zpl_alloc_site *site, zpl_isize delta) {
+    site->live_bytes += delta;
+    p->live_bytes += delta;
+    if (site->live_bytes > site->peak_bytes) site->peak_bytes = site->live_bytes;
+    if (p->live_bytes > p->peak_bytes) p->peak_bytes = p->live_bytes;
+}
+
+void zpl_alloc_profiler_init(zpl_alloc_profiler *p, zpl_allocator backing) {
+    zpl_alloc_site root = { 0 };
+    zpl_zero_item(p);
+    p->backing = backing;
+    p->id = cast(zpl_u32)zpl_atomic32_fetch_add(&zpl__alloc_profiler_ids, 1) + 1;
+    zpl_mutex_init(&p->lock);
+    zpl_array_init(p->sites, zpl_heap_allocator());
+    zpl__alloc_site_map_init(&p->site_map, zpl_heap_allocator());
+
+    root.name = "[root]";
+    root.parent = -1;
+    zpl_array_append(p->sites, root);
+}
+
+void zpl_alloc_profiler_free(zpl_alloc_profiler *p) {
+    zpl_array_free(p->sites);
+    zpl__alloc_site_map_destroy(&p->site_map);
+    zpl_mutex_destroy(&p->lock);
+    if (zpl__alloc_cached_profiler == p) zpl__alloc_cached_profiler = NULL;
+}
+
+void zpl_alloc_profiler_push(char const *name) {
+    zpl_alloc_profiler_push_at(name, 0);
+}
+
+void zpl_alloc_profiler_push_at(char const *file, zpl_i32 line) {
+    // NOTE: Frames past the maximum depth are folded into the deepest recorded one
+    if (zpl__alloc_scope_depth < ZPL_ALLOC_PROFILER_MAX_DEPTH) {
+        zpl__alloc_scope[zpl__alloc_scope_depth].name = file;
+        zpl__alloc_scope[zpl__alloc_scope_depth].line = line;
+    }
+    zpl__alloc_scope_depth++;
+    zpl__alloc_scope_version++;
+}
+
+void zpl_alloc_profiler_pop(void) {
+    ZPL_ASSERT_MSG(zpl__alloc_scope_depth > 0, "zpl_alloc_profiler_pop called without a matching push");
+    zpl__alloc_scope_depth--;
+    zpl__alloc_scope_version++;
+}
+
+zpl_internal char const *zpl__alloc_site_label(zpl_alloc_site *site, char *buf, zpl_isize len) {
+    char const *base = site->name;
+    if (!site->line) return site->name;
+    for (char const *c = site->name; *c; ++c) {
+        if (*c == '/' || *c == '\\') base = c + 1;
+    }
+    zpl_snprintf(buf, len, "%s:%d", base, site->line);
+    return buf;
+}
+
+zpl_internal void zpl__alloc_site_write_path(zpl_alloc_profiler *p, zpl_file *f, zpl_isize index) {
+    char buf[256];
+    zpl_alloc_site *site = &p->sites[index];
+    if (site->parent > 0) {
+        zpl__alloc_site_write_path(p, f, site->parent);
+        zpl_fprintf(f, ";");
+    }
+    zpl_fprintf(f, "%s", zpl__alloc_site_label(site, buf, zpl_size_of(buf)));
+}
+
+typedef struct zpl__alloc_site_order {
+    zpl_isize total_bytes;
+    zpl_isize index;
+} zpl__alloc_site_order;
+
+zpl_internal ZPL_COMPARE_PROC(zpl__alloc_site_order_cmp) {
+    zpl_isize x = (cast(zpl__alloc_site_order const *)a)->total_bytes;
+    zpl_isize y = (cast(zpl__alloc_site_order const *)b)->total_bytes;
+    return x > y ? -1 : x < y ? +1 : 0;
+}
+
+void zpl_alloc_profiler_report(zpl_alloc_profiler *p, zpl_file *f) {
+    zpl__alloc_site_order *order;
+    zpl_isize count;
+
+    zpl_mutex_lock(&p->lock);
+    count = zpl_array_count(p->sites);
+    order = cast(zpl__alloc_site_order *)zpl_alloc_array_uninit(zpl_heap_allocator(), zpl__alloc_site_order, count);
+    for (zpl_isize i = 0; i < count; ++i) {
+        order[i].total_bytes = p->sites[i].total_bytes;
+        order[i].index = i;
+    }
+    zpl_sort_array(order, count, zpl__alloc_site_order_cmp);
+
+    zpl_fprintf(f, "allocs: %td, frees: %td, requested: %td bytes, live: %td bytes, peak: %td bytes\n\n",
+                p->alloc_count, p->free_count, p->total_bytes, p->live_bytes, p->peak_bytes);
+    zpl_fprintf(f, "%10s %10s %10s %14s %12s %12s %14s %14s  %s\n", "allocs", "frees", "resizes", "requested", "live",
+                "peak", "avg life tsc", "max life tsc", "site");
+
+    for (zpl_isize i = 0; i < count; ++i) {
+        zpl_alloc_site *site = &p->sites[order[i].index];
+        zpl_u64 avg = site->free_count ? site->total_lifetime / site->free_count : 0;
+        if (!site->alloc_count) continue;
+
+        zpl_fprintf(f, "%10td %10td %10td %14td %12td %12td %14llu %14llu  ", site->alloc_count, site->free_count,
+                    site->resize_count, site->total_bytes, site->live_bytes, site->peak_bytes, avg,
+                    site->max_lifetime);
+        zpl__alloc_site_write_path(p, f, order[i].index);
+        zpl_fprintf(f, "\n%10s sizes:", "");
+        for (zpl_isize b = 0; b < ZPL_ALLOC_PROFILER_BUCKETS; ++b) {
+            if (!site->histogram[b]) continue;
+            if (b == ZPL_ALLOC_PROFILER_BUCKETS - 1) {
+                zpl_fprintf(f, " >%td: %td", cast(zpl_isize)16 << (b - 1), site->histogram[b]);
+            } else {
+                zpl_fprintf(f, " <=%td: %td", cast(zpl_isize)16 << b, site->histogram[b]);
+            }
+        }
+        zpl_fprintf(f, "\n");
+    }
+    zpl_mutex_unlock(&p->lock);
+
+    zpl_free(zpl_heap_allocator(), order);
+}
+
+void zpl_alloc_profiler_write_folded(zpl_alloc_profiler *p, zpl_file *f, zpl_alloc_profiler_metric metric) {
+    zpl_mutex_lock(&p->lock);
+    for (zpl_isize i = 0; i < zpl_array_count(p->sites); ++i) {
+        zpl_alloc_site *site = &p->sites[i];
+        zpl_isize value = 0;
+        switch (metric) {
+            case ZPL_ALLOC_PROFILER_BYTES: value = site->total_bytes; break;
+            case ZPL_ALLOC_PROFILER_COUNT: value = site->alloc_count; break;
+            case ZPL_ALLOC_PROFILER_LIVE: value = site->live_bytes; break;
+        }
+        if (!value) continue;
+        zpl__alloc_site_write_path(p, f, i);
+        zpl_fprintf(f, " %td\n", value);
+    }
+    zpl_mutex_unlock(&p->lock);
+}
+
+zpl_internal void *zpl__alloc_profiler_alloc(zpl_alloc_profiler *p, zpl_isize size, zpl_isize alignment, zpl_u64 flags) {
+    zpl_isize track = zpl_align_forward_i64(zpl_size_of(zpl__alloc_record), alignment);
+    zpl__alloc_record *record;
+    zpl_alloc_site *site;
+    void *block = p->backing.proc(p->backing.data, ZPL_ALLOCATION_ALLOC, track + size, alignment, NULL, 0, flags);
+    if (!block) return NULL;
+
+    record = cast(zpl__alloc_record *)zpl_pointer_add(block, track) - 1;
+    record->size = size;
+    record->track = track;
+    record->time = zpl_rdtsc();
+
+    zpl_mutex_lock(&p->lock);
+    record->site = zpl__alloc_site_current(p);
+    site = &p->sites[record->site];
+    site->alloc_count++;
+    site->total_bytes += size;
+    site->histogram[zpl__alloc_bucket(size)]++;
+    p->alloc_count++;
+    p->total_bytes += size;
+    zpl__alloc_site_live(p, site, size);
+    zpl_mutex_unlock(&p->lock);
+
+    return record + 1;
+}
+
+ZPL_ALLOCATOR_PROC(zpl_alloc_profiler_allocator_proc) {
+    zpl_alloc_profiler *p = cast(zpl_alloc_profiler *)allocator_data;
+    zpl__alloc_record *record = old_memory ? cast(zpl__alloc_record *)old_memory - 1 : NULL;
+    void *ptr = NULL;
+
+    if (!alignment) alignment = ZPL_DEFAULT_MEMORY_ALIGNMENT;
+
+    switch (type) {
+        case ZPL_ALLOCATION_ALLOC: {
+            ptr = zpl__alloc_profiler_alloc(p, size, alignment, flags);
+        } break;
+
+        case ZPL_ALLOCATION_FREE: {
+            zpl_alloc_site *site;
+            zpl_u64 lifetime;
+            void *block;
+            if (!record) break;
+
+            lifetime = zpl_rdtsc() - record->time;
+            block = zpl_pointer_sub(record + 1, record->track);
+
+            zpl_mutex_lock(&p->lock);
+            site = &p->sites[record->site];
+            site->free_count++;
+            site->total_lifetime += lifetime;
+            if (lifetime > site->max_lifetime) site->max_lifetime = lifetime;
+            p->free_count++;
+            zpl__alloc_site_live(p, site, -record->size);
+            zpl_mutex_unlock(&p->lock);
+
+            p->backing.proc(p->backing.data, ZPL_ALLOCATION_FREE, 0, 0, block, 0, flags);
+        } break;
+
+        case ZPL_ALLOCATION_FREE_ALL: {
+            // NOTE: Live statistics stay as they are, heap or slab backings ignore this and keep every block
+            p->backing.proc(p->backing.data, ZPL_ALLOCATION_FREE_ALL, 0, 0, NULL, 0, flags);
+        } break;
+
+        case ZPL_ALLOCATION_RESIZE: {
+            zpl_isize track = zpl_align_forward_i64(zpl_size_of(zpl__alloc_record), alignment);
+            zpl_isize old_block_size;
+            void *block;
+
+            // NOTE: Blocks keep their original site, the header moves along with the backing allocation
+            if (!record || !size) {
+                ptr = zpl_default_resize_align_with_flags(zpl_alloc_profiler_allocator(p), old_memory, old_size, size, alignment, flags);
+                break;
+            }
+
+            old_size = record->size;
+            old_block_size = record->track + old_size;
+            if (record->track == track) {
+                block = p->backing.proc(p->backing.data, ZPL_ALLOCATION_RESIZE, track + size, alignment,
+                                        zpl_pointer_sub(old_memory, track), old_block_size, flags);
+                if (!block) break;
+                record = cast(zpl__alloc_record *)zpl_pointer_add(block, track) - 1;
+            } else {
+                // NOTE: A different alignment moves the header, copy the record by hand so the site stays
+                zpl__alloc_record *moved;
+                block = p->backing.proc(p->backing.data, ZPL_ALLOCATION_ALLOC, track + size, alignment, NULL, 0, flags);
+                if (!block) break;
+                moved = cast(zpl__alloc_record *)zpl_pointer_add(block, track) - 1;
+                zpl_memcopy(moved + 1, old_memory, zpl_min(old_size, size));
+                *moved = *record;
+                moved->track = track;
+                p->backing.proc(p->backing.data, ZPL_ALLOCATION_FREE, 0, 0, zpl_pointer_sub(old_memory, record->track), 0, flags);
+                record = moved;
+            }
+            record->size = size;
+
+            zpl_mutex_lock(&p->lock);
+            p->sites[record->site].resize_count++;
+            if (size > old_size) {
+                p->sites[record->site].total_bytes += size - old_size;
+                p->total_bytes += size - old_size;
+            }
+            zpl__alloc_site_live(p, &p->sites[record->site], size - old_size);
+            zpl_mutex_unlock(&p->lock);
+
+            ptr = record + 1;
+        } break;
+    }
+
+    return ptr;
+}
+
+ZPL_END_C_DECLS
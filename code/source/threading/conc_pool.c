@@ -0,0 +1,162 @@
+// file: source/threading/conc_pool.c
+
+////////////////////////////////////////////////////////////////
+//
+// Concurrent Pool Allocator
+//
+//
+
+ZPL_BEGIN_C_DECLS
+
+// NOTE: The free list head packs the block pointer into the low bits and a tag bumped on every change into the
+// high bits. User space addresses fit into 48 bits on common 64-bit targets, 32-bit targets keep a full 32-bit tag.
+// Blocks only enter the list through zpl__conc_pool_grow, which refuses slabs that reach past the pointer bits
+// (5-level paging, tagged pointers) instead of letting the tag corrupt them.
+#if defined(ZPL_ARCH_64_BIT)
+#    define ZPL__CONC_POOL_PTR_BITS 48
+#else
+#    define ZPL__CONC_POOL_PTR_BITS 32
+#endif
+
+#define ZPL__CONC_POOL_PTR_MASK ((cast(zpl_u64)1 << ZPL__CONC_POOL_PTR_BITS) - 1)
+
+zpl_internal zpl_u64 zpl__conc_pool_pack(void *ptr, zpl_u64 prev) {
+    zpl_u64 tag = (prev >> ZPL__CONC_POOL_PTR_BITS) + 1;
+    return cast(zpl_u64)cast(zpl_uintptr)ptr | (tag << ZPL__CONC_POOL_PTR_BITS);
+}
+
+zpl_internal void *zpl__conc_pool_ptr(zpl_u64 head) {
+    return cast(void *)cast(zpl_uintptr)(head & ZPL__CONC_POOL_PTR_MASK);
+}
+
+zpl_internal zpl_isize zpl__conc_pool_stride(zpl_conc_pool *pool) {
+    return zpl_align_forward_i64(zpl_max(pool->block_size, zpl_size_of(void *)), pool->block_align);
+}
+
+zpl_internal zpl_isize zpl__conc_pool_header(zpl_conc_pool *pool) {
+    return zpl_align_forward_i64(zpl_size_of(void *), pool->block_align);
+}
+
+zpl_internal void zpl__conc_pool_push(zpl_conc_pool *pool, void *first, void *last) {
+    zpl_u64 head, prev;
+    head = cast(zpl_u64)zpl_atomic64_load(&pool->free_list);
+    for (;;) {
+        *cast(void **)last = zpl__conc_pool_ptr(head);
+        prev = cast(zpl_u64)zpl_atomic64_compare_exchange(&pool->free_list, cast(zpl_i64)head, cast(zpl_i64)zpl__conc_pool_pack(first, head));
+        if (prev == head) break;
+        head = prev;
+    }
+}
+
+// NOTE: Thread all blocks of a slab into a list, returns the last block
+zpl_internal void *zpl__conc_pool_thread(zpl_conc_pool *pool, void *slab) {
+    zpl_isize stride = zpl__conc_pool_stride(pool);
+    zpl_u8 *curr = cast(zpl_u8 *)slab + zpl__conc_pool_header(pool);
+    for (zpl_isize i = 0; i < pool->num_blocks - 1; ++i) {
+        *cast(void **)curr = curr + stride;
+        curr += stride;
+    }
+    *cast(void **)curr = NULL;
+    return curr;
+}
+
+zpl_internal zpl_b32 zpl__conc_pool_grow(zpl_conc_pool *pool) {
+    zpl_isize slab_size = zpl__conc_pool_header(pool) + pool->num_blocks * zpl__conc_pool_stride(pool);
+    void *slab = zpl_alloc_align_uninit(pool->backing, slab_size, pool->block_align);
+    void *head, *last;
+    if (!slab) return false;
+
+    if ((cast(zpl_u64)cast(zpl_uintptr)zpl_pointer_add(slab, slab_size - 1) & ~ZPL__CONC_POOL_PTR_MASK) != 0) {
+        ZPL_ASSERT_MSG(0, "zpl_conc_pool: slab address does not fit into %d bits", ZPL__CONC_POOL_PTR_BITS);
+        zpl_free(pool->backing, slab);
+        return false;
+    }
+
+    do {
+        head = zpl_atomic_ptr_load(&pool->slabs);
+        *cast(void **)slab = head;
+    } while (zpl_atomic_ptr_compare_exchange(&pool->slabs, head, slab) != head);
+
+    last = zpl__conc_pool_thread(pool, slab);
+    zpl__conc_pool_push(pool, zpl_pointer_add(slab, zpl__conc_pool_header(pool)), last);
+    return true;
+}
+
+void zpl_conc_pool_init_align(zpl_conc_pool *pool, zpl_allocator backing, zpl_isize num_blocks, zpl_isize block_size,
+                              zpl_isize block_align) {
+    ZPL_ASSERT(num_blocks > 0);
+    zpl_zero_item(pool);
+    pool->backing = backing;
+    pool->block_size = block_size;
+    pool->block_align = block_align;
+    pool->num_blocks = num_blocks;
+    zpl_atomic64_store(&pool->free_list, 0);
+    zpl_atomic_ptr_store(&pool->slabs, NULL);
+    zpl__conc_pool_grow(pool);
+}
+
+void zpl_conc_pool_free(zpl_conc_pool *pool) {
+    void *slab = zpl_atomic_ptr_load(&pool->slabs);
+    while (slab) {
+        void *next = *cast(void **)slab;
+        zpl_free(pool->backing, slab);
+        slab = next;
+    }
+    zpl_atomic_ptr_store(&pool->slabs, NULL);
+    zpl_atomic64_store(&pool->free_list, 0);
+}
+
+ZPL_ALLOCATOR_PROC(zpl_conc_pool_allocator_proc) {
+    zpl_conc_pool *pool = cast(zpl_conc_pool *)allocator_data;
+    void *ptr = NULL;
+
+    zpl_unused(old_size);
+
+    switch (type) {
+        case ZPL_ALLOCATION_ALLOC: {
+            zpl_u64 head, prev;
+            ZPL_ASSERT(size <= pool->block_size);
+            ZPL_ASSERT(alignment <= pool->block_align);
+
+            head = cast(zpl_u64)zpl_atomic64_load(&pool->free_list);
+            for (;;) {
+                ptr = zpl__conc_pool_ptr(head);
+                if (!ptr) {
+                    if (!zpl__conc_pool_grow(pool)) return NULL;
+                    head = cast(zpl_u64)zpl_atomic64_load(&pool->free_list);
+                    continue;
+                }
+
+                // NOTE: The block may already be taken by another thread, the tag makes the CAS fail in that case
+                prev = cast(zpl_u64)zpl_atomic64_compare_exchange(&pool->free_list, cast(zpl_i64)head,
+                                                                  cast(zpl_i64)zpl__conc_pool_pack(*cast(void **)ptr, head));
+                if (prev == head) break;
+                head = prev;
+            }
+            if (flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO) zpl_zero_size(ptr, size);
+        } break;
+
+        case ZPL_ALLOCATION_FREE: {
+            if (old_memory) zpl__conc_pool_push(pool, old_memory, old_memory);
+        } break;
+
+        case ZPL_ALLOCATION_FREE_ALL: {
+            void *slab = zpl_atomic_ptr_load(&pool->slabs);
+            zpl_atomic64_store(&pool->free_list, 0);
+            while (slab) {
+                void *last = zpl__conc_pool_thread(pool, slab);
+                zpl__conc_pool_push(pool, zpl_pointer_add(slab, zpl__conc_pool_header(pool)), last);
+                slab = *cast(void **)slab;
+            }
+        } break;
+
+        case ZPL_ALLOCATION_RESIZE:
+        // NOTE: Cannot resize
+        ZPL_PANIC("You cannot resize something allocated by with a pool.");
+        break;
+    }
+
+    return ptr;
+}
+
+ZPL_END_C_DECLS
@@ -34,14 +34,19 @@ void zpl_yield_thread(void) {
 }
 
 void zpl_mfence(void) {
-#    if defined(ZPL_SYSTEM_WINDOWS)
-        _ReadWriteBarrier();
+    // NOTE: Has to order stores before later loads, _ReadWriteBarrier alone only restrains the compiler
+#    if defined(_MSC_VER) && defined(ZPL_CPU_X86)
+        _mm_mfence();
+#    elif defined(_MSC_VER)
+        MemoryBarrier();
 #    elif defined(ZPL_COMPILER_TINYC)
         __asm__ volatile ("" : : : "memory");
 #    elif defined(ZPL_SYSTEM_OSX)
         __sync_synchronize();
 #    elif defined(ZPL_CPU_X86)
         _mm_mfence();
+#    elif defined(__GNUC__) || defined(__clang__)
+        __sync_synchronize();
 #    endif
 }
 
@@ -52,6 +57,8 @@ void zpl_sfence(void) {
         __asm__ volatile ("" : : : "memory");
 #    elif defined(ZPL_CPU_X86)
         _mm_sfence();
+#    elif defined(__GNUC__) || defined(__clang__)
+        __atomic_thread_fence(__ATOMIC_RELEASE);
 #    endif
 }
 
@@ -62,6 +69,28 @@ void zpl_lfence(void) {
         __asm__ volatile ("" : : : "memory");
 #    elif defined(ZPL_CPU_X86)
         _mm_lfence();
+#    elif defined(__GNUC__) || defined(__clang__)
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#    endif
+}
+
+void zpl_acquire_fence(void) {
+#    if defined(ZPL_SYSTEM_WINDOWS)
+        _ReadWriteBarrier();
+#    elif defined(ZPL_COMPILER_TINYC)
+        __asm__ volatile ("" : : : "memory");
+#    else
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#    endif
+}
+
+void zpl_release_fence(void) {
+#    if defined(ZPL_SYSTEM_WINDOWS)
+        _ReadWriteBarrier();
+#    elif defined(ZPL_COMPILER_TINYC)
+        __asm__ volatile ("" : : : "memory");
+#    else
+        __atomic_thread_fence(__ATOMIC_RELEASE);
 #    endif
 }
 
@@ -0,0 +1,234 @@
+// file: source/threading/slab.c
+
+////////////////////////////////////////////////////////////////
+//
+// Slab Allocator
+//
+//
+
+ZPL_BEGIN_C_DECLS
+
+typedef struct zpl__slab_span {
+    zpl__slab_cache *owner;
+    struct zpl__slab_span *next;
+    zpl_isize size_class;
+} zpl__slab_span;
+
+// NOTE: Sits right in front of blocks above ZPL_SLAB_MAX_SIZE. The tag is the block address mixed with the slab's key,
+// small blocks never carry it because the words in front of them belong to the span header or the previous block.
+typedef struct zpl__slab_large {
+    void *base;
+    zpl_uintptr tag;
+} zpl__slab_large;
+
+#define ZPL__SLAB_SPAN_HEADER 64
+#define ZPL__SLAB_MAX_ALIGNMENT 64
+
+zpl_global zpl_isize const zpl__slab_sizes[ZPL_SLAB_CLASS_COUNT] = {
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096, 6144, 8192,
+};
+
+zpl_global zpl_atomic32 zpl__slab_ids;
+zpl_global zpl_thread_local zpl_slab *zpl__slab_current = NULL;
+zpl_global zpl_thread_local zpl_u32 zpl__slab_current_id = 0;
+zpl_global zpl_thread_local zpl__slab_cache *zpl__slab_current_cache = NULL;
+
+zpl_internal zpl__slab_span *zpl__slab_span_of(void *ptr) {
+    return cast(zpl__slab_span *)(cast(zpl_uintptr)ptr & ~cast(zpl_uintptr)(ZPL_SLAB_SPAN_SIZE - 1));
+}
+
+zpl_internal zpl__slab_large *zpl__slab_large_of(zpl_slab *slab, void *ptr) {
+    zpl__slab_large *large = cast(zpl__slab_large *)ptr - 1;
+    return (large->tag == (cast(zpl_uintptr)ptr ^ slab->large_key)) ? large : NULL;
+}
+
+zpl_internal zpl_isize zpl__slab_class(zpl_isize size, zpl_isize alignment) {
+    zpl_isize i;
+    if (size > ZPL_SLAB_MAX_SIZE || alignment > ZPL__SLAB_MAX_ALIGNMENT) return -1;
+    for (i = 0; i < ZPL_SLAB_CLASS_COUNT; ++i) {
+        if (zpl__slab_sizes[i] >= size && (zpl__slab_sizes[i] & (alignment - 1)) == 0) return i;
+    }
+    return -1;
+}
+
+zpl_internal zpl__slab_cache *zpl__slab_cache_get(zpl_slab *slab, zpl_b32 create) {
+    zpl_u32 me;
+    zpl__slab_cache *cache;
+
+    if (zpl__slab_current == slab && zpl__slab_current_id == slab->id) return zpl__slab_current_cache;
+
+    me = zpl_thread_current_id();
+    for (cache = cast(zpl__slab_cache *)zpl_atomic_ptr_load(&slab->caches); cache; cache = cache->next) {
+        if (zpl_atomic32_load(&cache->in_use) && cast(zpl_u32)zpl_atomic32_load(&cache->owner_id) == me) break;
+    }
+
+    if (!cache && create) {
+        // NOTE: Adopt a cache left behind by a detached thread before making a new one
+        for (cache = cast(zpl__slab_cache *)zpl_atomic_ptr_load(&slab->caches); cache; cache = cache->next) {
+            if (!zpl_atomic32_load(&cache->in_use) && zpl_atomic32_compare_exchange(&cache->in_use, 0, 1) == 0) break;
+        }
+
+        if (!cache) {
+            void *head;
+            cache = cast(zpl__slab_cache *)zpl_alloc_uninit(slab->backing, zpl_size_of(zpl__slab_cache));
+            if (!cache) return NULL;
+            zpl_zero_item(cache);
+            zpl_atomic32_store(&cache->in_use, 1);
+            do {
+                head = zpl_atomic_ptr_load(&slab->caches);
+                cache->next = cast(zpl__slab_cache *)head;
+            } while (zpl_atomic_ptr_compare_exchange(&slab->caches, head, cache) != head);
+        }
+        zpl_atomic32_store(&cache->owner_id, cast(zpl_i32)me);
+    }
+
+    if (cache) {
+        zpl__slab_current = slab;
+        zpl__slab_current_id = slab->id;
+        zpl__slab_current_cache = cache;
+    }
+    return cache;
+}
+
+zpl_internal void *zpl__slab_alloc(zpl_slab *slab, zpl_isize size_class) {
+    zpl__slab_cache *cache = zpl__slab_cache_get(slab, true);
+    zpl_isize block_size = zpl__slab_sizes[size_class];
+    void *block;
+    if (!cache) return NULL;
+
+    block = cache->magazines[size_class];
+    if (!block && zpl_atomic_ptr_load(&cache->remote[size_class])) {
+        block = zpl_atomic_ptr_exchange(&cache->remote[size_class], NULL);
+    }
+    if (block) {
+        cache->magazines[size_class] = *cast(void **)block;
+        return block;
+    }
+
+    if (cache->bump_end[size_class] - cache->bump[size_class] < block_size) {
+        zpl__slab_span *span = cast(zpl__slab_span *)zpl_alloc_align_uninit(slab->backing, ZPL_SLAB_SPAN_SIZE, ZPL_SLAB_SPAN_SIZE);
+        if (!span) return NULL;
+        // NOTE: The end of the header precedes the first block, keep it from looking like a large block tag
+        zpl_zero_size(span, ZPL__SLAB_SPAN_HEADER);
+        span->owner = cache;
+        span->size_class = size_class;
+        span->next = cast(zpl__slab_span *)cache->spans;
+        cache->spans = span;
+        cache->bump[size_class] = cast(zpl_u8 *)span + ZPL__SLAB_SPAN_HEADER;
+        cache->bump_end[size_class] = cast(zpl_u8 *)span + ZPL_SLAB_SPAN_SIZE;
+    }
+
+    block = cache->bump[size_class];
+    cache->bump[size_class] += block_size;
+    return block;
+}
+
+zpl_internal void zpl__slab_release(zpl_slab *slab, void *ptr) {
+    zpl__slab_large *large = zpl__slab_large_of(slab, ptr);
+    zpl__slab_span *span;
+    zpl__slab_cache *owner;
+
+    if (large) {
+        large->tag = 0;
+        zpl_free(slab->backing, large->base);
+        return;
+    }
+
+    span = zpl__slab_span_of(ptr);
+    owner = span->owner;
+    if (owner == zpl__slab_cache_get(slab, false)) {
+        *cast(void **)ptr = owner->magazines[span->size_class];
+        owner->magazines[span->size_class] = ptr;
+    } else {
+        zpl_atomic_ptr *remote = &owner->remote[span->size_class];
+        void *head;
+        do {
+            head = zpl_atomic_ptr_load(remote);
+            *cast(void **)ptr = head;
+        } while (zpl_atomic_ptr_compare_exchange(remote, head, ptr) != head);
+    }
+}
+
+void zpl_slab_init(zpl_slab *slab, zpl_allocator backing) {
+    zpl_zero_item(slab);
+    slab->backing = backing;
+    slab->id = cast(zpl_u32)zpl_atomic32_fetch_add(&zpl__slab_ids, 1) + 1;
+    // NOTE: Odd, so a tag never matches the zeroed span header or an aligned pointer stored in the previous block
+    slab->large_key = cast(zpl_uintptr)zpl_flat_table_hash(cast(zpl_u64)cast(zpl_uintptr)slab ^ (cast(zpl_u64)slab->id << 32)) | 1;
+}
+
+void zpl_slab_free(zpl_slab *slab) {
+    zpl__slab_cache *cache = cast(zpl__slab_cache *)zpl_atomic_ptr_load(&slab->caches);
+    while (cache) {
+        zpl__slab_cache *next = cache->next;
+        zpl__slab_span *span = cast(zpl__slab_span *)cache->spans;
+        while (span) {
+            zpl__slab_span *next_span = span->next;
+            zpl_free(slab->backing, span);
+            span = next_span;
+        }
+        zpl_free(slab->backing, cache);
+        cache = next;
+    }
+    zpl_atomic_ptr_store(&slab->caches, NULL);
+    if (zpl__slab_current == slab) zpl__slab_current = NULL;
+}
+
+void zpl_slab_thread_detach(zpl_slab *slab) {
+    zpl__slab_cache *cache = zpl__slab_cache_get(slab, false);
+    if (!cache) return;
+    zpl_atomic32_store(&cache->owner_id, 0);
+    zpl_atomic32_store(&cache->in_use, 0);
+    zpl__slab_current = NULL;
+}
+
+ZPL_ALLOCATOR_PROC(zpl_slab_allocator_proc) {
+    zpl_slab *slab = cast(zpl_slab *)allocator_data;
+    zpl_isize size_class;
+    void *ptr = NULL;
+
+    if (!alignment) alignment = ZPL_DEFAULT_MEMORY_ALIGNMENT;
+
+    switch (type) {
+        case ZPL_ALLOCATION_ALLOC: {
+            size_class = zpl__slab_class(zpl_max(size, 1), alignment);
+            if (size_class >= 0) {
+                ptr = zpl__slab_alloc(slab, size_class);
+            } else {
+                zpl_isize offset = zpl_align_forward_i64(zpl_size_of(zpl__slab_large), alignment);
+                void *base = zpl_alloc_align_uninit(slab->backing, offset + size, alignment);
+                zpl__slab_large *large;
+                if (!base) return NULL;
+                ptr = zpl_pointer_add(base, offset);
+                large = cast(zpl__slab_large *)ptr - 1;
+                large->base = base;
+                large->tag = cast(zpl_uintptr)ptr ^ slab->large_key;
+            }
+            if (ptr && (flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO)) zpl_zero_size(ptr, size);
+        } break;
+
+        case ZPL_ALLOCATION_FREE: {
+            if (old_memory) zpl__slab_release(slab, old_memory);
+        } break;
+
+        case ZPL_ALLOCATION_FREE_ALL: break;
+
+        case ZPL_ALLOCATION_RESIZE: {
+            zpl__slab_span *span = (old_memory && !zpl__slab_large_of(slab, old_memory)) ? zpl__slab_span_of(old_memory) : NULL;
+
+            // NOTE: Stay in the same block as long as the new size fits its class
+            if (span && size > 0 && size <= zpl__slab_sizes[span->size_class] &&
+                (cast(zpl_uintptr)old_memory & cast(zpl_uintptr)(alignment - 1)) == 0) {
+                if (size > old_size && (flags & ZPL_ALLOCATOR_FLAG_CLEAR_TO_ZERO)) {
+                    zpl_zero_size(zpl_pointer_add(old_memory, old_size), size - old_size);
+                }
+                ptr = old_memory;
+            } else {
+                ptr = zpl_default_resize_align_with_flags(zpl_slab_allocator(slab), old_memory, old_size, size, alignment, flags);
+            }
+        } break;
+    }
+    return ptr;
+}
+
+ZPL_END_C_DECLS
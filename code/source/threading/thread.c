@@ -38,6 +38,9 @@ static void zpl__thread_run(zpl_thread *t) {
     if (!t->nowait)
         zpl_semaphore_release(&t->semaphore);
     t->return_value = t->proc(t);
+#if defined(ZPL_MODULE_CORE)
+    zpl_temp_release();
+#endif
 }
 
 #if defined(ZPL_SYSTEM_WINDOWS)
@@ -5,6 +5,25 @@
 
 #define __A zpl_pool_allocator(&pool)
 
+static zpl_isize unit__conc_pool_worker(zpl_thread *thread) {
+    zpl_conc_pool *pool = cast(zpl_conc_pool *)thread->user_data;
+    zpl_u64 *held[16];
+    zpl_u64 me = zpl_thread_current_id();
+    zpl_b32 ok = true;
+    for (int round = 0; round < 2000; ++round) {
+        for (int i = 0; i < 16; ++i) {
+            held[i] = cast(zpl_u64 *)zpl_alloc_align(zpl_conc_pool_allocator(pool), zpl_size_of(zpl_u64) * 2, 16);
+            held[i][0] = me;
+            held[i][1] = i;
+        }
+        for (int i = 0; i < 16; ++i) {
+            ok &= (held[i][0] == me && held[i][1] == cast(zpl_u64)i);
+            zpl_free(zpl_conc_pool_allocator(pool), held[i]);
+        }
+    }
+    return ok;
+}
+
 MODULE(alloc_pool, {
     zpl_pool pool = {0};
 
@@ -70,6 +89,45 @@ MODULE(alloc_pool, {
         __CLEANUP();
     });
 
+    IT("chains another slab once all blocks are taken", {
+        zpl_pool_init(&pool, zpl_heap(), 2, 8);
+
+        void *a = zpl_alloc(__A, 8);
+        void *b = zpl_alloc(__A, 8);
+        void *c = zpl_alloc(__A, 8);
+        NEQUALS(c, NULL);
+        NEQUALS(c, a);
+        NEQUALS(c, b);
+        EQUALS(pool.total_size, 24);
+
+        zpl_free_all(__A);
+        EQUALS((zpl_uintptr)pool.physical_start, (zpl_uintptr)pool.free_list);
+        for (int i = 0; i < 4; ++i) NEQUALS(zpl_alloc(__A, 8), NULL);
+        EQUALS(pool.free_list, NULL);
+        __CLEANUP();
+    });
+
+    IT("shares a concurrent pool between threads", {
+        zpl_conc_pool cpool;
+        zpl_thread threads[4];
+        zpl_b32 ok = true;
+        zpl_conc_pool_init(&cpool, zpl_heap(), 8, zpl_size_of(zpl_u64) * 2);
+
+        for (int i = 0; i < 4; ++i) {
+            zpl_thread_init(&threads[i]);
+            zpl_thread_start(&threads[i], unit__conc_pool_worker, &cpool);
+        }
+        for (int i = 0; i < 4; ++i) {
+            zpl_thread_join(&threads[i]);
+            ok &= (threads[i].return_value == 1);
+            zpl_thread_destroy(&threads[i]);
+        }
+        EQUALS(ok, true);
+
+        zpl_free_all(zpl_conc_pool_allocator(&cpool));
+        zpl_conc_pool_free(&cpool);
+    });
+
 });
 
 #undef __CLEANUP
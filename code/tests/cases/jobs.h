@@ -0,0 +1,285 @@
+zpl_global zpl_atomic32 unit__jobs_hits;
+
+static void unit__jobs_hit(void *data) {
+    zpl_unused(data);
+    zpl_atomic32_fetch_add(&unit__jobs_hits, 1);
+}
+
+static void unit__jobs_spawn(void *data) {
+    zpl_jobs_system *pool = cast(zpl_jobs_system *)data;
+    for (int i = 0; i < 8; ++i) {
+        while (!zpl_jobs_enqueue(pool, unit__jobs_hit, NULL)) zpl_yield();
+    }
+    zpl_atomic32_fetch_add(&unit__jobs_hits, 1);
+}
+
+static zpl_isize unit__jobs_producer(zpl_thread *thread) {
+    zpl_jobs_system *pool = cast(zpl_jobs_system *)thread->user_data;
+    for (int i = 0; i < 250; ++i) {
+        while (!zpl_jobs_enqueue(pool, unit__jobs_hit, NULL)) zpl_yield();
+    }
+    return 0;
+}
+
+/* pins itself, so the tester's own thread keeps its affinity */
+static zpl_isize unit__jobs_pinned(zpl_thread *thread) {
+    return zpl_affinity_set(cast(zpl_affinity *)thread->user_data, 0, 0);
+}
+
+zpl_global zpl_atomic32 unit__jobs_release;
+
+/* waits for the test to register its continuation, then fills the worker's deque and the shared queue */
+static void unit__jobs_flood(void *data) {
+    zpl_jobs_system *pool = cast(zpl_jobs_system *)data;
+    while (!zpl_atomic32_load(&unit__jobs_release)) zpl_yield();
+    while (zpl_jobs_enqueue(pool, unit__jobs_hit, NULL)) {}
+}
+
+typedef struct {
+    zpl_jobs_system *pool;
+    zpl_i32 n;
+    zpl_i32 result;
+} unit__jobs_fib_t;
+
+static void unit__jobs_fib(void *data) {
+    unit__jobs_fib_t *f = cast(unit__jobs_fib_t *)data;
+    if (f->n < 2) {
+        f->result = f->n;
+        return;
+    }
+
+    unit__jobs_fib_t a = { f->pool, f->n - 1, 0 };
+    unit__jobs_fib_t b = { f->pool, f->n - 2, 0 };
+    zpl_jobs_counter counter;
+    zpl_jobs_counter_init(&counter);
+
+    if (!zpl_jobs_enqueue_counted(f->pool, unit__jobs_fib, &a, ZPL_JOBS_PRIORITY_NORMAL, &counter)) {
+        unit__jobs_fib(&a);
+    }
+    unit__jobs_fib(&b);
+    zpl_jobs_wait(f->pool, &counter);
+    f->result = a.result + b.result;
+}
+
+zpl_global zpl_atomic32 unit__jobs_stage;
+
+static void unit__jobs_stage_first(void *data) {
+    zpl_unused(data);
+    zpl_atomic32_fetch_add(&unit__jobs_stage, 1);
+}
+
+static void unit__jobs_stage_second(void *data) {
+    // NOTE: both first stage jobs have to be finished by now
+    zpl_atomic32_compare_exchange(&unit__jobs_stage, 2, 100);
+    zpl_unused(data);
+}
+
+static void unit__jobs_square(void *data, zpl_isize begin, zpl_isize end) {
+    zpl_i64 *values = cast(zpl_i64 *)data;
+    for (zpl_isize i = begin; i < end; ++i) {
+        values[i] = i * i;
+    }
+}
+
+static void unit__jobs_sum(void *data, zpl_isize begin, zpl_isize end, void *partial) {
+    zpl_i64 *values = cast(zpl_i64 *)data;
+    zpl_i64 *sum = cast(zpl_i64 *)partial;
+    for (zpl_isize i = begin; i < end; ++i) {
+        *sum += values[i];
+    }
+}
+
+static void unit__jobs_sum_combine(void *data, void *result, void const *partial) {
+    zpl_unused(data);
+    *cast(zpl_i64 *)result += *cast(zpl_i64 const *)partial;
+}
+
+MODULE(jobs, {
+    IT("processes all jobs using the dispatch loop", {
+        zpl_jobs_system pool = {0};
+        zpl_atomic32_store(&unit__jobs_hits, 0);
+        zpl_jobs_init_with_limit(&pool, zpl_heap(), 4, 1000);
+
+        for (int i = 0; i < 1000; ++i) {
+            zpl_jobs_enqueue_with_priority(&pool, unit__jobs_hit, NULL, (zpl_jobs_priority)(i % ZPL_JOBS_MAX_PRIORITIES));
+        }
+
+        while (zpl_jobs_process(&pool) || !zpl_jobs_done(&pool)) zpl_yield();
+        zpl_jobs_free(&pool);
+
+        EQUALS(zpl_atomic32_load(&unit__jobs_hits), 1000);
+    });
+
+    IT("processes all jobs in work-stealing mode", {
+        zpl_jobs_system pool = {0};
+        zpl_atomic32_store(&unit__jobs_hits, 0);
+        zpl_jobs_init_with_flags(&pool, zpl_heap(), 4, 1000, ZPL_JOBS_FLAG_WORK_STEALING);
+
+        for (int i = 0; i < 1000; ++i) {
+            zpl_jobs_enqueue_with_priority(&pool, unit__jobs_hit, NULL, (zpl_jobs_priority)(i % ZPL_JOBS_MAX_PRIORITIES));
+        }
+
+        while (!zpl_jobs_done(&pool)) zpl_yield();
+        zpl_jobs_free(&pool);
+
+        EQUALS(zpl_atomic32_load(&unit__jobs_hits), 1000);
+    });
+
+    IT("runs jobs spawned by other jobs in work-stealing mode", {
+        zpl_jobs_system pool = {0};
+        zpl_atomic32_store(&unit__jobs_hits, 0);
+        zpl_jobs_init_with_flags(&pool, zpl_heap(), 4, 64, ZPL_JOBS_FLAG_WORK_STEALING);
+
+        for (int i = 0; i < 100; ++i) {
+            while (!zpl_jobs_enqueue(&pool, unit__jobs_spawn, &pool)) zpl_yield();
+        }
+
+        while (!zpl_jobs_done(&pool)) zpl_yield();
+        zpl_jobs_free(&pool);
+
+        EQUALS(zpl_atomic32_load(&unit__jobs_hits), 900);
+    });
+
+    IT("accepts jobs from multiple producer threads", {
+        zpl_jobs_system pool = {0};
+        zpl_thread producers[4];
+        zpl_atomic32_store(&unit__jobs_hits, 0);
+        zpl_jobs_init_with_flags(&pool, zpl_heap(), 2, 64, ZPL_JOBS_FLAG_WORK_STEALING);
+
+        for (int i = 0; i < 4; ++i) {
+            zpl_thread_init(&producers[i]);
+            zpl_thread_start(&producers[i], unit__jobs_producer, &pool);
+        }
+        for (int i = 0; i < 4; ++i) {
+            zpl_thread_destroy(&producers[i]);
+        }
+
+        while (!zpl_jobs_done(&pool)) zpl_yield();
+        zpl_jobs_free(&pool);
+
+        EQUALS(zpl_atomic32_load(&unit__jobs_hits), 1000);
+    });
+
+    IT("enqueues a batch of jobs up to the queue capacity", {
+        zpl_jobs_system pool = {0};
+        zpl_thread_job jobs[100] = {0};
+        zpl_atomic32_store(&unit__jobs_hits, 0);
+        zpl_jobs_init_with_limit(&pool, zpl_heap(), 2, 64);
+
+        for (int i = 0; i < 100; ++i) {
+            jobs[i].proc = unit__jobs_hit;
+            jobs[i].data = NULL;
+        }
+
+        EQUALS(zpl_jobs_enqueue_batch(&pool, jobs, 100, ZPL_JOBS_PRIORITY_NORMAL), 64);
+        EQUALS(zpl_jobs_full(&pool, ZPL_JOBS_PRIORITY_NORMAL), true);
+
+        while (zpl_jobs_process(&pool) || !zpl_jobs_done(&pool)) zpl_yield();
+        zpl_jobs_free(&pool);
+
+        EQUALS(zpl_atomic32_load(&unit__jobs_hits), 64);
+    });
+
+    IT("waits on a counter while helping to run jobs", {
+        for (zpl_u32 flags = 0; flags <= ZPL_JOBS_FLAG_WORK_STEALING; flags += ZPL_JOBS_FLAG_WORK_STEALING) {
+            zpl_jobs_system pool = {0};
+            zpl_jobs_init_with_flags(&pool, zpl_heap(), 3, 256, flags);
+
+            unit__jobs_fib_t f = { &pool, 16, 0 };
+            zpl_jobs_counter counter;
+            zpl_jobs_counter_init(&counter);
+            zpl_jobs_enqueue_counted(&pool, unit__jobs_fib, &f, ZPL_JOBS_PRIORITY_NORMAL, &counter);
+            zpl_jobs_wait(&pool, &counter);
+            zpl_jobs_free(&pool);
+
+            EQUALS(f.result, 987);
+        }
+    });
+
+    IT("runs a continuation once its dependencies finish", {
+        for (zpl_u32 flags = 0; flags <= ZPL_JOBS_FLAG_WORK_STEALING; flags += ZPL_JOBS_FLAG_WORK_STEALING) {
+            zpl_jobs_system pool = {0};
+            zpl_jobs_counter first, second;
+            zpl_jobs_init_with_flags(&pool, zpl_heap(), 2, 64, flags);
+            zpl_jobs_counter_init(&first);
+            zpl_jobs_counter_init(&second);
+            zpl_atomic32_store(&unit__jobs_stage, 0);
+
+            zpl_jobs_enqueue_counted(&pool, unit__jobs_stage_first, NULL, ZPL_JOBS_PRIORITY_NORMAL, &first);
+            zpl_jobs_enqueue_counted(&pool, unit__jobs_stage_first, NULL, ZPL_JOBS_PRIORITY_NORMAL, &first);
+            zpl_jobs_enqueue_after(&pool, &first, unit__jobs_stage_second, NULL, ZPL_JOBS_PRIORITY_HIGH, &second);
+            zpl_jobs_wait(&pool, &second);
+            zpl_jobs_free(&pool);
+
+            EQUALS(zpl_atomic32_load(&unit__jobs_stage), 100);
+        }
+    });
+
+    IT("finishes when a continuation has to run inline on full queues", {
+        zpl_jobs_system pool = {0};
+        zpl_jobs_counter flood, after;
+        zpl_jobs_init_with_flags(&pool, zpl_heap(), 1, 16, ZPL_JOBS_FLAG_WORK_STEALING);
+        zpl_jobs_counter_init(&flood);
+        zpl_jobs_counter_init(&after);
+        zpl_atomic32_store(&unit__jobs_release, 0);
+        zpl_atomic32_store(&unit__jobs_stage, 2);
+
+        zpl_jobs_enqueue_counted(&pool, unit__jobs_flood, &pool, ZPL_JOBS_PRIORITY_NORMAL, &flood);
+        zpl_jobs_enqueue_after(&pool, &flood, unit__jobs_stage_second, NULL, ZPL_JOBS_PRIORITY_NORMAL, &after);
+        zpl_atomic32_store(&unit__jobs_release, 1);
+        while (!zpl_jobs_counter_done(&flood)) zpl_yield();
+        zpl_jobs_wait(&pool, &after);
+
+        for (int i = 0; i < 10000 && !zpl_jobs_done(&pool); ++i) zpl_sleep_ms(1);
+        EQUALS(zpl_jobs_done(&pool), true);
+        EQUALS(zpl_atomic32_load(&pool.pending), 0);
+        EQUALS(zpl_atomic32_load(&unit__jobs_stage), 100);
+        zpl_jobs_free(&pool);
+    });
+
+    IT("runs a parallel loop and reduction over a range", {
+        for (zpl_u32 flags = 0; flags <= ZPL_JOBS_FLAG_WORK_STEALING; flags += ZPL_JOBS_FLAG_WORK_STEALING) {
+            zpl_jobs_system pool = {0};
+            zpl_i64 *values = cast(zpl_i64 *)zpl_alloc(zpl_heap(), 10000 * zpl_size_of(zpl_i64));
+            zpl_i64 sum = 0, expected = 0;
+            zpl_jobs_init_with_flags(&pool, zpl_heap(), 3, 64, flags);
+
+            zpl_jobs_parallel_for(&pool, 0, 10000, 0, unit__jobs_square, values);
+            zpl_jobs_parallel_reduce(&pool, 0, 10000, 7, unit__jobs_sum, unit__jobs_sum_combine, values, &sum, zpl_size_of(sum));
+            zpl_jobs_free(&pool);
+
+            for (zpl_i64 i = 0; i < 10000; ++i) expected += i * i;
+            zpl_free(zpl_heap(), values);
+
+            EQUALS(sum, expected);
+        }
+    });
+
+    IT("discovers the cpu topology and runs pinned workers", {
+        zpl_affinity af;
+        zpl_thread thread;
+        zpl_jobs_system pool = {0};
+        zpl_jobs_counter done;
+
+        zpl_atomic32_store(&unit__jobs_hits, 0);
+        zpl_affinity_init(&af);
+        GREATER(af.core_count, 0);
+        EQUALS((af.thread_count >= af.core_count), true);
+        zpl_thread_init(&thread);
+        zpl_thread_start(&thread, unit__jobs_pinned, &af);
+        zpl_thread_join(&thread);
+        EQUALS(thread.return_value, 1);
+        zpl_thread_destroy(&thread);
+        zpl_affinity_destroy(&af);
+
+        zpl_jobs_init_with_flags(&pool, zpl_heap(), 2, 16, ZPL_JOBS_FLAG_WORK_STEALING | ZPL_JOBS_FLAG_PIN_WORKERS);
+        zpl_jobs_counter_init(&done);
+        for (int i = 0; i < 8; ++i) {
+            zpl_jobs_enqueue_counted(&pool, unit__jobs_hit, NULL, ZPL_JOBS_PRIORITY_NORMAL, &done);
+        }
+        zpl_jobs_wait(&pool, &done);
+        zpl_jobs_free(&pool);
+
+        EQUALS(zpl_atomic32_load(&unit__jobs_hits), 8);
+    });
+});
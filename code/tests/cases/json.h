@@ -1,3 +1,22 @@
+static zpl_b32 unit_json_trace(void *user_data, zpl_json_event const *ev) {
+    zpl_string *trace = cast(zpl_string *)user_data;
+    if (ev->node.name) *trace = zpl_string_append_fmt(*trace, "%s=", ev->node.name);
+    switch (ev->type) {
+        case ZPL_JSON_EVENT_OBJECT_BEGIN: *trace = zpl_string_appendc(*trace, "{"); break;
+        case ZPL_JSON_EVENT_OBJECT_END:   *trace = zpl_string_appendc(*trace, "}"); break;
+        case ZPL_JSON_EVENT_ARRAY_BEGIN:  *trace = zpl_string_appendc(*trace, "["); break;
+        case ZPL_JSON_EVENT_ARRAY_END:    *trace = zpl_string_appendc(*trace, "]"); break;
+        default: {
+            if (ev->node.props == ZPL_ADT_PROPS_TRUE) *trace = zpl_string_appendc(*trace, "true ");
+            else if (ev->node.props == ZPL_ADT_PROPS_NULL) *trace = zpl_string_appendc(*trace, "null ");
+            else if (ev->node.type == ZPL_ADT_TYPE_STRING) *trace = zpl_string_append_fmt(*trace, "'%s' ", ev->node.string);
+            else if (ev->node.type == ZPL_ADT_TYPE_INTEGER) *trace = zpl_string_append_fmt(*trace, "%lld ", cast(long long)ev->node.integer);
+            else *trace = zpl_string_append_fmt(*trace, "%.2f ", ev->node.real);
+        } break;
+    }
+    return true;
+}
+
 #define __PARSE() \
     zpl_json_object r={0}; \
     zpl_u8 err = zpl_json_parse(&r, (char *)t, mem_alloc);
@@ -20,6 +39,20 @@ MODULE(json5_parser, {
         EQUALS(r.type, ZPL_ADT_TYPE_ARRAY);
     });
 
+    IT("fails to parse empty input", {
+        char t[] = "";
+        __PARSE();
+
+        EQUALS(err, ZPL_JSON_ERROR_OBJECT_END_PAIR_MISMATCHED);
+    });
+
+    IT("fails to parse whitespace-only input", {
+        char t[] = "  \n\t  \n";
+        __PARSE();
+
+        EQUALS(err, ZPL_JSON_ERROR_OBJECT_END_PAIR_MISMATCHED);
+    });
+
     IT("parses cfg mode document", {
         zpl_string t = zpl_string_make(mem_alloc, "\n\nfoo = \"bar\"\nbaz = 123\n\n");
         __PARSE();
@@ -95,6 +128,21 @@ MODULE(json5_parser, {
         EQUALS(r.nodes[0].integer, 123);
     });
 
+    IT("parses values spanning several index blocks", {
+        zpl_string t = zpl_string_make(mem_alloc, "{\n");
+        t = zpl_string_append_fmt(t, "%*r\"a\": \"%*r\\\"%*r\",\n", 70, ' ', 60, 'x', 70, 'y');
+        t = zpl_string_append_fmt(t, "%*r/* %*r */ b: '%*r'%*r\n}", 130, '\t', 64, '-', 128, 'z', 65, ' ');
+        __PARSE();
+
+        EQUALS(err, ZPL_JSON_ERROR_NONE);
+        EQUALS(zpl_array_count(r.nodes), 2);
+        STREQUALS(r.nodes[0].name, "a");
+        EQUALS(zpl_strlen(r.nodes[0].string), 132);
+        EQUALS(r.nodes[0].string[61], '"');
+        STREQUALS(r.nodes[1].name, "b");
+        EQUALS(zpl_strlen(r.nodes[1].string), 128);
+    });
+
     IT("parses JSON array of multiple values", {
         zpl_string t = zpl_string_make(mem_alloc, "[ 123, 456, `hello` ]");
         __PARSE();
@@ -176,6 +224,25 @@ MODULE(json5_parser, {
         EQUALS(err, ZPL_JSON_ERROR_NONE);
     });
 
+    IT("keeps parent links valid when a parsed document is edited", {
+        zpl_string t = zpl_string_make(mem_alloc, "{ a: 1, b: { c: 2, d: [3, 4] } }");
+        __PARSE();
+        EQUALS(err, ZPL_JSON_ERROR_NONE);
+
+        NEQUALS(zpl_adt_append_int(&r, "e", 5), NULL);
+        EQUALS(zpl_adt_query(&r, "b/d/0")->parent, zpl_adt_query(&r, "b/d"));
+        EQUALS(zpl_adt_query(&r, "b/c")->parent, zpl_adt_query(&r, "b"));
+
+        NEQUALS(zpl_adt_append_int(zpl_adt_query(&r, "b"), "f", 6), NULL);
+        EQUALS(zpl_adt_query(&r, "b/d/1")->parent, zpl_adt_query(&r, "b/d"));
+        NEQUALS(zpl_adt_append_int(zpl_adt_query(&r, "b/d"), NULL, 7), NULL);
+        EQUALS(zpl_adt_query(&r, "b/d/2")->integer, 7);
+        EQUALS(zpl_adt_query(&r, "b/d/0")->parent, zpl_adt_query(&r, "b/d"));
+        EQUALS(zpl_adt_query(&r, "e")->integer, 5);
+
+        zpl_json_free(&r);
+    });
+
     IT("parses empty object as a field", {
         zpl_string t = zpl_string_make(mem_alloc, ZPL_MULTILINE(\
                 {
@@ -300,8 +367,11 @@ MODULE(json5_parser, {
             zpl_arena_init_from_memory(&arena, buffer, i);
             zpl_allocator allocator = zpl_arena_allocator(&arena);
 
+            // NOTE: a failed parse leaves the text cut up, every attempt starts from a fresh copy
+            zpl_string text = zpl_string_duplicate(zpl_heap(), t);
             zpl_json_object r={0};
-            zpl_u8 err = zpl_json_parse(&r, (char *)t, allocator);
+            zpl_u8 err = zpl_json_parse(&r, text, allocator);
+            zpl_string_free(text);
 			if (err == ZPL_JSON_ERROR_OUT_OF_MEMORY)
 				continue;
             EQUALS(err, ZPL_JSON_ERROR_NONE);
@@ -372,6 +442,188 @@ MODULE(json5_parser, {
         }
 	    zpl_mfree(buffer);
 	});
+
+    IT("keeps parsed documents linked and editable", {
+        char t[] = "{ \"a\": { \"b\": [1, 2, { \"c\": 3 }] }, \"d\": [], \"e\": \"x\" }";
+        zpl_json_object r = {0};
+        EQUALS(zpl_json_parse(&r, t, zpl_heap()), ZPL_JSON_ERROR_NONE);
+
+        zpl_adt_node *c = zpl_adt_query(&r, "a/b/2/c");
+        NEQUALS(c, NULL);
+        EQUALS(c->integer, 3);
+        EQUALS(c->parent->parent->parent->parent, &r);
+        EQUALS(zpl_adt_find(&r, "b", true), c->parent->parent);
+
+        zpl_adt_node *d = zpl_adt_find(&r, "d", false);
+        zpl_adt_append_int(d, NULL, 42);
+        zpl_adt_append_int(d, NULL, 43);
+        EQUALS(zpl_array_count(d->nodes), 2);
+        EQUALS(zpl_adt_query(&r, "d/1")->integer, 43);
+
+        zpl_adt_remove_node(zpl_adt_find(&r, "e", false));
+        zpl_adt_append_str(&r, "f", "y");
+        EQUALS(zpl_array_count(r.nodes), 3);
+        STREQUALS(zpl_adt_query(&r, "f")->string, "y");
+        zpl_json_free(&r);
+    });
+
+    IT("parses a document of long strings into a tight arena", {
+        zpl_string text = zpl_string_make(zpl_heap(), "[");
+        zpl_string body = zpl_string_make_reserve(zpl_heap(), 800);
+        for (int i = 0; i < 800; ++i) body = zpl_string_append_length(body, "lorem ipsum " + i % 12, 1);
+        for (int i = 0; i < 1232; ++i) {
+            text = zpl_string_append_fmt(text, "%s{\"id\": %d, \"text\": \"%s\", \"tag\": \"x\"}", i ? ", " : "", i, body);
+        }
+        text = zpl_string_appendc(text, "]");
+
+        // NOTE: about 1MB of input with 4928 nodes, the per-branch arrays used to fit in 768KB
+        zpl_arena arena;
+        zpl_arena_init_from_allocator(&arena, zpl_heap(), zpl_kilobytes(768));
+        zpl_json_object r = {0};
+        EQUALS(zpl_json_parse(&r, text, zpl_arena_allocator(&arena)), ZPL_JSON_ERROR_NONE);
+        EQUALS(zpl_array_count(r.nodes), 1232);
+        EQUALS(zpl_adt_query(&r, "1231/id")->integer, 1231);
+        EQUALS(zpl_strlen(zpl_adt_query(&r, "0/text")->string), 800);
+
+        zpl_arena_free(&arena);
+        zpl_string_free(body);
+        zpl_string_free(text);
+    });
+
+    IT("reads selected fields through a cursor", {
+        const char *t = "{ \"skip\": { \"a\": [1, \"]}\\\"\", {}], /* } */ b: 2 },\n"
+                        "  'list': [10, 20.5, true, null, `multi`], n: -16, deep: { x: { y: 'found' } } }";
+        zpl_json_cursor root = zpl_json_cursor_make(t, zpl_strlen(t));
+        zpl_json_cursor c;
+        zpl_isize len;
+
+        EQUALS(zpl_json_cursor_type(&root), ZPL_ADT_TYPE_OBJECT);
+        EQUALS(zpl_json_cursor_count(&root), 4);
+
+        c = zpl_json_cursor_query(&root, "skip/b");
+        EQUALS(zpl_json_cursor_integer(&c, 0), 2);
+
+        c = zpl_json_cursor_query(&root, "list/1");
+        EQUALS(zpl_json_cursor_type(&c), ZPL_ADT_TYPE_REAL);
+        EQUALS(zpl_json_cursor_real(&c, 0), 20.5);
+        c = zpl_json_cursor_query(&root, "list/2");
+        EQUALS(zpl_json_cursor_bool(&c, false), true);
+        c = zpl_json_cursor_query(&root, "list/3");
+        EQUALS(zpl_json_cursor_is_null(&c), true);
+        c = zpl_json_cursor_query(&root, "list/4");
+        EQUALS(zpl_json_cursor_type(&c), ZPL_ADT_TYPE_MULTISTRING);
+
+        c = zpl_json_cursor_find(&root, "n");
+        EQUALS(zpl_json_cursor_integer(&c, 0), -16);
+
+        c = zpl_json_cursor_query(&root, "deep/x/y");
+        char const *str = zpl_json_cursor_str(&c, &len);
+        EQUALS(len, 5);
+        EQUALS(zpl_strncmp(str, "found", 5), 0);
+
+        c = zpl_json_cursor_query(&root, "skip/a/1");
+        str = zpl_json_cursor_str(&c, &len);
+        EQUALS(len, 4);
+
+        c = zpl_json_cursor_query(&root, "list/9/missing");
+        EQUALS(zpl_json_cursor_valid(&c), false);
+        EQUALS(zpl_json_cursor_integer(&c, 7), 7);
+    });
+
+    IT("streams events from input split at every byte", {
+        const char *t = "{ \"a\": [1, 2.5, \"x\\\"y\"], // note\n b: { c: true }, /* ** */ 'd': -3, }\n[null]";
+        zpl_string trace = zpl_string_make(mem_alloc, "");
+        zpl_json_stream s;
+        zpl_u8 err = zpl_json_stream_init(&s, mem_alloc, unit_json_trace, &trace);
+
+        for (zpl_isize i = 0; t[i] && !err; ++i) {
+            err = zpl_json_stream_feed(&s, t + i, 1);
+        }
+        if (!err) err = zpl_json_stream_finish(&s);
+
+        EQUALS(err, ZPL_JSON_ERROR_NONE);
+        STREQUALS(trace, "{a=[1 2.50 'x\\\"y' ]b={c=true }d=-3 }[null ]");
+        EQUALS(s.line, 3);
+        zpl_json_stream_free(&s);
+    });
+
+    IT("streams cfg mode documents and reports errors", {
+        const char *t = "foo = \"bar\"\nbaz = 123\n";
+        zpl_string trace = zpl_string_make(mem_alloc, "");
+        zpl_json_stream s;
+        zpl_json_stream_init(&s, mem_alloc, unit_json_trace, &trace);
+        zpl_json_stream_feed(&s, t, zpl_strlen(t));
+        EQUALS(zpl_json_stream_finish(&s), ZPL_JSON_ERROR_NONE);
+        STREQUALS(trace, "{foo='bar' baz=123 }");
+        zpl_json_stream_free(&s);
+
+        zpl_json_stream_init(&s, mem_alloc, unit_json_trace, &trace);
+        zpl_json_stream_feed(&s, "{ \"a\": [1, 2", 12);
+        EQUALS(zpl_json_stream_finish(&s), ZPL_JSON_ERROR_UNEXPECTED_END_OF_INPUT);
+        zpl_json_stream_free(&s);
+
+        zpl_json_stream_init(&s, mem_alloc, unit_json_trace, &trace);
+        EQUALS(zpl_json_stream_feed(&s, "[1, 2}", 6), ZPL_JSON_ERROR_OBJECT_END_PAIR_MISMATCHED);
+        zpl_json_stream_free(&s);
+    });
+
+    IT("parses newline-delimited records in order on the job system", {
+        zpl_string text = zpl_string_make(zpl_heap(), "");
+        for (zpl_isize i = 0; i < 20000; ++i) {
+            text = zpl_string_append_fmt(text, "{\"id\": %td, \"tags\": [\"a\", \"b\"]}\r\n%s", i, (i % 7) ? "" : "\n");
+        }
+        zpl_string copy = zpl_string_duplicate(zpl_heap(), text);
+
+        zpl_jobs_system pool;
+        zpl_jobs_init(&pool, zpl_heap(), 3);
+        zpl_json_lines lines;
+        EQUALS(zpl_json_lines_parse(&lines, text, zpl_string_length(text), &pool, zpl_heap()), ZPL_JSON_ERROR_NONE);
+        EQUALS(lines.count, 20000);
+        EQUALS(lines.error_record, -1);
+
+        zpl_isize in_order = 0;
+        for (zpl_isize i = 0; i < lines.count; ++i) {
+            zpl_adt_node *id = zpl_adt_find(&lines.records[i], "id", false);
+            if (id && id->integer == i && zpl_array_count(zpl_adt_find(&lines.records[i], "tags", false)->nodes) == 2) ++in_order;
+        }
+        EQUALS(in_order, 20000);
+        zpl_json_lines_free(&lines);
+
+        *cast(char *)zpl_strchr(copy + zpl_string_length(copy) / 2, ':') = ' ';
+        zpl_json_lines_parse(&lines, copy, zpl_string_length(copy), NULL, zpl_heap());
+        NEQUALS(lines.error, ZPL_JSON_ERROR_NONE);
+        EQUALS(lines.count, 20000);
+        GREATER(lines.error_record, 9000);
+        LESSER(lines.error_record, 11000);
+        zpl_json_lines_free(&lines);
+        zpl_jobs_free(&pool);
+        zpl_string_free(text);
+        zpl_string_free(copy);
+    });
+
+    IT("reads cfg mode documents through a cursor", {
+        const char *t = "foo = \"bar\"\nbaz = 123\n\n";
+        zpl_json_cursor root = zpl_json_cursor_make(t, zpl_strlen(t));
+        zpl_json_cursor c = zpl_json_cursor_find(&root, "baz");
+
+        EQUALS(zpl_json_cursor_type(&root), ZPL_ADT_TYPE_OBJECT);
+        EQUALS(zpl_json_cursor_count(&root), 2);
+        EQUALS(zpl_json_cursor_integer(&c, 0), 123);
+    });
+
+    IT("stops a cursor on a stray slash instead of looping", {
+        const char *t = "{ a: [1, /x, 2], b: / }";
+        zpl_json_cursor root = zpl_json_cursor_make(t, zpl_strlen(t));
+        zpl_json_cursor a = zpl_json_cursor_find(&root, "a");
+        zpl_json_cursor c = zpl_json_cursor_at(&a, 2);
+
+        EQUALS(zpl_json_cursor_count(&a), 2);
+        EQUALS(zpl_json_cursor_valid(&c), false);
+        c = zpl_json_cursor_query(&root, "a/9");
+        EQUALS(zpl_json_cursor_valid(&c), false);
+        c = zpl_json_cursor_find(&root, "missing");
+        EQUALS(zpl_json_cursor_valid(&c), false);
+    });
 });
 
 #undef __PARSE
@@ -1,3 +1,23 @@
+static zpl_isize unit__slab_remote_free(zpl_thread *thread) {
+    void **blocks = cast(void **)thread->user_data;
+    zpl_slab *slab = cast(zpl_slab *)blocks[0];
+    for (int i = 1; i < 65; ++i) zpl_free(zpl_slab_allocator(slab), blocks[i]);
+    zpl_slab_thread_detach(slab);
+    return 0;
+}
+
+static zpl_isize unit__memory_unframed_bprintf(zpl_thread *thread) {
+    zpl_unused(thread);
+    char *first = zpl_bprintf("%d", 1);
+    char *second = zpl_bprintf("%d", 2);
+    zpl_arena_snapshot mark = zpl_temp_snapshot_begin();
+    zpl_b32 reused = first == second && !zpl_strcmp(second, "2") && mark.arena && mark.arena->total_allocated == 0;
+    zpl_temp_snapshot_end(mark);
+
+    zpl_temp_reset();
+    return reused && zpl_temp_framed() && zpl_bprintf("%d", 3) != second;
+}
+
 MODULE(memory, {
     IT("should be supporting plain memory arena", {
         zpl_arena arena = {0};
@@ -52,4 +72,309 @@ MODULE(memory, {
 
         zpl_arena_free(&arena);
     });
+
+    IT("should resize the top arena allocation in place", {
+        zpl_arena arena = {0};
+        zpl_arena_init_from_allocator(&arena, zpl_heap(), 1024);
+        zpl_allocator a = zpl_arena_allocator(&arena);
+
+        char *buffer1 = (char *)zpl_alloc(a, 128);
+        char *buffer2 = (char *)zpl_alloc(a, 128);
+        char *grown = (char *)zpl_resize(a, buffer2, 128, 512);
+        char *moved = (char *)zpl_resize(a, buffer1, 128, 256);
+
+        EQUALS(grown, buffer2);
+        NEQUALS(moved, buffer1);
+        EQUALS(arena.total_allocated, 128+512+256);
+
+        zpl_arena_free(&arena);
+    });
+
+    IT("should not shrink arena allocations below an open snapshot", {
+        zpl_arena arena = {0};
+        zpl_arena_init_from_allocator(&arena, zpl_heap(), 1024);
+        zpl_allocator a = zpl_arena_allocator(&arena);
+
+        char *before = (char *)zpl_alloc(a, 256);
+        zpl_arena_snapshot snapshot = zpl_arena_snapshot_begin(&arena);
+        EQUALS((char *)zpl_resize(a, before, 256, 16), before);
+        EQUALS(arena.total_allocated, 256);
+
+        char *inside = (char *)zpl_alloc(a, 256);
+        EQUALS((char *)zpl_resize(a, inside, 256, 16), inside);
+        EQUALS(arena.total_allocated, 256+16);
+        zpl_arena_snapshot_end(snapshot);
+
+        EQUALS(arena.total_allocated, 256);
+        EQUALS((char *)zpl_resize(a, before, 256, 16), before);
+        EQUALS(arena.total_allocated, 16);
+        zpl_arena_free(&arena);
+    });
+
+    IT("should grow an array on top of an arena in place", {
+        zpl_arena arena = {0};
+        zpl_array(zpl_u32) values = NULL;
+        zpl_b32 kept = true;
+        zpl_arena_init_from_allocator(&arena, zpl_heap(), zpl_kilobytes(64));
+        zpl_array_init(values, zpl_arena_allocator(&arena));
+        zpl_u32 *first = values;
+
+        for (zpl_u32 i = 0; i < 1000; ++i) zpl_array_append(values, i);
+        for (zpl_u32 i = 0; i < 1000; ++i) kept &= (values[i] == i);
+
+        EQUALS(values, first);
+        EQUALS(kept, true);
+        zpl_arena_free(&arena);
+    });
+
+    IT("should keep array contents when the heap resizes it", {
+        zpl_array(zpl_u64) values = NULL;
+        zpl_b32 kept = true;
+        zpl_array_init(values, zpl_heap());
+
+        for (zpl_u64 i = 0; i < 100000; ++i) zpl_array_append(values, i);
+        for (zpl_u64 i = 0; i < 100000; ++i) kept &= (values[i] == i);
+        zpl_array_set_capacity(values, 10);
+
+        EQUALS(kept, true);
+        EQUALS(zpl_array_count(values), 10);
+        EQUALS(values[9], 9);
+        zpl_array_free(values);
+    });
+
+    IT("should grow a virtual memory arena past its reservation", {
+        zpl_arena arena = {0};
+        zpl_arena_init_from_vm(&arena, zpl_megabytes(1));
+        zpl_allocator a = zpl_arena_allocator(&arena);
+        void *first_block = arena.vm_block;
+
+        char *buffer1 = (char *)zpl_alloc(a, zpl_kilobytes(300));
+        buffer1[zpl_kilobytes(300) - 1] = 1;
+        char *grown = (char *)zpl_resize(a, buffer1, zpl_kilobytes(300), zpl_kilobytes(900));
+        grown[zpl_kilobytes(900) - 1] = 2;
+        EQUALS(grown, buffer1);
+        EQUALS(arena.vm_block, first_block);
+
+        zpl_arena_snapshot snapshot = zpl_arena_snapshot_begin(&arena);
+        char *buffer2 = (char *)zpl_alloc(a, zpl_megabytes(3));
+        NEQUALS(buffer2, NULL);
+        NEQUALS(arena.vm_block, first_block);
+        buffer2[zpl_megabytes(3) - 1] = 3;
+        zpl_arena_snapshot_end(snapshot);
+
+        EQUALS(arena.vm_block, first_block);
+        EQUALS(arena.total_allocated, zpl_kilobytes(900));
+        EQUALS(grown[zpl_kilobytes(900) - 1], 2);
+
+        zpl_free_all(a);
+        EQUALS(arena.total_allocated, 0);
+        EQUALS(((char *)zpl_alloc(a, 16) == buffer1), true);
+
+        zpl_arena_free(&arena);
+        EQUALS(arena.vm_block, NULL);
+    });
+
+    IT("should reuse slab blocks freed on the same thread", {
+        zpl_slab slab;
+        zpl_slab_init(&slab, zpl_heap());
+        zpl_allocator a = zpl_slab_allocator(&slab);
+
+        char *small = (char *)zpl_alloc(a, 20);
+        char *other = (char *)zpl_alloc(a, 20);
+        EQUALS((other - small), 32);
+        zpl_free(a, small);
+        EQUALS((char *)zpl_alloc(a, 30), small);
+
+        char *aligned = (char *)zpl_alloc_align(a, 100, 64);
+        EQUALS((cast(zpl_uintptr)aligned & 63), 0);
+        EQUALS((char *)zpl_resize(a, aligned, 100, 128), aligned);
+
+        char *large = (char *)zpl_alloc(a, zpl_kilobytes(100));
+        large[zpl_kilobytes(100) - 1] = 1;
+        zpl_free(a, large);
+
+        zpl_slab_free(&slab);
+    });
+
+    IT("should not over-align slab allocations above the size classes", {
+        zpl_arena arena;
+        zpl_slab slab;
+        zpl_arena_init_from_allocator(&arena, zpl_heap(), zpl_kilobytes(40));
+        zpl_slab_init(&slab, zpl_arena_allocator(&arena));
+        zpl_allocator a = zpl_slab_allocator(&slab);
+
+        char *first = (char *)zpl_alloc(a, 9000);
+        char *second = (char *)zpl_alloc_align(a, 9000, 64);
+        NEQUALS(first, NULL);
+        NEQUALS(second, NULL);
+        EQUALS((cast(zpl_uintptr)second & 63), 0);
+        LESSER(arena.total_allocated, 9000 * 2 + 256);
+
+        zpl_memset(first, 7, 9000);
+        first = (char *)zpl_resize(a, first, 9000, 12000);
+        EQUALS(first[8999], 7);
+        zpl_free(a, first);
+        zpl_free(a, second);
+
+        zpl_slab_free(&slab);
+        zpl_arena_free(&arena);
+    });
+
+    IT("should return slab blocks freed by other threads to their owner", {
+        zpl_slab slab;
+        zpl_thread thread;
+        void *blocks[65];
+        zpl_b32 reused = true;
+        zpl_slab_init(&slab, zpl_heap());
+        zpl_allocator a = zpl_slab_allocator(&slab);
+
+        blocks[0] = &slab;
+        for (int i = 1; i < 65; ++i) blocks[i] = zpl_alloc(a, 200);
+
+        zpl_thread_init(&thread);
+        zpl_thread_start(&thread, unit__slab_remote_free, blocks);
+        zpl_thread_destroy(&thread);
+
+        // NOTE: the remote list hands the blocks back in reverse order
+        for (int i = 64; i > 0; --i) reused &= (zpl_alloc(a, 200) == blocks[i]);
+        EQUALS(reused, true);
+
+        zpl_slab_free(&slab);
+    });
+
+    IT("should leave uninitialized allocations alone and clear regular ones", {
+        zpl_u8 buffer[256];
+        zpl_arena arena;
+        zpl_arena_init_from_memory(&arena, buffer, zpl_size_of(buffer));
+        zpl_allocator a = zpl_arena_allocator(&arena);
+
+        zpl_u8 *dirty = (zpl_u8 *)zpl_alloc_uninit(a, 64);
+        zpl_memset(dirty, 0xAB, 64);
+        zpl_free_all(a);
+        EQUALS(((zpl_u8 *)zpl_alloc_uninit(a, 64))[63], 0xAB);
+        zpl_free_all(a);
+        EQUALS(((zpl_u8 *)zpl_alloc(a, 64))[63], 0);
+
+        zpl_u8 *grown = (zpl_u8 *)zpl_alloc_uninit(zpl_heap(), 32);
+        zpl_memset(grown, 0xCD, 32);
+        grown = (zpl_u8 *)zpl_default_resize_align(zpl_heap(), grown, 32, 4096, ZPL_DEFAULT_MEMORY_ALIGNMENT);
+        EQUALS(grown[31], 0xCD);
+        EQUALS(grown[32], 0);
+        EQUALS(grown[4095], 0);
+        zpl_mfree(grown);
+
+        zpl_u8 moved_buffer[256];
+        zpl_memset(moved_buffer, 0xEE, zpl_size_of(moved_buffer));
+        zpl_arena_init_from_memory(&arena, moved_buffer, zpl_size_of(moved_buffer));
+        zpl_u8 *moved = (zpl_u8 *)zpl_alloc_uninit(a, 32);
+        zpl_alloc_uninit(a, 16);
+        moved = (zpl_u8 *)zpl_resize_uninit(a, moved, 32, 64);
+        EQUALS(moved[63], 0xEE);
+        moved = (zpl_u8 *)zpl_resize(a, moved, 64, 96);
+        EQUALS(moved[95], 0);
+
+        zpl_u8 *zeroed = (zpl_u8 *)zpl_malloc(zpl_megabytes(1));
+        EQUALS(zeroed[0], 0);
+        EQUALS(zeroed[zpl_megabytes(1) - 1], 0);
+        zpl_mfree(zeroed);
+    });
+
+    IT("should attribute allocations to profiler scopes", {
+        zpl_alloc_profiler prof;
+        zpl_alloc_profiler_init(&prof, zpl_heap());
+        zpl_allocator a = zpl_alloc_profiler_allocator(&prof);
+
+        zpl_alloc_profiler_push("ingest");
+        void *rows = zpl_alloc(a, 100);
+        zpl_alloc_profiler_push("row");
+        void *cell = zpl_alloc(a, 10);
+        void *other = zpl_alloc_align(a, 20, 64);
+        EQUALS((cast(zpl_uintptr)other & 63), 0);
+        zpl_alloc_profiler_pop();
+        rows = zpl_resize(a, rows, 100, 4000);
+        other = zpl_resize(a, other, 20, 40);
+        zpl_alloc_profiler_pop();
+        void *loose = zpl_alloc(a, 1);
+
+        EQUALS(zpl_array_count(prof.sites), 3);
+        EQUALS(prof.sites[1].alloc_count, 1);
+        EQUALS(prof.sites[1].resize_count, 1);
+        EQUALS(prof.sites[1].live_bytes, 4000);
+        EQUALS(prof.sites[2].alloc_count, 2);
+        EQUALS(prof.sites[2].resize_count, 1);
+        EQUALS(prof.sites[2].live_bytes, 50);
+        EQUALS(prof.sites[2].histogram[0], 1);
+        EQUALS(prof.sites[2].histogram[1], 1);
+        EQUALS(prof.sites[0].alloc_count, 1);
+        EQUALS(prof.live_bytes, 4051);
+
+        // NOTE: the heap ignores free_all, every block is still live
+        zpl_free_all(a);
+        EQUALS(prof.live_bytes, 4051);
+        EQUALS(prof.sites[1].live_bytes, 4000);
+
+        zpl_free(a, cell);
+        zpl_free(a, other);
+        zpl_free(a, rows);
+        zpl_free(a, loose);
+        EQUALS(prof.live_bytes, 0);
+        EQUALS(prof.peak_bytes, 4051);
+        EQUALS(prof.sites[2].free_count, 2);
+
+        zpl_file out;
+        zpl_isize len;
+        zpl_file_stream_new(&out, zpl_heap());
+        zpl_alloc_profiler_write_folded(&prof, &out, ZPL_ALLOC_PROFILER_COUNT);
+        char *folded = (char *)zpl_file_stream_buf(&out, &len);
+        STREQUALS(zpl_bprintf("%.*s", (int)len, folded), "[root] 1\ningest 1\ningest;row 2\n");
+        zpl_file_close(&out);
+
+        zpl_alloc_profiler_free(&prof);
+    });
+
+    IT("should keep temporary memory valid across one frame boundary", {
+        zpl_temp_reset();
+        char *first = zpl_bprintf("%s %d", "frame", 1);
+        char *second = zpl_bprintf("%s %d", "frame", 2);
+        STREQUALS(first, "frame 1");
+        STREQUALS(second, "frame 2");
+        EQUALS((second - first), zpl_align_forward_i64(8, ZPL_DEFAULT_MEMORY_ALIGNMENT));
+
+        zpl_temp_reset();
+        char *next = zpl_bprintf("next");
+        STREQUALS(first, "frame 1");
+        NEQUALS(next, first);
+
+        zpl_temp_reset();
+        EQUALS(zpl_bprintf("again"), first);
+
+        zpl_arena_snapshot scratch = zpl_temp_snapshot_begin();
+        void *big = zpl_alloc(zpl_temp_allocator(), zpl_megabytes(100));
+        NEQUALS(big, NULL);
+        zpl_temp_snapshot_end(scratch);
+
+        zpl_string str = zpl_string_sprintf_buf(zpl_temp_allocator(), "%d-%d", 4, 2);
+        STREQUALS(str, "4-2");
+        str = zpl_string_sprintf_buf(zpl_heap(), "%s", str);
+        STREQUALS(str, "4-2");
+        zpl_string_free(str);
+
+        char *text;
+        zpl_string large = zpl_string_make_reserve(zpl_heap(), 3000);
+        for (int i = 0; i < 3000; ++i) large = zpl_string_appendc(large, "x");
+        EQUALS(zpl_asprintf(zpl_heap(), &text, "%s!", large), 3002);
+        EQUALS(zpl_strlen(text), 3001);
+        EQUALS(zpl_strlen(zpl_bprintf("%s", large)), 3000);
+        zpl_free(zpl_heap(), text);
+        zpl_string_free(large);
+    });
+
+    IT("should keep zpl_bprintf off temporary memory on threads without frames", {
+        zpl_thread thread;
+        zpl_thread_init(&thread);
+        zpl_thread_start(&thread, unit__memory_unframed_bprintf, NULL);
+        zpl_thread_join(&thread);
+        EQUALS(thread.return_value, 1);
+        zpl_thread_destroy(&thread);
+    });
 });
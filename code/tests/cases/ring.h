@@ -0,0 +1,215 @@
+ZPL_RING(static inline, unit_ring_, zpl_u64);
+ZPL_SPSC_RING(static inline, unit_spsc, unit_spsc_, zpl_u64);
+ZPL_MPMC_RING(static inline, unit_mpmc, unit_mpmc_, zpl_u64);
+
+#define UNIT__RING_ITEMS 100000
+
+static zpl_isize unit__spsc_producer(zpl_thread *thread) {
+    unit_spsc *r = cast(unit_spsc *)thread->user_data;
+    zpl_u64 batch[7];
+    zpl_u64 next = 0;
+    while (next < UNIT__RING_ITEMS) {
+        if (next % 2) {
+            while (!unit_spsc_push(r, next)) zpl_yield();
+            ++next;
+        } else {
+            zpl_isize n = zpl_min(7, UNIT__RING_ITEMS - next), pushed = 0;
+            for (zpl_isize i = 0; i < n; ++i) batch[i] = next + i;
+            while (pushed < n) {
+                zpl_isize k = unit_spsc_push_batch(r, batch + pushed, n - pushed);
+                if (!k) zpl_yield();
+                pushed += k;
+            }
+            next += n;
+        }
+    }
+    return 0;
+}
+
+static zpl_isize unit__mpmc_producer(zpl_thread *thread) {
+    unit_mpmc *r = cast(unit_mpmc *)thread->user_data;
+    zpl_u64 batch[5];
+    for (zpl_u64 i = 1; i <= UNIT__RING_ITEMS; i += 5) {
+        zpl_isize pushed = 0;
+        for (zpl_isize j = 0; j < 5; ++j) batch[j] = i + j;
+        while (pushed < 5) {
+            zpl_isize k = (i % 2) ? unit_mpmc_push_batch(r, batch + pushed, 5 - pushed)
+                                  : unit_mpmc_push(r, batch[pushed]);
+            if (!k) zpl_yield();
+            pushed += k;
+        }
+    }
+    return 0;
+}
+
+zpl_global zpl_atomic64 unit__mpmc_sum;
+zpl_global zpl_atomic64 unit__mpmc_popped;
+
+static zpl_isize unit__mpmc_consumer(zpl_thread *thread) {
+    unit_mpmc *r = cast(unit_mpmc *)thread->user_data;
+    zpl_u64 batch[3];
+    zpl_i64 sum = 0;
+    while (zpl_atomic64_load(&unit__mpmc_popped) < 4 * UNIT__RING_ITEMS) {
+        zpl_isize n = unit_mpmc_pop_batch(r, batch, 3);
+        if (!n) { zpl_yield(); continue; }
+        for (zpl_isize i = 0; i < n; ++i) sum += batch[i];
+        zpl_atomic64_fetch_add(&unit__mpmc_popped, n);
+    }
+    zpl_atomic64_fetch_add(&unit__mpmc_sum, sum);
+    return 0;
+}
+
+MODULE(ring, {
+    IT("drains the requested number of values into an array", {
+        unit_ring_zpl_u64 r = {0};
+        zpl_array(zpl_u64) vals;
+        unit_ring_init(&r, zpl_heap(), 8);
+        for (zpl_u64 i = 0; i < 5; ++i) unit_ring_append(&r, i);
+
+        vals = unit_ring_get_array(&r, 3, zpl_heap());
+        EQUALS(zpl_array_count(vals), 3);
+        EQUALS(vals[2], 2);
+        zpl_array_free(vals);
+
+        vals = unit_ring_get_array(&r, 10, zpl_heap());
+        EQUALS(zpl_array_count(vals), 2);
+        EQUALS(vals[1], 4);
+        zpl_array_free(vals);
+
+        unit_ring_free(&r);
+    });
+
+    IT("exposes queued values as two slices around the wrap point", {
+        unit_ring_zpl_u64 r = {0};
+        zpl_u64 *a, *b;
+        zpl_usize na, nb;
+        unit_ring_init(&r, zpl_heap(), 7);
+        for (zpl_u64 i = 0; i < 6; ++i) unit_ring_append(&r, i);
+        EQUALS(unit_ring_get_span(&r, 4, &a, &na, &b, &nb), 4);
+        unit_ring_commit_span(&r, 4);
+        for (zpl_u64 i = 6; i < 11; ++i) unit_ring_append(&r, i);
+
+        EQUALS(unit_ring_get_span(&r, 100, &a, &na, &b, &nb), 7);
+        EQUALS(na, 4);
+        EQUALS(a[0], 4);
+        EQUALS(a[3], 7);
+        EQUALS(nb, 3);
+        EQUALS(b[0], 8);
+        EQUALS(b[2], 10);
+
+        EQUALS(unit_ring_get_span(&r, 2, &a, &na, &b, &nb), 2);
+        EQUALS(nb, 0);
+        unit_ring_commit_span(&r, 5);
+        EQUALS(*unit_ring_get(&r), 9);
+        unit_ring_commit_span(&r, 1);
+        EQUALS(unit_ring_empty(&r), true);
+        EQUALS(unit_ring_get_span(&r, 100, &a, &na, &b, &nb), 0);
+        EQUALS(a, NULL);
+
+        unit_ring_free(&r);
+    });
+
+    IT("rounds the lock-free ring capacity to a power of two", {
+        unit_spsc s = {0};
+        unit_mpmc m = {0};
+        unit_spsc_init(&s, zpl_heap(), 5);
+        unit_mpmc_init(&m, zpl_heap(), 5);
+
+        EQUALS(s.mask, 7);
+        EQUALS(m.mask, 7);
+
+        unit_spsc_free(&s);
+        unit_mpmc_free(&m);
+    });
+
+    IT("fills and drains the spsc ring across the wrap point", {
+        unit_spsc r = {0};
+        zpl_u64 in[6] = { 1, 2, 3, 4, 5, 6 }, out[8] = {0}, v = 0;
+        unit_spsc_init(&r, zpl_heap(), 8);
+
+        EQUALS(unit_spsc_push_batch(&r, in, 6), 6);
+        EQUALS(unit_spsc_pop_batch(&r, out, 5), 5);
+        EQUALS(unit_spsc_push_batch(&r, in, 6), 6);
+        EQUALS(unit_spsc_push_batch(&r, in, 6), 1);
+        EQUALS(unit_spsc_push(&r, 9), false);
+        EQUALS(unit_spsc_count(&r), 8);
+
+        EQUALS(unit_spsc_pop(&r, &v), true);
+        EQUALS(v, 6);
+        EQUALS(unit_spsc_pop_batch(&r, out, 8), 7);
+        EQUALS(out[0], 1);
+        EQUALS(out[5], 6);
+        EQUALS(out[6], 1);
+        EQUALS(unit_spsc_pop(&r, &v), false);
+
+        unit_spsc_free(&r);
+    });
+
+    IT("fills and drains the mpmc ring across the wrap point", {
+        unit_mpmc r = {0};
+        zpl_u64 in[6] = { 1, 2, 3, 4, 5, 6 }, out[8] = {0}, v = 0;
+        unit_mpmc_init(&r, zpl_heap(), 8);
+
+        EQUALS(unit_mpmc_push_batch(&r, in, 6), 6);
+        EQUALS(unit_mpmc_pop_batch(&r, out, 5), 5);
+        EQUALS(unit_mpmc_push_batch(&r, in, 6), 6);
+        EQUALS(unit_mpmc_push_batch(&r, in, 6), 1);
+        EQUALS(unit_mpmc_push(&r, 9), false);
+        EQUALS(unit_mpmc_count(&r), 8);
+
+        EQUALS(unit_mpmc_pop(&r, &v), true);
+        EQUALS(v, 6);
+        EQUALS(unit_mpmc_pop_batch(&r, out, 8), 7);
+        EQUALS(out[0], 1);
+        EQUALS(out[5], 6);
+        EQUALS(out[6], 1);
+        EQUALS(unit_mpmc_pop(&r, &v), false);
+
+        unit_mpmc_free(&r);
+    });
+
+    IT("keeps spsc values in order between two threads", {
+        unit_spsc r = {0};
+        zpl_thread producer;
+        zpl_u64 expected = 0, batch[5];
+        zpl_b32 ordered = true;
+        unit_spsc_init(&r, zpl_heap(), 64);
+
+        zpl_thread_init(&producer);
+        zpl_thread_start(&producer, unit__spsc_producer, &r);
+        while (expected < UNIT__RING_ITEMS) {
+            zpl_isize n = unit_spsc_pop_batch(&r, batch, 5);
+            if (!n) zpl_yield();
+            for (zpl_isize i = 0; i < n; ++i) ordered &= (batch[i] == expected++);
+        }
+        zpl_thread_destroy(&producer);
+        unit_spsc_free(&r);
+
+        EQUALS(ordered, true);
+        EQUALS(expected, UNIT__RING_ITEMS);
+    });
+
+    IT("delivers every mpmc value exactly once", {
+        unit_mpmc r = {0};
+        zpl_thread producers[4], consumers[4];
+        zpl_i64 expected = 4 * (cast(zpl_i64)UNIT__RING_ITEMS * (UNIT__RING_ITEMS + 1) / 2);
+        unit_mpmc_init(&r, zpl_heap(), 128);
+        zpl_atomic64_store(&unit__mpmc_sum, 0);
+        zpl_atomic64_store(&unit__mpmc_popped, 0);
+
+        for (int i = 0; i < 4; ++i) {
+            zpl_thread_init(&consumers[i]);
+            zpl_thread_start(&consumers[i], unit__mpmc_consumer, &r);
+            zpl_thread_init(&producers[i]);
+            zpl_thread_start(&producers[i], unit__mpmc_producer, &r);
+        }
+        for (int i = 0; i < 4; ++i) {
+            zpl_thread_destroy(&producers[i]);
+            zpl_thread_destroy(&consumers[i]);
+        }
+        unit_mpmc_free(&r);
+
+        EQUALS(zpl_atomic64_load(&unit__mpmc_popped), 4 * UNIT__RING_ITEMS);
+        EQUALS(zpl_atomic64_load(&unit__mpmc_sum), expected);
+    });
+});
@@ -1,4 +1,20 @@
 ZPL_TABLE(static inline, unit_table, unit_table_, zpl_i32);
+ZPL_FLAT_TABLE(static inline, unit_flat, unit_flat_, zpl_i32);
+ZPL_STR_TABLE(static inline, unit_str, unit_str_, zpl_i32);
+ZPL_CONC_TABLE(static inline, unit_conc, unit_conc_, zpl_u64);
+ZPL_SLOT_MAP(static inline, unit_slots, unit_slots_, zpl_i32);
+
+static zpl_isize unit__conc_writer(zpl_thread *thread) {
+    unit_conc *t = cast(unit_conc *)thread->user_data;
+    zpl_u64 base = cast(zpl_u64)zpl_thread_current_id() << 32;
+    for (zpl_u64 i = 0; i < 2000; ++i) {
+        unit_conc_set(t, base | i, i);
+    }
+    for (zpl_u64 i = 0; i < 2000; i += 2) {
+        unit_conc_remove(t, base | i);
+    }
+    return 0;
+}
 
 MODULE(table, {
     IT("should able to do basic table operations", {
@@ -47,4 +63,248 @@ MODULE(table, {
 
         unit_table_destroy(&t1);
     });
+
+    IT("should keep chains intact when removing entries", {
+        unit_table t1 = {0};
+        unit_table_init(&t1, zpl_heap());
+
+        for (zpl_i32 i = 0; i < 1000; ++i) {
+            unit_table_set(&t1, i, i);
+        }
+        for (zpl_i32 i = 0; i < 1000; i += 3) {
+            unit_table_remove(&t1, i);
+        }
+        unit_table_remove_entry(&t1, unit_table_slot(&t1, 1));
+
+        EQUALS(zpl_array_count(t1.entries), 665);
+        for (zpl_i32 i = 0; i < 1000; ++i) {
+            zpl_i32 *v = unit_table_get(&t1, i);
+            if (i % 3 && i != 1) {
+                NEQUALS(v, NULL);
+                EQUALS(*v, i);
+            } else {
+                EQUALS(v, NULL);
+            }
+        }
+
+        unit_table_destroy(&t1);
+    });
+
+    IT("should not rehash a reserved table during inserts", {
+        unit_table t1 = {0};
+        zpl_isize *hashes;
+        unit_table_init(&t1, zpl_heap());
+        unit_table_reserve(&t1, 1000);
+        hashes = t1.hashes;
+
+        for (zpl_i32 i = 0; i < 1000; ++i) {
+            unit_table_set(&t1, i, i);
+        }
+
+        EQUALS(t1.hashes, hashes);
+        unit_table_destroy(&t1);
+    });
+
+    IT("should keep flat table lookups intact across removals", {
+        unit_flat t1 = {0};
+        unit_flat_init(&t1, zpl_heap());
+
+        for (zpl_i32 i = 0; i < 5000; ++i) {
+            unit_flat_set(&t1, cast(zpl_u64)i * 977, i);
+        }
+        EQUALS(t1.count, 5000);
+
+        for (zpl_i32 i = 0; i < 5000; i += 2) {
+            unit_flat_remove(&t1, cast(zpl_u64)i * 977);
+        }
+        unit_flat_remove(&t1, 12345678);
+        EQUALS(t1.count, 2500);
+
+        for (zpl_i32 i = 0; i < 5000; ++i) {
+            zpl_i32 *v = unit_flat_get(&t1, cast(zpl_u64)i * 977);
+            if (i % 2) {
+                NEQUALS(v, NULL);
+                EQUALS(*v, i);
+            } else {
+                EQUALS(v, NULL);
+            }
+        }
+
+        unit_flat_set(&t1, 977, 42);
+        EQUALS(*unit_flat_get(&t1, 977), 42);
+        EQUALS(t1.count, 2500);
+
+        unit_flat_clear(&t1);
+        EQUALS(t1.count, 0);
+        EQUALS(unit_flat_get(&t1, 977), NULL);
+
+        unit_flat_destroy(&t1);
+    });
+
+    IT("should not grow a reserved flat table during inserts", {
+        unit_flat t1 = {0};
+        zpl_isize capacity;
+        unit_flat_init(&t1, zpl_heap());
+        unit_flat_reserve(&t1, 1000);
+        capacity = t1.capacity;
+
+        for (zpl_i32 i = 0; i < 1000; ++i) {
+            unit_flat_set(&t1, i, i);
+        }
+
+        EQUALS(t1.capacity, capacity);
+        unit_flat_destroy(&t1);
+    });
+
+    IT("should store string keys by value", {
+        unit_str t1 = {0};
+        char buf[32];
+        unit_str_init(&t1, zpl_heap());
+
+        for (zpl_i32 i = 0; i < 2000; ++i) {
+            zpl_isize len = zpl_snprintf(buf, zpl_size_of(buf), "field_%d", i) - 1;
+            unit_str_set(&t1, buf, len, i);
+        }
+        zpl_strcpy(buf, "overwritten");
+
+        EQUALS(t1.count, 2000);
+        EQUALS(*unit_str_get(&t1, "field_0", -1), 0);
+        EQUALS(*unit_str_get(&t1, "field_1999", -1), 1999);
+        EQUALS(*unit_str_get(&t1, "field_42xyz", 8), 42);
+        EQUALS(unit_str_get(&t1, "field_2000", -1), NULL);
+
+        unit_str_remove(&t1, "field_7", -1);
+        EQUALS(unit_str_get(&t1, "field_7", -1), NULL);
+        EQUALS(*unit_str_get(&t1, "field_8", -1), 8);
+        EQUALS(t1.count, 1999);
+
+        unit_str_destroy(&t1);
+    });
+
+    IT("should intern strings to a single copy", {
+        zpl_strintern s = {0};
+        char name[] = "width";
+        char const *a, *b;
+        zpl_strintern_init(&s, zpl_heap());
+
+        a = zpl_strintern_add(&s, name, -1);
+        name[0] = 'W';
+        b = zpl_strintern_add(&s, "width", 5);
+
+        EQUALS(a, b);
+        STREQUALS(a, "width");
+        NEQUALS(zpl_strintern_add(&s, name, -1), a);
+        EQUALS(zpl_strintern_get(&s, "Width", -1), zpl_strintern_add(&s, "Width", -1));
+        EQUALS(zpl_strintern_get(&s, "height", -1), NULL);
+        EQUALS(s.count, 2);
+
+        zpl_strintern_destroy(&s);
+    });
+
+    IT("should leave the interner untouched when a key cannot be copied", {
+        zpl_strintern s = {0};
+        zpl_arena arena = {0};
+        char long_key[ZPL_STR_TABLE_KEY_BLOCK];
+        zpl_arena_init_from_allocator(&arena, zpl_heap(), 5000);
+        zpl_strintern_init(&s, zpl_arena_allocator(&arena));
+        zpl_memset(long_key, 'k', zpl_size_of(long_key));
+
+        NEQUALS(zpl_strintern_add(&s, "width", -1), NULL);
+        EQUALS(zpl_strintern_add(&s, long_key, zpl_size_of(long_key)), NULL);
+        EQUALS(zpl_strintern_get(&s, long_key, zpl_size_of(long_key)), NULL);
+        EQUALS(s.count, 1);
+        STREQUALS(zpl_strintern_get(&s, "width", -1), "width");
+
+        zpl_arena_free(&arena);
+    });
+
+    IT("should stay consistent with concurrent writers and readers", {
+        unit_conc t1 = {0};
+        zpl_thread writers[4];
+        zpl_u64 value;
+        unit_conc_init(&t1, zpl_heap());
+
+        for (zpl_u64 i = 0; i < 1000; ++i) {
+            unit_conc_set(&t1, i, i * 3);
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            zpl_thread_init(&writers[i]);
+            zpl_thread_start(&writers[i], unit__conc_writer, &t1);
+        }
+        for (int round = 0; round < 20; ++round) {
+            for (zpl_u64 i = 0; i < 1000; ++i) {
+                value = 0;
+                EQUALS(unit_conc_get(&t1, i, &value), true);
+                EQUALS(value, i * 3);
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            zpl_thread_destroy(&writers[i]);
+        }
+
+        EQUALS(unit_conc_count(&t1), 1000 + 4 * 1000);
+        EQUALS(unit_conc_get(&t1, 1000, &value), false);
+        EQUALS(unit_conc_remove(&t1, 5), true);
+        EQUALS(unit_conc_remove(&t1, 5), false);
+
+        unit_conc_destroy(&t1);
+    });
+
+    IT("should keep slot map handles stable across removals", {
+        unit_slots m = {0};
+        zpl_u64 handles[100];
+        unit_slots_init(&m, zpl_heap());
+
+        for (int i = 0; i < 100; ++i) handles[i] = unit_slots_insert(&m, i);
+        EQUALS(unit_slots_get(&m, 0), NULL);
+
+        for (int i = 0; i < 100; i += 3) EQUALS(unit_slots_remove(&m, handles[i]), true);
+        EQUALS(unit_slots_remove(&m, handles[0]), false);
+        EQUALS(unit_slots_count(&m), 66);
+
+        zpl_b32 ok = true;
+        for (int i = 0; i < 100; ++i) {
+            zpl_i32 *value = unit_slots_get(&m, handles[i]);
+            if (i % 3 == 0) ok &= (value == NULL);
+            else ok &= (value != NULL && *value == i);
+        }
+        EQUALS(ok, true);
+
+        // NOTE: the oldest free slot is reused first and stale handles to it stay invalid
+        zpl_u64 reused = unit_slots_insert(&m, 1000);
+        EQUALS(zpl_slot_handle_index(reused), zpl_slot_handle_index(handles[0]));
+        NEQUALS(reused, handles[0]);
+        EQUALS(unit_slots_contains(&m, handles[0]), false);
+        EQUALS(*unit_slots_get(&m, reused), 1000);
+
+        for (zpl_isize i = 0; i < zpl_array_count(m.values); ++i) {
+            ok &= (*unit_slots_get(&m, unit_slots_handle_of(&m, i)) == m.values[i]);
+        }
+        EQUALS(ok, true);
+
+        unit_slots_clear(&m);
+        EQUALS(unit_slots_count(&m), 0);
+        EQUALS(unit_slots_contains(&m, reused), false);
+        EQUALS(zpl_slot_handle_index(unit_slots_insert(&m, 7)), zpl_slot_handle_index(handles[3]));
+
+        unit_slots_destroy(&m);
+    });
+
+    IT("should never hand out handle 0 when a generation wraps around", {
+        unit_slots m = {0};
+        unit_slots_init(&m, zpl_heap());
+
+        zpl_u64 h = unit_slots_insert(&m, 1);
+        EQUALS(zpl_slot_handle_index(h), 0);
+        m.slots[0].generation = 0xffffffff;
+        EQUALS(unit_slots_remove(&m, unit_slots_handle_of(&m, 0)), true);
+
+        h = unit_slots_insert(&m, 2);
+        NEQUALS(h, 0);
+        EQUALS(zpl_slot_handle_generation(h), 1);
+        EQUALS(unit_slots_get(&m, 0), NULL);
+
+        unit_slots_destroy(&m);
+    });
 });
@@ -17,6 +17,8 @@
 #include "cases/stream.h"
 #include "cases/print.h"
 #include "cases/adt.h"
+#include "cases/jobs.h"
+#include "cases/ring.h"
 
 int main() {
     zpl_heap_stats_init();
@@ -33,6 +35,8 @@ int main() {
     UNIT_MODULE(csv_parser);
     UNIT_MODULE(uri_parser);
     UNIT_MODULE(adt);
+    UNIT_MODULE(jobs);
+    UNIT_MODULE(ring);
 
     int32_t ret_code = UNIT_RUN();
     zpl_heap_stats_check();
@@ -254,8 +254,12 @@ License:
 #    include "header/essentials/collections/list.h"
 #    include "header/essentials/collections/ring.h"
 #    include "header/essentials/collections/hashtable.h"
+#    include "header/essentials/collections/flat_table.h"
+#    include "header/essentials/collections/str_table.h"
+#    include "header/essentials/collections/slot_map.h"
 #    if defined(ZPL_MODULE_CORE)
 #        include "header/core/memory_virtual.h"
+#        include "header/core/memory_temp.h"
 #        include "header/core/string.h"
 #        include "header/core/stringlib.h"
 #        include "header/core/file.h"
@@ -299,6 +303,8 @@ License:
 
     /* parsers */
 #    include "header/parsers/json.h"
+#    include "header/parsers/json_cursor.h"
+#    include "header/parsers/json_stream.h"
 #    include "header/parsers/csv.h"
 #    include "header/parsers/uri.h"
 #endif
@@ -331,9 +337,19 @@ License:
 #    include "header/threading/thread.h"
 #    include "header/threading/sync.h"
 #    include "header/threading/affinity.h"
+#    include "header/threading/conc_table.h"
+#    include "header/threading/conc_ring.h"
+#    include "header/threading/slab.h"
+#    include "header/threading/conc_pool.h"
+#    if defined(ZPL_MODULE_CORE)
+#        include "header/threading/alloc_profiler.h"
+#    endif
 
 #    if defined(ZPL_MODULE_JOBS)
 #        include "header/jobs.h"
+#        if defined(ZPL_MODULE_PARSER)
+#            include "header/parsers/json_lines.h"
+#        endif
 #    endif
 #else
 #    if !defined(zpl_thread_local)
@@ -421,8 +437,10 @@ License:
 #    include "source/essentials/debug.c"
 #    include "source/essentials/memory.c"
 #    include "source/essentials/memory_custom.c"
+#    include "source/essentials/collections/str_table.c"
 #    if defined(ZPL_MODULE_CORE)
 #        include "source/core/memory_virtual.c"
+#        include "source/core/memory_temp.c"
 #        include "source/core/string.c"
 #        include "source/core/stringlib.c"
 #        include "source/core/file.c"
@@ -469,6 +487,11 @@ License:
 #    include "source/threading/thread.c"
 #    include "source/threading/sync.c"
 #    include "source/threading/affinity.c"
+#    include "source/threading/slab.c"
+#    include "source/threading/conc_pool.c"
+#    if defined(ZPL_MODULE_CORE)
+#        include "source/threading/alloc_profiler.c"
+#    endif
 
 #    if defined(ZPL_MODULE_JOBS)
 #        include "source/jobs.c"
@@ -480,6 +503,11 @@ License:
 
     /* parsers */
 #    include "source/parsers/json.c"
+#    include "source/parsers/json_cursor.c"
+#    include "source/parsers/json_stream.c"
+#    if defined(ZPL_MODULE_JOBS)
+#        include "source/parsers/json_lines.c"
+#    endif
 #    include "source/parsers/csv.c"
 #    include "source/parsers/uri.c"
 #endif
@@ -538,6 +566,9 @@ License:
 // header/essentials/collections/buffer.h
 // header/essentials/collections/list.h
 // header/essentials/collections/hashtable.h
+// header/essentials/collections/flat_table.h
+// header/essentials/collections/str_table.h
+// header/essentials/collections/slot_map.h
 // header/essentials/collections/ring.h
 // header/essentials/collections/array.h
 // header/essentials/debug.h
@@ -546,18 +577,27 @@ License:
 // header/threading/mutex.h
 // header/threading/sync.h
 // header/threading/affinity.h
+// header/threading/conc_table.h
+// header/threading/conc_ring.h
+// header/threading/slab.h
+// header/threading/conc_pool.h
+// header/threading/alloc_profiler.h
 // header/threading/atomic.h
 // header/threading/thread.h
 // header/threading/sem.h
 // header/math.h
 // header/jobs.h
 // header/parsers/json.h
+// header/parsers/json_cursor.h
+// header/parsers/json_stream.h
+// header/parsers/json_lines.h
 // header/parsers/csv.h
 // header/parsers/uri.h
 // header/dll.h
 // header/adt.h
 // header/core/file_tar.h
 // header/core/memory_virtual.h
+// header/core/memory_temp.h
 // header/core/random.h
 // header/core/file_stream.h
 // header/core/string.h
@@ -578,10 +618,14 @@ License:
 // source/essentials/debug.c
 // source/essentials/memory_custom.c
 // source/essentials/memory.c
+// source/essentials/collections/str_table.c
 // source/dll.c
 // source/regex.c
 // source/threading/mutex.c
 // source/threading/affinity.c
+// source/threading/slab.c
+// source/threading/conc_pool.c
+// source/threading/alloc_profiler.c
 // source/threading/atomic.c
 // source/threading/sync.c
 // source/threading/thread.c
@@ -590,6 +634,9 @@ License:
 // source/parsers/csv.c
 // source/parsers/uri.c
 // source/parsers/json.c
+// source/parsers/json_cursor.c
+// source/parsers/json_stream.c
+// source/parsers/json_lines.c
 // source/jobs.c
 // source/core/file_stream.c
 // source/core/stringlib.c
@@ -597,6 +644,7 @@ License:
 // source/core/file_misc.c
 // source/core/file.c
 // source/core/memory_virtual.c
+// source/core/memory_temp.c
 // source/core/print.c
 // source/core/time.c
 // source/core/string.c